@@ -0,0 +1,87 @@
+/*
+ File: LargestDock.cpp
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Project
+#include <Dialogs/LargestDock.h>
+
+// Qt
+#include <QFileIconProvider>
+#include <QHeaderView>
+
+//-----------------------------------------------------------------------------
+LargestDock::LargestDock(QWidget* parent, Qt::WindowFlags flags)
+: QDockWidget(parent, flags)
+{
+  setupUi(this);
+
+  setObjectName("LargestDock");
+
+  m_table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+  m_table->horizontalHeader()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+
+  connect(m_searchButton, SIGNAL(clicked(bool)), this, SIGNAL(searchRequested()));
+  connect(m_table, SIGNAL(cellDoubleClicked(int, int)), this, SLOT(onCellDoubleClicked(int)));
+}
+
+//-----------------------------------------------------------------------------
+void LargestDock::setResults(const std::vector<ReportUtils::LargestItem> &items)
+{
+  auto toAppropiateUnits = [](const unsigned long long size)
+  {
+    double dSize = size;
+    double value = dSize/(1024.*1024.);
+    if(value < 1) return tr("%1 bytes").arg(size);
+    value = dSize/(1024.*1024.*1024.);
+    if(value < 1) return tr("%1 Mb").arg(QString::number(dSize/(1024.*1024.), 'f', 2));
+    value = dSize/(1024.*1024.*1024.*1024.);
+    if(value < 1) return tr("%1 Gb").arg(QString::number(dSize/(1024.*1024.*1024.), 'f', 2));
+    return tr("%1 Tb").arg(QString::number(value, 'f', 2));
+  };
+
+  QFileIconProvider iconProvider;
+  const auto folderIcon = iconProvider.icon(QFileIconProvider::Folder);
+  const auto fileIcon   = iconProvider.icon(QFileIconProvider::File);
+
+  m_table->setUpdatesEnabled(false);
+  m_table->clearContents();
+  m_table->setRowCount(items.size());
+
+  int row = 0;
+  for(auto &item: items)
+  {
+    auto nameItem = new QTableWidgetItem(item.type == Type::Directory ? folderIcon : fileIcon, item.name);
+    nameItem->setToolTip(item.name);
+
+    auto sizeItem = new QTableWidgetItem(toAppropiateUnits(item.size));
+    sizeItem->setTextAlignment(Qt::AlignRight|Qt::AlignVCenter);
+
+    m_table->setItem(row, 0, nameItem);
+    m_table->setItem(row, 1, sizeItem);
+    ++row;
+  }
+
+  m_table->setUpdatesEnabled(true);
+}
+
+//-----------------------------------------------------------------------------
+void LargestDock::onCellDoubleClicked(int row)
+{
+  auto item = m_table->item(row, 0);
+  if(item) emit itemActivated(item->text());
+}
@@ -0,0 +1,89 @@
+/*
+ File: LargestDock.h
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DIALOGS_LARGESTDOCK_H_
+#define DIALOGS_LARGESTDOCK_H_
+
+// Project
+#include <Utils/ReportUtils.h>
+#include "ui_LargestDock.h"
+
+// Qt
+#include <QDockWidget>
+
+/** \class LargestDock
+ * \brief Implements a dock panel that shows the largest files and directories of the tree.
+ *
+ */
+class LargestDock
+: public QDockWidget
+, private Ui::LargestDock
+{
+    Q_OBJECT
+  public:
+    /** \brief LargestDock class constructor.
+     * \param[in] parent Raw pointer of the QWidget parent of this one.
+     * \param[in] flags Qt window flags.
+     *
+     */
+    explicit LargestDock(QWidget *parent = nullptr, Qt::WindowFlags flags = Qt::WindowFlags());
+
+    /** \brief LargestDock class virtual destructor.
+     *
+     */
+    virtual ~LargestDock()
+    {}
+
+    /** \brief Returns the maximum number of items to find.
+     *
+     */
+    std::size_t count() const
+    { return m_count->value(); }
+
+    /** \brief Returns true to search only inside the selected items.
+     *
+     */
+    bool selectionOnly() const
+    { return m_selectionOnly->isChecked(); }
+
+    /** \brief Returns true to ignore the items hidden by the filter.
+     *
+     */
+    bool visibleOnly() const
+    { return m_visibleOnly->isChecked(); }
+
+    /** \brief Shows the given items.
+     * \param[in] items Largest items in descending order of size.
+     *
+     */
+    void setResults(const std::vector<ReportUtils::LargestItem> &items);
+
+  signals:
+    void searchRequested();
+    void itemActivated(const QString &key);
+
+  private slots:
+    /** \brief Emits the key of the item of the given row.
+     * \param[in] row Table row.
+     *
+     */
+    void onCellDoubleClicked(int row);
+};
+
+#endif // DIALOGS_LARGESTDOCK_H_
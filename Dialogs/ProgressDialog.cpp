@@ -21,7 +21,8 @@
 #include <Dialogs/ProgressDialog.h>
 
 // Qt
-#include <QTimer>
+#include <QHeaderView>
+#include <QTime>
 
 //-----------------------------------------------------------------------------
 ProgressDialog::ProgressDialog(AWSUtils::S3Thread* thread, QWidget* parent, Qt::WindowFlags flags)
@@ -30,24 +31,21 @@ ProgressDialog::ProgressDialog(AWSUtils::S3Thread* thread, QWidget* parent, Qt::
 {
   setupUi(this);
 
+  setAttribute(Qt::WA_DeleteOnClose);
   setWindowTitle(AWSUtils::operationTypeToText(thread->operation().type) + " operation");
 
+  m_transfers->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+  m_transfers->horizontalHeader()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+
   connect(m_thread, SIGNAL(globalProgress(int)), this, SLOT(setGlobalProgress(int)));
-  connect(m_thread, SIGNAL(progress(int)), this, SLOT(setProgress(int)));
+  connect(m_thread, SIGNAL(progressSampled(const TransferUtils::ProgressSample &)), this, SLOT(onProgressSampled(const TransferUtils::ProgressSample &)));
   connect(m_thread, SIGNAL(message(const QString &)), this, SLOT(setMessage(const QString &)));
   connect(m_thread, SIGNAL(finished()), this, SLOT(onCancelButtonPressed()));
+  connect(m_thread, SIGNAL(destroyed()), this, SLOT(close()));
 
   connect(m_cancelButton, SIGNAL(clicked(bool)), this, SLOT(onCancelButtonPressed()));
 }
 
-//-----------------------------------------------------------------------------
-void ProgressDialog::showEvent(QShowEvent* e)
-{
-  QDialog::showEvent(e);
-
-  m_thread->start();
-}
-
 //-----------------------------------------------------------------------------
 void ProgressDialog::setGlobalProgress(int progress)
 {
@@ -55,9 +53,56 @@ void ProgressDialog::setGlobalProgress(int progress)
 }
 
 //-----------------------------------------------------------------------------
-void ProgressDialog::setProgress(int progress)
+void ProgressDialog::onProgressSampled(const TransferUtils::ProgressSample &sample)
 {
-  m_operationProgress->setValue(progress);
+  auto toAppropiateUnits = [](const double size)
+  {
+    if(size < 1024.*1024.) return tr("%1 Kb").arg(QString::number(size/1024., 'f', 1));
+    if(size < 1024.*1024.*1024.) return tr("%1 Mb").arg(QString::number(size/(1024.*1024.), 'f', 2));
+    return tr("%1 Gb").arg(QString::number(size/(1024.*1024.*1024.), 'f', 2));
+  };
+
+  int value = 0;
+  if(sample.totalBytes > 0) value = (sample.bytes * 100) / sample.totalBytes;
+  else if(sample.totalObjects > 0) value = (sample.objects * 100) / sample.totalObjects;
+  m_operationProgress->setValue(value);
+
+  QString eta = tr("unknown");
+  if(sample.eta >= 0)
+  {
+    const auto days = sample.eta / 86400;
+    eta = QTime(0,0).addSecs(sample.eta % 86400).toString("hh:mm:ss");
+    if(days > 0) eta = tr("%1 days %2").arg(days).arg(eta);
+  }
+
+  m_rates->setText(tr("%1 of %2 - %3/s - %4 objects/s - %5 of %6 objects - ETA %7").arg(toAppropiateUnits(sample.bytes))
+                                                                                     .arg(toAppropiateUnits(sample.totalBytes))
+                                                                                     .arg(toAppropiateUnits(sample.bytesPerSecond))
+                                                                                     .arg(QString::number(sample.objectsPerSecond, 'f', 1))
+                                                                                     .arg(sample.objects)
+                                                                                     .arg(sample.totalObjects)
+                                                                                     .arg(eta));
+
+  const int count = sample.transfers.size();
+  if(m_transfers->rowCount() != count) m_transfers->setRowCount(count);
+
+  for(int row = 0; row < count; ++row)
+  {
+    const auto &transfer = sample.transfers.at(row);
+    const auto progress  = QString("%1%").arg(transfer.second);
+
+    auto item = m_transfers->item(row, 0);
+    if(!item)
+    {
+      m_transfers->setItem(row, 0, new QTableWidgetItem(transfer.first));
+      m_transfers->setItem(row, 1, new QTableWidgetItem(progress));
+    }
+    else
+    {
+      item->setText(transfer.first);
+      m_transfers->item(row, 1)->setText(progress);
+    }
+  }
 }
 
 //-----------------------------------------------------------------------------
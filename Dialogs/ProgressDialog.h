@@ -28,7 +28,7 @@
 #include <QDialog>
 
 /** \class ProgressDialog
- * \brief Implements a dialog to show the progress of the operations.
+ * \brief Implements a non-modal dialog to show the detailed progress of an operation.
  *
  */
 class ProgressDialog
@@ -37,7 +37,8 @@ class ProgressDialog
 {
     Q_OBJECT
   public:
-    /** \brief ProgressDialog class constructor.
+    /** \brief ProgressDialog class constructor. The dialog is deleted on close.
+     * \param[in] thread Operation thread, already running or queued.
      * \param[in] parent Raw pointer of the QWidget parent of this one.
      * \param[in] flags Qt window flags.
      *
@@ -50,9 +51,6 @@ class ProgressDialog
     virtual ~ProgressDialog()
     {}
 
-  protected:
-    void showEvent(QShowEvent *e) override;
-
   private slots:
     /** \brief Updates the global progress bar.
      * \param[in] progress Progress value in [0, 100]
@@ -60,11 +58,11 @@ class ProgressDialog
      */
     void setGlobalProgress(int progress);
 
-    /** \brief Updates the individual operation progress bar.
-     * \param[in] progress Progress value in [0, 100]
+    /** \brief Updates the operation progress, rates and transfers with the given sample.
+     * \param[in] sample Progress sample of the operation.
      *
      */
-    void setProgress(int progress);
+    void onProgressSampled(const TransferUtils::ProgressSample &sample);
 
     /** \brief Updates the operation message.
      * \param[in] message Text.
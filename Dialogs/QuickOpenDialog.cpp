@@ -0,0 +1,97 @@
+/*
+ File: QuickOpenDialog.cpp
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Project
+#include <Dialogs/QuickOpenDialog.h>
+#include <Utils/AWSUtils.h>
+
+// Qt
+#include <QElapsedTimer>
+#include <QFileIconProvider>
+
+// maximum number of results.
+const std::size_t RESULTS_COUNT = 100;
+
+// milliseconds without typing before searching.
+const int SEARCH_DELAY = 150;
+
+//-----------------------------------------------------------------------------
+QuickOpenDialog::QuickOpenDialog(ItemFactory *factory, QWidget* parent, Qt::WindowFlags flags)
+: QDialog(parent, flags)
+, m_factory{factory}
+{
+  setupUi(this);
+
+  m_timer.setSingleShot(true);
+  m_timer.setInterval(SEARCH_DELAY);
+
+  connect(m_query, SIGNAL(textChanged(const QString &)), &m_timer, SLOT(start()));
+  connect(m_query, SIGNAL(returnPressed()), this, SLOT(onReturnPressed()));
+  connect(&m_timer, SIGNAL(timeout()), this, SLOT(onSearchTimeout()));
+  connect(m_results, SIGNAL(itemActivated(QListWidgetItem *)), this, SLOT(accept()));
+}
+
+//-----------------------------------------------------------------------------
+QString QuickOpenDialog::selectedKey() const
+{
+  auto item = m_results->currentItem();
+  if(!item) return QString();
+
+  return item->text();
+}
+
+//-----------------------------------------------------------------------------
+void QuickOpenDialog::onSearchTimeout()
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  const auto items = m_factory->bestMatches(m_query->text(), RESULTS_COUNT);
+
+  QFileIconProvider iconProvider;
+  const auto folderIcon = iconProvider.icon(QFileIconProvider::Folder);
+  const auto fileIcon   = iconProvider.icon(QFileIconProvider::File);
+
+  m_results->setUpdatesEnabled(false);
+  m_results->clear();
+  for(auto item: items)
+  {
+    auto key = item->fullName();
+    if(isDirectory(item)) key += AWSUtils::DELIMITER;
+
+    m_results->addItem(new QListWidgetItem(isDirectory(item) ? folderIcon : fileIcon, key));
+  }
+  if(m_results->count() > 0) m_results->setCurrentRow(0);
+  m_results->setUpdatesEnabled(true);
+
+  m_status->setText(tr("%1 results in %2 ms.").arg(items.size()).arg(timer.elapsed()));
+}
+
+//-----------------------------------------------------------------------------
+void QuickOpenDialog::onReturnPressed()
+{
+  // the results of the last text may still be pending.
+  if(m_timer.isActive())
+  {
+    m_timer.stop();
+    onSearchTimeout();
+  }
+
+  if(m_results->currentItem()) accept();
+}
@@ -0,0 +1,76 @@
+/*
+ File: QuickOpenDialog.h
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DIALOGS_QUICKOPENDIALOG_H_
+#define DIALOGS_QUICKOPENDIALOG_H_
+
+// Project
+#include <Model/ItemsTree.h>
+#include "ui_QuickOpenDialog.h"
+
+// Qt
+#include <QDialog>
+#include <QTimer>
+
+/** \class QuickOpenDialog
+ * \brief Implements a dialog to find items by approximate name and select them in the tree.
+ *
+ */
+class QuickOpenDialog
+: public QDialog
+, private Ui::QuickOpenDialog
+{
+    Q_OBJECT
+  public:
+    /** \brief QuickOpenDialog class constructor.
+     * \param[in] factory Item factory.
+     * \param[in] parent Raw pointer of the QWidget parent of this one.
+     * \param[in] flags Window flags.
+     *
+     */
+    explicit QuickOpenDialog(ItemFactory *factory, QWidget *parent = nullptr, Qt::WindowFlags flags = Qt::WindowFlags());
+
+    /** \brief QuickOpenDialog class virtual destructor.
+     *
+     */
+    virtual ~QuickOpenDialog()
+    {}
+
+    /** \brief Returns the key of the selected item, empty if none.
+     *
+     */
+    QString selectedKey() const;
+
+  private slots:
+    /** \brief Shows the best matches of the query.
+     *
+     */
+    void onSearchTimeout();
+
+    /** \brief Selects the first result and accepts the dialog if there are results.
+     *
+     */
+    void onReturnPressed();
+
+  private:
+    ItemFactory *m_factory; /** item factory.                           */
+    QTimer       m_timer;   /** delays the search while the user types. */
+};
+
+#endif // DIALOGS_QUICKOPENDIALOG_H_
@@ -21,6 +21,7 @@
 #include <Dialogs/SettingsDialog.h>
 #include <Utils/Utils.h>
 #include <Utils/AWSUtils.h>
+#include <Utils/CacheUtils.h>
 
 // Qt
 #include <QFileDialog>
@@ -55,10 +56,27 @@ SettingsDialog::SettingsDialog(Utils::Configuration &config, QWidget* parent, Qt
   m_exportPaths->setChecked(config.Export_Full_Paths);
   m_downloadLineEdit->setText(QDir::toNativeSeparators(config.DownloadPath));
   m_disableDelete->setChecked(config.DisableDelete);
+  m_uploadLimit->setValue(config.Upload_Limit);
+  m_downloadLimit->setValue(config.Download_Limit);
+  m_scheduleLimits->setChecked(config.Schedule_Limits);
+  m_scheduleStart->setTime(config.Schedule_Start);
+  m_scheduleEnd->setTime(config.Schedule_End);
+  m_scheduleUploadLimit->setValue(config.Schedule_Upload_Limit);
+  m_scheduleDownloadLimit->setValue(config.Schedule_Download_Limit);
+  m_maxOperations->setValue(config.Max_Operations);
+  m_transferMemory->setValue(config.Transfer_Memory);
+  m_syncTransfers->setChecked(config.Sync_Transfers);
+  m_syncVerify->setChecked(config.Sync_Verify);
+  m_verifyChecksums->setChecked(config.Verify_Checksums);
+  m_cacheSize->setValue(config.Cache_Size);
+  onScheduleLimitsToggled(config.Schedule_Limits);
+  onSyncTransfersToggled(config.Sync_Transfers);
 
   connectSignals();
 
   checkCredentialsFile();
+
+  updateCacheStats();
 }
 
 //-----------------------------------------------------------------------------
@@ -86,6 +104,9 @@ void SettingsDialog::connectSignals()
   connect(m_dirButton, SIGNAL(clicked(bool)), this, SLOT(onFolderButtonClicked()));
   connect(m_downloadButton, SIGNAL(clicked(bool)), this, SLOT(onDownloadPathButtonClicked()));
   connect(m_permissionsButton, SIGNAL(clicked(bool)), this, SLOT(onPermissionsButtonClicked()));
+  connect(m_scheduleLimits, SIGNAL(toggled(bool)), this, SLOT(onScheduleLimitsToggled(bool)));
+  connect(m_syncTransfers, SIGNAL(toggled(bool)), this, SLOT(onSyncTransfersToggled(bool)));
+  connect(m_cacheClear, SIGNAL(clicked(bool)), this, SLOT(onCacheClearClicked()));
 }
 
 //-----------------------------------------------------------------------------
@@ -142,6 +163,19 @@ Utils::Configuration SettingsDialog::configuration() const
   config.Download_Full_Paths = m_downloadPaths->isChecked();
   config.DownloadPath = QDir::fromNativeSeparators(m_downloadLineEdit->text());
   config.DisableDelete = m_disableDelete->isChecked();
+  config.Upload_Limit = m_uploadLimit->value();
+  config.Download_Limit = m_downloadLimit->value();
+  config.Schedule_Limits = m_scheduleLimits->isChecked();
+  config.Schedule_Start = m_scheduleStart->time();
+  config.Schedule_End = m_scheduleEnd->time();
+  config.Schedule_Upload_Limit = m_scheduleUploadLimit->value();
+  config.Schedule_Download_Limit = m_scheduleDownloadLimit->value();
+  config.Max_Operations = m_maxOperations->value();
+  config.Transfer_Memory = m_transferMemory->value();
+  config.Sync_Transfers = m_syncTransfers->isChecked();
+  config.Sync_Verify = m_syncVerify->isChecked();
+  config.Verify_Checksums = m_verifyChecksums->isChecked();
+  config.Cache_Size = m_cacheSize->value();
 
   return config;
 }
@@ -233,8 +267,6 @@ void SettingsDialog::onPermissionsButtonClicked()
     return;
   }
 
-  Aws::SDKOptions options;
-  Aws::InitAPI(options);
   {
     auto credentials = Aws::Auth::AWSCredentials(AWSUtils::toAwsString(m_keyId->text()), AWSUtils::toAwsString(m_accessKey->text()));
 
@@ -271,5 +303,37 @@ void SettingsDialog::onPermissionsButtonClicked()
       m_permissionsLineEdit->setText(text);
     }
   }
-  Aws::ShutdownAPI(options);
+}
+
+//-----------------------------------------------------------------------------
+void SettingsDialog::onScheduleLimitsToggled(bool value)
+{
+  m_scheduleStart->setEnabled(value);
+  m_scheduleEnd->setEnabled(value);
+  m_scheduleUploadLimit->setEnabled(value);
+  m_scheduleDownloadLimit->setEnabled(value);
+}
+
+//-----------------------------------------------------------------------------
+void SettingsDialog::onSyncTransfersToggled(bool value)
+{
+  m_syncVerify->setEnabled(value);
+}
+
+//-----------------------------------------------------------------------------
+void SettingsDialog::onCacheClearClicked()
+{
+  CacheUtils::contentCache()->clear();
+
+  updateCacheStats();
+}
+
+//-----------------------------------------------------------------------------
+void SettingsDialog::updateCacheStats()
+{
+  auto cache = CacheUtils::contentCache();
+
+  const auto used = cache->size() / (1024. * 1024.);
+  m_cacheStats->setText(tr("%1 MB used, %2% hit rate").arg(QString::number(used, 'f', 1)).arg(QString::number(cache->hitRate() * 100, 'f', 1)));
+  m_cacheClear->setEnabled(cache->size() > 0 || cache->lookups() > 0);
 }
@@ -89,6 +89,23 @@ class SettingsDialog
      */
     void onPermissionsButtonClicked();
 
+    /** \brief Enables or disables the scheduled bandwidth limits widgets.
+     * \param[in] value True to enable, false otherwise.
+     *
+     */
+    void onScheduleLimitsToggled(bool value);
+
+    /** \brief Enables or disables the sync verification widget.
+     * \param[in] value True to enable, false otherwise.
+     *
+     */
+    void onSyncTransfersToggled(bool value);
+
+    /** \brief Removes all the objects of the download cache.
+     *
+     */
+    void onCacheClearClicked();
+
   private:
     /** \brief Helper method to connect Ui signals to slots.
      *
@@ -99,6 +116,11 @@ class SettingsDialog
      *
      */
     void checkCredentialsFile();
+
+    /** \brief Shows the usage and the hit rate of the download cache.
+     *
+     */
+    void updateCacheStats();
 };
 
 #endif // SETTINGSDIALOG_H_
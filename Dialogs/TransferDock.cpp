@@ -0,0 +1,227 @@
+/*
+ File: TransferDock.cpp
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Project
+#include <Dialogs/TransferDock.h>
+#include <Dialogs/ProgressDialog.h>
+
+// Qt
+#include <QProgressBar>
+#include <QHeaderView>
+
+//-----------------------------------------------------------------------------
+TransferDock::TransferDock(AWSUtils::TransferQueue* queue, QWidget* parent, Qt::WindowFlags flags)
+: QDockWidget(parent, flags)
+, m_queue{queue}
+{
+  setupUi(this);
+
+  setObjectName("TransferDock");
+
+  m_table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+  m_table->horizontalHeader()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+  m_table->horizontalHeader()->setSectionResizeMode(2, QHeaderView::ResizeToContents);
+
+  connect(m_queue, SIGNAL(jobAdded(AWSUtils::S3Thread *)), this, SLOT(onJobAdded(AWSUtils::S3Thread *)));
+  connect(m_queue, SIGNAL(jobStarted(AWSUtils::S3Thread *)), this, SLOT(onJobStarted(AWSUtils::S3Thread *)));
+  connect(m_queue, SIGNAL(jobFinished(AWSUtils::S3Thread *)), this, SLOT(onJobFinished(AWSUtils::S3Thread *)));
+  connect(m_queue, SIGNAL(jobPriorityChanged(AWSUtils::S3Thread *)), this, SLOT(onJobPriorityChanged(AWSUtils::S3Thread *)));
+
+  connect(m_detailsButton,  SIGNAL(clicked(bool)), this, SLOT(onDetailsButtonClicked()));
+  connect(m_priorityButton, SIGNAL(clicked(bool)), this, SLOT(onPriorityButtonClicked()));
+  connect(m_cancelButton,   SIGNAL(clicked(bool)), this, SLOT(onCancelButtonClicked()));
+  connect(m_clearButton,    SIGNAL(clicked(bool)), this, SLOT(onClearButtonClicked()));
+  connect(m_table, SIGNAL(itemSelectionChanged()), this, SLOT(onSelectionChanged()));
+  connect(m_table, SIGNAL(cellDoubleClicked(int, int)), this, SLOT(onDetailsButtonClicked()));
+}
+
+//-----------------------------------------------------------------------------
+void TransferDock::onJobAdded(AWSUtils::S3Thread* job)
+{
+  const auto row = m_table->rowCount();
+  m_table->insertRow(row);
+
+  auto operationItem = new QTableWidgetItem(AWSUtils::operationTypeToText(job->operation().type));
+  operationItem->setData(Qt::UserRole, QVariant::fromValue(reinterpret_cast<quintptr>(job)));
+
+  m_table->setItem(row, 0, operationItem);
+  m_table->setItem(row, 1, new QTableWidgetItem(QString::number(job->operation().keys.size())));
+  m_table->setItem(row, 2, new QTableWidgetItem(AWSUtils::priorityToText(m_queue->priority(job))));
+  m_table->setItem(row, 4, new QTableWidgetItem(tr("Pending")));
+
+  auto progressBar = new QProgressBar();
+  progressBar->setRange(0, 100);
+  progressBar->setValue(0);
+  progressBar->setAlignment(Qt::AlignCenter);
+  m_table->setCellWidget(row, 3, progressBar);
+
+  connect(job, SIGNAL(globalProgress(int)), this, SLOT(onProgress(int)));
+  connect(job, SIGNAL(message(const QString &)), this, SLOT(onMessage(const QString &)));
+
+  onSelectionChanged();
+}
+
+//-----------------------------------------------------------------------------
+void TransferDock::onJobStarted(AWSUtils::S3Thread* job)
+{
+  const auto row = rowOf(job);
+  if(row != -1) m_table->item(row, 4)->setText(tr("Running"));
+
+  onSelectionChanged();
+}
+
+//-----------------------------------------------------------------------------
+void TransferDock::onJobFinished(AWSUtils::S3Thread* job)
+{
+  const auto row = rowOf(job);
+  if(row != -1)
+  {
+    QString status;
+    if(job->isAborted())
+    {
+      status = tr("Cancelled");
+    }
+    else
+    {
+      status = job->errors().isEmpty() ? tr("Finished") : tr("Finished with %1 errors").arg(job->errors().size());
+
+      auto progressBar = qobject_cast<QProgressBar *>(m_table->cellWidget(row, 3));
+      if(progressBar) progressBar->setValue(100);
+    }
+
+    m_table->item(row, 0)->setData(Qt::UserRole, QVariant::fromValue(quintptr(0)));
+    m_table->item(row, 4)->setText(status);
+  }
+
+  onSelectionChanged();
+}
+
+//-----------------------------------------------------------------------------
+void TransferDock::onJobPriorityChanged(AWSUtils::S3Thread* job)
+{
+  const auto row = rowOf(job);
+  if(row != -1) m_table->item(row, 2)->setText(AWSUtils::priorityToText(m_queue->priority(job)));
+}
+
+//-----------------------------------------------------------------------------
+void TransferDock::onProgress(int value)
+{
+  const auto row = rowOf(qobject_cast<AWSUtils::S3Thread *>(sender()));
+  if(row != -1)
+  {
+    auto progressBar = qobject_cast<QProgressBar *>(m_table->cellWidget(row, 3));
+    if(progressBar) progressBar->setValue(value);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void TransferDock::onMessage(const QString& message)
+{
+  const auto row = rowOf(qobject_cast<AWSUtils::S3Thread *>(sender()));
+  if(row != -1) m_table->item(row, 4)->setText(message);
+}
+
+//-----------------------------------------------------------------------------
+void TransferDock::onDetailsButtonClicked()
+{
+  auto job = selectedJob();
+  if(job && m_queue->isRunning(job))
+  {
+    auto dialog = new ProgressDialog(job, this);
+    dialog->show();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void TransferDock::onPriorityButtonClicked()
+{
+  auto job = selectedJob();
+  if(job && !m_queue->isRunning(job))
+  {
+    auto priority = m_queue->priority(job);
+    if(priority != AWSUtils::Priority::high)
+    {
+      m_queue->setPriority(job, static_cast<AWSUtils::Priority>(static_cast<char>(priority) + 1));
+    }
+  }
+
+  onSelectionChanged();
+}
+
+//-----------------------------------------------------------------------------
+void TransferDock::onCancelButtonClicked()
+{
+  auto job = selectedJob();
+  if(job)
+  {
+    const auto row = rowOf(job);
+    m_table->item(row, 4)->setText(tr("Cancelling..."));
+
+    m_queue->cancel(job);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void TransferDock::onClearButtonClicked()
+{
+  for(int row = m_table->rowCount() - 1; row >= 0; --row)
+  {
+    if(m_table->item(row, 0)->data(Qt::UserRole).value<quintptr>() == 0) m_table->removeRow(row);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void TransferDock::onSelectionChanged()
+{
+  auto job = selectedJob();
+  const bool running = job && m_queue->isRunning(job);
+
+  m_detailsButton->setEnabled(running);
+  m_cancelButton->setEnabled(job != nullptr);
+  m_priorityButton->setEnabled(job && !running && m_queue->priority(job) != AWSUtils::Priority::high);
+}
+
+//-----------------------------------------------------------------------------
+int TransferDock::rowOf(AWSUtils::S3Thread* job) const
+{
+  if(job)
+  {
+    const auto value = reinterpret_cast<quintptr>(job);
+
+    for(int row = 0; row < m_table->rowCount(); ++row)
+    {
+      if(m_table->item(row, 0)->data(Qt::UserRole).value<quintptr>() == value) return row;
+    }
+  }
+
+  return -1;
+}
+
+//-----------------------------------------------------------------------------
+AWSUtils::S3Thread* TransferDock::selectedJob() const
+{
+  auto selected = m_table->selectedItems();
+  if(!selected.isEmpty())
+  {
+    const auto row = selected.first()->row();
+    return reinterpret_cast<AWSUtils::S3Thread *>(m_table->item(row, 0)->data(Qt::UserRole).value<quintptr>());
+  }
+
+  return nullptr;
+}
@@ -0,0 +1,131 @@
+/*
+ File: TransferDock.h
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DIALOGS_TRANSFERDOCK_H_
+#define DIALOGS_TRANSFERDOCK_H_
+
+// Project
+#include <Utils/TransferQueue.h>
+#include "ui_TransferDock.h"
+
+// Qt
+#include <QDockWidget>
+
+/** \class TransferDock
+ * \brief Implements a dock panel that shows the operations of the transfer queue.
+ *
+ */
+class TransferDock
+: public QDockWidget
+, private Ui::TransferDock
+{
+    Q_OBJECT
+  public:
+    /** \brief TransferDock class constructor.
+     * \param[in] queue Transfer queue whose operations will be shown.
+     * \param[in] parent Raw pointer of the QWidget parent of this one.
+     * \param[in] flags Qt window flags.
+     *
+     */
+    explicit TransferDock(AWSUtils::TransferQueue *queue, QWidget *parent = nullptr, Qt::WindowFlags flags = Qt::WindowFlags());
+
+    /** \brief TransferDock class virtual destructor.
+     *
+     */
+    virtual ~TransferDock()
+    {}
+
+  private slots:
+    /** \brief Adds a row for the given operation.
+     * \param[in] job Operation thread.
+     *
+     */
+    void onJobAdded(AWSUtils::S3Thread *job);
+
+    /** \brief Updates the row of the given operation when it starts.
+     * \param[in] job Operation thread.
+     *
+     */
+    void onJobStarted(AWSUtils::S3Thread *job);
+
+    /** \brief Updates the row of the given operation when it finishes.
+     * \param[in] job Operation thread.
+     *
+     */
+    void onJobFinished(AWSUtils::S3Thread *job);
+
+    /** \brief Updates the priority of the row of the given operation.
+     * \param[in] job Operation thread.
+     *
+     */
+    void onJobPriorityChanged(AWSUtils::S3Thread *job);
+
+    /** \brief Updates the progress of the operation that emitted the signal.
+     * \param[in] value Progress value in [0, 100].
+     *
+     */
+    void onProgress(int value);
+
+    /** \brief Updates the status of the operation that emitted the signal.
+     * \param[in] message Status message.
+     *
+     */
+    void onMessage(const QString &message);
+
+    /** \brief Shows the progress dialog of the selected operation.
+     *
+     */
+    void onDetailsButtonClicked();
+
+    /** \brief Raises the priority of the selected operation.
+     *
+     */
+    void onPriorityButtonClicked();
+
+    /** \brief Cancels the selected operation.
+     *
+     */
+    void onCancelButtonClicked();
+
+    /** \brief Removes the rows of the finished operations.
+     *
+     */
+    void onClearButtonClicked();
+
+    /** \brief Updates the buttons state when the selection changes.
+     *
+     */
+    void onSelectionChanged();
+
+  private:
+    /** \brief Returns the row of the given operation or -1 if not found.
+     * \param[in] job Operation thread.
+     *
+     */
+    int rowOf(AWSUtils::S3Thread *job) const;
+
+    /** \brief Returns the operation of the selected row or nullptr if none or finished.
+     *
+     */
+    AWSUtils::S3Thread *selectedJob() const;
+
+    AWSUtils::TransferQueue *m_queue; /** transfer queue. */
+};
+
+#endif // DIALOGS_TRANSFERDOCK_H_
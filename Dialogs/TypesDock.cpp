@@ -0,0 +1,105 @@
+/*
+ File: TypesDock.cpp
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Project
+#include <Dialogs/TypesDock.h>
+
+// C++
+#include <algorithm>
+
+// Qt
+#include <QHeaderView>
+
+//-----------------------------------------------------------------------------
+TypesDock::TypesDock(const ItemFactory *factory, QWidget* parent, Qt::WindowFlags flags)
+: QDockWidget(parent, flags)
+, m_factory{factory}
+{
+  setupUi(this);
+
+  setObjectName("TypesDock");
+
+  m_table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+  m_table->horizontalHeader()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+  m_table->horizontalHeader()->setSectionResizeMode(2, QHeaderView::ResizeToContents);
+
+  connect(m_table, SIGNAL(cellDoubleClicked(int, int)), this, SLOT(onCellDoubleClicked(int)));
+}
+
+//-----------------------------------------------------------------------------
+void TypesDock::showEvent(QShowEvent *e)
+{
+  QDockWidget::showEvent(e);
+
+  refresh();
+}
+
+//-----------------------------------------------------------------------------
+void TypesDock::refresh()
+{
+  if(!isVisible()) return;
+
+  auto toAppropiateUnits = [](const unsigned long long size)
+  {
+    double dSize = size;
+    double value = dSize/(1024.*1024.);
+    if(value < 1) return tr("%1 bytes").arg(size);
+    value = dSize/(1024.*1024.*1024.);
+    if(value < 1) return tr("%1 Mb").arg(QString::number(dSize/(1024.*1024.), 'f', 2));
+    value = dSize/(1024.*1024.*1024.*1024.);
+    if(value < 1) return tr("%1 Gb").arg(QString::number(dSize/(1024.*1024.*1024.), 'f', 2));
+    return tr("%1 Tb").arg(QString::number(value, 'f', 2));
+  };
+
+  // the aggregates are kept by the factory, only the rows are built here.
+  auto statistics = m_factory->extensionStatistics();
+  auto bySize = [](const ItemFactory::ExtensionStatistics &lhs, const ItemFactory::ExtensionStatistics &rhs) { return lhs.bytes > rhs.bytes; };
+  std::sort(statistics.begin(), statistics.end(), bySize);
+
+  m_table->setUpdatesEnabled(false);
+  m_table->clearContents();
+  m_table->setRowCount(statistics.size());
+
+  int row = 0;
+  for(auto &entry: statistics)
+  {
+    auto extensionItem = new QTableWidgetItem(entry.extension.isEmpty() ? tr("(none)") : entry.extension);
+    extensionItem->setData(Qt::UserRole, entry.extension);
+
+    auto filesItem = new QTableWidgetItem(QString::number(entry.files));
+    filesItem->setTextAlignment(Qt::AlignRight|Qt::AlignVCenter);
+
+    auto sizeItem = new QTableWidgetItem(toAppropiateUnits(entry.bytes));
+    sizeItem->setTextAlignment(Qt::AlignRight|Qt::AlignVCenter);
+
+    m_table->setItem(row, 0, extensionItem);
+    m_table->setItem(row, 1, filesItem);
+    m_table->setItem(row, 2, sizeItem);
+    ++row;
+  }
+
+  m_table->setUpdatesEnabled(true);
+}
+
+//-----------------------------------------------------------------------------
+void TypesDock::onCellDoubleClicked(int row)
+{
+  auto item = m_table->item(row, 0);
+  if(item && !item->data(Qt::UserRole).toString().isEmpty()) emit typeActivated(item->data(Qt::UserRole).toString());
+}
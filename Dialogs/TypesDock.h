@@ -0,0 +1,76 @@
+/*
+ File: TypesDock.h
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DIALOGS_TYPESDOCK_H_
+#define DIALOGS_TYPESDOCK_H_
+
+// Project
+#include <Model/ItemsTree.h>
+#include "ui_TypesDock.h"
+
+// Qt
+#include <QDockWidget>
+
+/** \class TypesDock
+ * \brief Implements a dock panel that shows the number and size of the files of each extension.
+ *
+ */
+class TypesDock
+: public QDockWidget
+, private Ui::TypesDock
+{
+    Q_OBJECT
+  public:
+    /** \brief TypesDock class constructor.
+     * \param[in] factory Item factory.
+     * \param[in] parent Raw pointer of the QWidget parent of this one.
+     * \param[in] flags Qt window flags.
+     *
+     */
+    explicit TypesDock(const ItemFactory *factory, QWidget *parent = nullptr, Qt::WindowFlags flags = Qt::WindowFlags());
+
+    /** \brief TypesDock class virtual destructor.
+     *
+     */
+    virtual ~TypesDock()
+    {}
+
+    /** \brief Updates the statistics if the panel is visible.
+     *
+     */
+    void refresh();
+
+  signals:
+    void typeActivated(const QString &extension);
+
+  protected:
+    virtual void showEvent(QShowEvent *e) override;
+
+  private slots:
+    /** \brief Emits the extension of the given row.
+     * \param[in] row Table row.
+     *
+     */
+    void onCellDoubleClicked(int row);
+
+  private:
+    const ItemFactory *m_factory; /** item factory. */
+};
+
+#endif // DIALOGS_TYPESDOCK_H_
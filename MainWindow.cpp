@@ -21,12 +21,19 @@
 #include <MainWindow.h>
 #include <Utils/ListExportUtils.h>
 #include <Dialogs/SettingsDialog.h>
-#include <Dialogs/ProgressDialog.h>
 #include <Dialogs/AboutDialog.h>
+#include <Dialogs/LargestDock.h>
+#include <Dialogs/QuickOpenDialog.h>
+#include <Utils/TransferUtils.h>
+#include <Utils/CacheUtils.h>
+#include <Utils/ReportUtils.h>
+#include <Utils/PatternUtils.h>
 
 // C++
 #include <fstream>
 #include <cassert>
+#include <functional>
+#include <unordered_set>
 
 // Qt
 #include <QSettings>
@@ -37,6 +44,8 @@
 #include <QTimer>
 #include <QMenu>
 #include <QInputDialog>
+#include <QHBoxLayout>
+#include <QPushButton>
 
 // AWS
 #include <aws/core/Aws.h>
@@ -44,24 +53,58 @@
 const QString STATE    = "State";
 const QString GEOMETRY = "Geometry";
 
+// size units of the size filter.
+const unsigned long long MEGABYTE = 1024ULL * 1024ULL;
+const unsigned long long GIGABYTE = 1024ULL * MEGABYTE;
+
+// index of the custom range in the size filter.
+const int CUSTOM_RANGE = 7;
+
 //-----------------------------------------------------------------------------
 MainWindow::MainWindow(Utils::Configuration &configuration, ItemFactory* factory, QWidget* parent, Qt::WindowFlags flags)
 : QMainWindow(parent, flags)
 , m_factory{factory}
 , m_configuration(configuration)
+, m_customRange{0, std::numeric_limits<unsigned long long>::max()}
 {
   setupUi(this);
 
-  restoreConfiguration();
-
   configureTreeView();
 
+  m_queue = new AWSUtils::TransferQueue(m_configuration.Max_Operations, this);
+  m_transferDock = new TransferDock(m_queue, this);
+  addDockWidget(Qt::BottomDockWidgetArea, m_transferDock);
+  toolBar->insertAction(actionAbout, m_transferDock->toggleViewAction());
+
+  m_largestDock = new LargestDock(this);
+  addDockWidget(Qt::BottomDockWidgetArea, m_largestDock);
+  tabifyDockWidget(m_transferDock, m_largestDock);
+  m_largestDock->hide();
+  toolBar->insertAction(actionAbout, m_largestDock->toggleViewAction());
+
+  m_typesDock = new TypesDock(m_factory, this);
+  addDockWidget(Qt::BottomDockWidgetArea, m_typesDock);
+  tabifyDockWidget(m_largestDock, m_typesDock);
+  m_typesDock->hide();
+  toolBar->insertAction(actionAbout, m_typesDock->toggleViewAction());
+
+  restoreConfiguration();
+
   connectSignals();
 
   m_statusLabel = new QLabel();
   statusBar()->addWidget(m_statusLabel);
 
   updateStatusLabel();
+
+  applyBandwidthLimits();
+  TransferUtils::bufferPool()->setBudget(m_configuration.Transfer_Memory * 1024ULL * 1024ULL);
+  CacheUtils::contentCache()->setLimit(m_configuration.Cache_Size * 1024ULL * 1024ULL);
+
+  // limits can change during the day if there is a schedule.
+  m_limitsTimer.setInterval(60*1000);
+  connect(&m_limitsTimer, SIGNAL(timeout()), this, SLOT(applyBandwidthLimits()));
+  m_limitsTimer.start();
 }
 
 //-----------------------------------------------------------------------------
@@ -103,54 +146,223 @@ void MainWindow::saveConfiguration()
 void MainWindow::connectSignals()
 {
   connect(actionSettings, SIGNAL(triggered(bool)), this, SLOT(onSettingsButtonTriggered()));
+  connect(actionQuickOpen, SIGNAL(triggered(bool)), this, SLOT(onQuickOpenActionTriggered()));
   connect(actionAbout, SIGNAL(triggered(bool)), this, SLOT(onAboutButtonTriggered()));
   connect(m_searchLine, SIGNAL(textChanged(const QString &)), this, SLOT(onSearchTextChanged(const QString &)));
   connect(m_searchLine, SIGNAL(returnPressed()), this, SLOT(onSearchButtonClicked()));
   connect(m_searchButton, SIGNAL(clicked(bool)), this, SLOT(onSearchButtonClicked()));
+  connect(m_searchMode, SIGNAL(activated(int)), this, SLOT(onSearchButtonClicked()));
+  connect(m_sizeFilter, SIGNAL(activated(int)), this, SLOT(onSizeFilterActivated(int)));
+  connect(m_typeLine, SIGNAL(textChanged(const QString &)), this, SLOT(onSearchTextChanged(const QString &)));
+  connect(m_typeLine, SIGNAL(returnPressed()), this, SLOT(onSearchButtonClicked()));
+  connect(m_queue, SIGNAL(jobFinished(AWSUtils::S3Thread *)), this, SLOT(onOperationFinished(AWSUtils::S3Thread *)));
+  connect(m_largestDock, SIGNAL(searchRequested()), this, SLOT(onLargestSearchRequested()));
+  connect(m_largestDock, SIGNAL(itemActivated(const QString &)), this, SLOT(onItemActivated(const QString &)));
+  connect(m_typesDock, SIGNAL(typeActivated(const QString &)), this, SLOT(onTypeActivated(const QString &)));
 }
 
 //-----------------------------------------------------------------------------
 void MainWindow::onExportActionTriggered()
 {
-  auto selected = getSelectedFileList(m_configuration.Export_Full_Paths);
+  const auto items = getSelectedItems();
 
-  if(selected.empty())
+  if(items.empty())
   {
     QMessageBox::information(this, tr("Export list"), tr("No objects selected!"));
     return;
   }
 
   auto dateTimeString = QDateTime::currentDateTime().toString("dd.mm.yyyy-hh.mm");
-  auto suggestion = tr("SuperDuck selected objects %1.xls").arg(dateTimeString);
+  auto suggestion = tr("SuperDuck selected objects %1.xlsx").arg(dateTimeString);
   auto path = QStandardPaths::standardLocations(QStandardPaths::DocumentsLocation).first();
-  auto filename = QFileDialog::getSaveFileName(this, tr("Save file list"), QDir(m_configuration.DownloadPath).absoluteFilePath(suggestion), tr("Excel files (*.xls);;CSV files (*.csv)"));
+  auto filename = QFileDialog::getSaveFileName(this, tr("Save file list"), QDir(m_configuration.DownloadPath).absoluteFilePath(suggestion), tr("Excel files (*.xlsx);;Excel 97-2003 files (*.xls);;CSV files (*.csv)"));
 
-  bool success = false;
-  if (!filename.isEmpty())
+  if (filename.isEmpty()) return;
+
+  ListExportUtils::Format format;
+  if (filename.endsWith(".csv", Qt::CaseInsensitive))
   {
-    if (filename.endsWith(".csv", Qt::CaseInsensitive))
-    {
-      success = ListExportUtils::saveToCSV(filename.toStdString(), selected);
-    }
-    else
-    {
-      if (filename.endsWith(".xls", Qt::CaseInsensitive))
-      {
-        success = ListExportUtils::saveToXLS(filename.toStdString(), selected);
-      }
-      else
-      {
-        QMessageBox::information(this, tr("Export list"), tr("Unknown format '%1'").arg(filename.split('.').last()));
-        return;
-      }
-    }
+    format = ListExportUtils::Format::csv;
+  }
+  else if (filename.endsWith(".xlsx", Qt::CaseInsensitive))
+  {
+    format = ListExportUtils::Format::xlsx;
+  }
+  else if (filename.endsWith(".xls", Qt::CaseInsensitive))
+  {
+    format = ListExportUtils::Format::xls;
+  }
+  else
+  {
+    QMessageBox::information(this, tr("Export list"), tr("Unknown format '%1'").arg(filename.split('.').last()));
+    return;
+  }
 
-    if (!success)
-    {
-      auto message = tr("File '%1' couldn't be saved.").arg(filename);
-      QMessageBox::critical(this, tr("Export list"), message);
-    }
+  // the export works on a copy of the handles and sizes of the selection, the tree can be modified while it runs.
+  auto snapshot = ListExportUtils::createSnapshot(items, m_configuration.Export_Full_Paths);
+  auto task = [filename, format, snapshot](ListExportUtils::Progress &progress) { return ListExportUtils::saveFileList(filename, format, *snapshot, progress); };
+  startExport(new ListExportUtils::ExportThread(filename, task, snapshot->files, this));
+}
+
+//-----------------------------------------------------------------------------
+void MainWindow::onSummaryActionTriggered()
+{
+  auto items = getSelectedItems();
+  items.erase(std::remove_if(items.begin(), items.end(), [](const Item *i) { return !isDirectory(i); }), items.end());
+  if(items.empty()) items.push_back(m_factory->items().at(0));
+
+  bool accepted = false;
+  const auto depth = QInputDialog::getInt(this, tr("Directory summary"), tr("Depth of the reported directories:"), 2, 0, 1000, 1, &accepted);
+  if(!accepted) return;
+
+  auto dateTimeString = QDateTime::currentDateTime().toString("dd.mm.yyyy-hh.mm");
+  auto suggestion = tr("SuperDuck directory summary %1.xlsx").arg(dateTimeString);
+  auto filename = QFileDialog::getSaveFileName(this, tr("Save directory summary"), QDir(m_configuration.DownloadPath).absoluteFilePath(suggestion), tr("Excel files (*.xlsx);;Excel 97-2003 files (*.xls);;CSV files (*.csv)"));
+
+  if (filename.isEmpty()) return;
+
+  ListExportUtils::Format format;
+  if (filename.endsWith(".csv", Qt::CaseInsensitive))
+  {
+    format = ListExportUtils::Format::csv;
+  }
+  else if (filename.endsWith(".xlsx", Qt::CaseInsensitive))
+  {
+    format = ListExportUtils::Format::xlsx;
+  }
+  else if (filename.endsWith(".xls", Qt::CaseInsensitive))
+  {
+    format = ListExportUtils::Format::xls;
+  }
+  else
+  {
+    QMessageBox::information(this, tr("Directory summary"), tr("Unknown format '%1'").arg(filename.split('.').last()));
+    return;
+  }
+
+  // the summary is reduced from a snapshot in the background, each node is a row of progress.
+  auto snapshot = ListExportUtils::createSnapshot(items, true);
+  auto task = [filename, format, snapshot, depth](ListExportUtils::Progress &progress)
+  {
+    const auto summary = ReportUtils::summarize(*snapshot, depth, progress);
+    return summary && ReportUtils::saveSummary(filename, format, *summary, progress);
+  };
+  startExport(new ListExportUtils::ExportThread(filename, task, snapshot->nodes.size(), this));
+}
+
+//-----------------------------------------------------------------------------
+void MainWindow::onLargestSearchRequested()
+{
+  Items items;
+  if(m_largestDock->selectionOnly()) items = getSelectedItems();
+  if(items.empty()) items.push_back(m_factory->items().at(0));
+
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+  m_largestDock->setResults(ReportUtils::largestItems(items, m_largestDock->count(), m_largestDock->visibleOnly()));
+  QApplication::restoreOverrideCursor();
+}
+
+//-----------------------------------------------------------------------------
+void MainWindow::onItemActivated(const QString &key)
+{
+  auto item = m_factory->itemFromKey(key);
+  if(!item)
+  {
+    QMessageBox::information(this, tr("SuperDuck"), tr("'%1' is no longer in the bucket.").arg(key));
+    return;
+  }
+
+  auto index = m_model->indexOf(item);
+  if(!index.isValid())
+  {
+    QMessageBox::information(this, tr("SuperDuck"), tr("'%1' is hidden by the filter.").arg(key));
+    return;
+  }
+
+  m_treeView->selectionModel()->select(index, QItemSelectionModel::SelectionFlag::ClearAndSelect|QItemSelectionModel::SelectionFlag::Rows);
+  m_treeView->scrollTo(index, QAbstractItemView::ScrollHint::EnsureVisible);
+}
+
+//-----------------------------------------------------------------------------
+void MainWindow::onQuickOpenActionTriggered()
+{
+  QuickOpenDialog dialog(m_factory, this);
+  if(dialog.exec() != QDialog::Accepted) return;
+
+  const auto key = dialog.selectedKey();
+  if(!key.isEmpty()) onItemActivated(key);
+}
+
+//-----------------------------------------------------------------------------
+void MainWindow::startExport(ListExportUtils::ExportThread *job)
+{
+  const auto filename = job->filename();
+
+  ExportWidgets widgets;
+  widgets.widget   = new QWidget();
+  widgets.label    = new QLabel(tr("Exporting '%1'").arg(QFileInfo(filename).fileName()));
+  widgets.progress = new QProgressBar();
+  widgets.progress->setRange(0, 100);
+  widgets.progress->setMaximumWidth(150);
+
+  auto cancel = new QPushButton(tr("Cancel"));
+  cancel->setToolTip(tr("Cancels the export."));
+
+  auto layout = new QHBoxLayout(widgets.widget);
+  layout->setContentsMargins(0, 0, 0, 0);
+  layout->addWidget(widgets.label);
+  layout->addWidget(widgets.progress);
+  layout->addWidget(cancel);
+  statusBar()->addPermanentWidget(widgets.widget);
+
+  m_exports.insert(job, widgets);
+
+  connect(cancel, SIGNAL(clicked(bool)), job, SLOT(abort()));
+  connect(job, SIGNAL(progress(unsigned long long, unsigned long long, double)), this, SLOT(onExportProgress(unsigned long long, unsigned long long, double)));
+  connect(job, SIGNAL(finished()), this, SLOT(onExportFinished()));
+
+  job->start();
+}
+
+//-----------------------------------------------------------------------------
+void MainWindow::onExportProgress(unsigned long long rows, unsigned long long total, double rowsPerSecond)
+{
+  auto job = qobject_cast<ListExportUtils::ExportThread *>(sender());
+  if(!job || !m_exports.contains(job)) return;
+
+  const auto &widgets = m_exports[job];
+  widgets.progress->setValue(total == 0 ? 100 : (rows * 100) / total);
+  widgets.label->setText(tr("Exporting '%1': %2 of %3 rows, %4 rows/s").arg(QFileInfo(job->filename()).fileName())
+                         .arg(rows).arg(total).arg(static_cast<unsigned long long>(rowsPerSecond)));
+}
+
+//-----------------------------------------------------------------------------
+void MainWindow::onExportFinished()
+{
+  auto job = qobject_cast<ListExportUtils::ExportThread *>(sender());
+  if(!job) return;
+
+  if(m_exports.contains(job))
+  {
+    auto widgets = m_exports.take(job);
+    statusBar()->removeWidget(widgets.widget);
+    widgets.widget->deleteLater();
+  }
+
+  if(job->isAborted())
+  {
+    statusBar()->showMessage(tr("Export of '%1' cancelled.").arg(QDir::toNativeSeparators(job->filename())), 5000);
+  }
+  else if(!job->succeeded())
+  {
+    QMessageBox::critical(this, tr("Export list"), tr("File '%1' couldn't be saved.").arg(job->filename()));
+  }
+  else
+  {
+    statusBar()->showMessage(tr("Exported %1 rows to '%2'.").arg(job->total()).arg(QDir::toNativeSeparators(job->filename())), 5000);
   }
+
+  job->deleteLater();
 }
 
 //-----------------------------------------------------------------------------
@@ -172,15 +384,14 @@ void MainWindow::onDownloadActionTriggered()
                                              AWSUtils::toAwsString(Utils::rot13(m_configuration.AWS_Secret_access_key)));
   op.keys = std::move(selected);
   op.parameters = Aws::String(m_configuration.DownloadPath.toStdString().c_str(), m_configuration.DownloadPath.length());
+  op.fullPaths  = m_configuration.Download_Full_Paths;
+  op.sync       = m_configuration.Sync_Transfers;
+  op.verify     = m_configuration.Sync_Verify;
+  op.checksums  = m_configuration.Verify_Checksums;
+  op.cache      = m_configuration.Cache_Size > 0;
   op.useLogging = true;
 
-  auto thread = new AWSUtils::S3Thread(op);
-  m_threads << thread;
-
-  connect(thread, SIGNAL(finished()), this, SLOT(onOperationFinished()));
-
-  ProgressDialog dialog(thread, this);
-  dialog.exec();
+  m_queue->enqueue(op, AWSUtils::Priority::normal);
 }
 
 //-----------------------------------------------------------------------------
@@ -194,6 +405,11 @@ void MainWindow::onSettingsButtonTriggered()
     if(config.isValid())
     {
       m_configuration = config;
+
+      applyBandwidthLimits();
+      m_queue->setMaxRunning(m_configuration.Max_Operations);
+      TransferUtils::bufferPool()->setBudget(m_configuration.Transfer_Memory * 1024ULL * 1024ULL);
+      CacheUtils::contentCache()->setLimit(m_configuration.Cache_Size * 1024ULL * 1024ULL);
     }
   }
 
@@ -206,21 +422,9 @@ void MainWindow::onSettingsButtonTriggered()
 //-----------------------------------------------------------------------------
 void MainWindow::onUploadActionTriggered()
 {
-  auto items = getSelectedItems();
-
-  if(items.size() > 1)
-  {
-    QMessageBox::information(this, tr("Upload to bucket"), tr("Invalid selection!"));
-    return;
-  }
-
   QString path;
-  if(!items.empty())
-  {
-    const auto item = items.front();
-    path = (item->id() == 0 ? "": item->fullName());
-    if(!path.isEmpty() && !path.endsWith(AWSUtils::DELIMITER)) path = path + AWSUtils::DELIMITER;
-  }
+  if(!uploadDestination(path)) return;
+
   auto files = QFileDialog::getOpenFileNames(this, tr("Upload files"), QDir::homePath());
 
   if(!files.empty())
@@ -243,26 +447,108 @@ void MainWindow::onUploadActionTriggered()
       return;
     }
 
-    AWSUtils::Operation op;
-    op.bucket = AWSUtils::toAwsString(m_configuration.AWS_Bucket);
-    op.region = AWSUtils::toAwsString(m_configuration.AWS_Region);
-    op.type   = AWSUtils::OperationType::upload;
-    op.credentials = Aws::Auth::AWSCredentials(AWSUtils::toAwsString(Utils::rot13(m_configuration.AWS_Access_key_id)),
-                                               AWSUtils::toAwsString(Utils::rot13(m_configuration.AWS_Secret_access_key)));
-    op.keys = std::move(selected);
-    op.parameters = Aws::String(path.toStdString().c_str(), path.length());
-    op.useLogging = false;
+    enqueueUpload(std::move(selected), path);
+  }
+}
 
-    auto thread = new AWSUtils::S3Thread(op);
-    m_threads << thread;
+//-----------------------------------------------------------------------------
+void MainWindow::onUploadDirectoryActionTriggered()
+{
+  QString path;
+  if(!uploadDestination(path)) return;
+
+  auto directory = QFileDialog::getExistingDirectory(this, tr("Upload directory"), QDir::homePath());
+
+  if(!directory.isEmpty())
+  {
+    QFileInfo info(directory);
+    if(!info.isDir() || !info.isReadable())
+    {
+      QMessageBox::information(this, tr("Upload to bucket"), tr("Cannot read the selected directory!"));
+      return;
+    }
 
-    connect(thread, SIGNAL(finished()), this, SLOT(onOperationFinished()));
+    // contents are scanned by the operation while uploading.
+    std::vector<std::pair<std::string, unsigned long long>> selected;
+    selected.emplace_back(info.absoluteFilePath().toStdString(), 0);
 
-    ProgressDialog dialog(thread, this);
-    dialog.exec();
+    enqueueUpload(std::move(selected), path);
   }
 }
 
+//-----------------------------------------------------------------------------
+bool MainWindow::uploadDestination(QString& path)
+{
+  auto items = getSelectedItems();
+
+  if(items.size() > 1)
+  {
+    QMessageBox::information(this, tr("Upload to bucket"), tr("Invalid selection!"));
+    return false;
+  }
+
+  path.clear();
+  if(!items.empty())
+  {
+    const auto item = items.front();
+    path = (item->id() == 0 ? "": item->fullName());
+    if(!path.isEmpty() && !path.endsWith(AWSUtils::DELIMITER)) path = path + AWSUtils::DELIMITER;
+  }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void MainWindow::enqueueUpload(std::vector<std::pair<std::string, unsigned long long>> &&keys, const QString& path)
+{
+  AWSUtils::Operation op;
+  op.bucket = AWSUtils::toAwsString(m_configuration.AWS_Bucket);
+  op.region = AWSUtils::toAwsString(m_configuration.AWS_Region);
+  op.type   = AWSUtils::OperationType::upload;
+  op.credentials = Aws::Auth::AWSCredentials(AWSUtils::toAwsString(Utils::rot13(m_configuration.AWS_Access_key_id)),
+                                             AWSUtils::toAwsString(Utils::rot13(m_configuration.AWS_Secret_access_key)));
+  op.keys = std::move(keys);
+  op.parameters = Aws::String(path.toStdString().c_str(), path.length());
+  op.sync       = m_configuration.Sync_Transfers;
+  op.verify     = m_configuration.Sync_Verify;
+  op.checksums  = m_configuration.Verify_Checksums;
+  op.useLogging = false;
+
+  if(op.sync) op.remoteSizes = objectSizes(path);
+
+  m_queue->enqueue(op, AWSUtils::Priority::normal);
+}
+
+//-----------------------------------------------------------------------------
+std::shared_ptr<const AWSUtils::SizesMap> MainWindow::objectSizes(const QString& path)
+{
+  auto sizes = std::make_shared<AWSUtils::SizesMap>();
+
+  auto item = m_factory->itemFromKey(path);
+  if(item && isDirectory(item))
+  {
+    // keys are built from the parent key, computing the full name of every item is much slower.
+    std::function<void(Item *, const std::string &)> addSizes = [&addSizes, &sizes](Item *i, const std::string &prefix)
+    {
+      auto children = i->children();
+      for(auto child: children)
+      {
+        if(!child) continue;
+
+        const auto key = prefix + child->name().toStdString();
+        if(isDirectory(child)) addSizes(child, key + AWSUtils::DELIMITER.toStdString());
+        else sizes->emplace(key, child->objectSize());
+      }
+    };
+
+    auto prefix = item->fullName();
+    if(!prefix.isEmpty()) prefix += AWSUtils::DELIMITER;
+    addSizes(item, prefix.toStdString());
+  }
+
+  return sizes;
+}
+
 //-----------------------------------------------------------------------------
 void MainWindow::onDeleteActionTriggered()
 {
@@ -331,7 +617,8 @@ void MainWindow::onDeleteActionTriggered()
   QString details = tr("Objects to be deleted from the bucket:");
   auto addSelectedFiles = [&details](const std::pair<std::string, unsigned long long> &p)
   {
-    details += tr("\n%1").arg(QString::fromStdString(p.first));
+    details += '\n';
+    details += QString::fromStdString(p.first);
   };
   std::for_each(selected.cbegin(), selected.cend(), addSelectedFiles);
 
@@ -354,13 +641,11 @@ void MainWindow::onDeleteActionTriggered()
     op.keys = std::move(selected);
     op.useLogging = true;
 
-    auto thread = new AWSUtils::S3Thread(op);
-    m_threads << thread;
+    QStringList selectedKeys;
+    std::for_each(items.cbegin(), items.cend(), [&selectedKeys](const Item *i) { selectedKeys << i->fullName(); });
 
-    connect(thread, SIGNAL(finished()), this, SLOT(onOperationFinished()));
-
-    ProgressDialog dialog(thread, this);
-    dialog.exec();
+    auto thread = m_queue->enqueue(op, AWSUtils::Priority::high);
+    m_jobSelection.insert(thread, selectedKeys);
   }
 }
 
@@ -401,22 +686,294 @@ void MainWindow::onCreateActionTriggered()
   updateStatusLabel();
 }
 
+//-----------------------------------------------------------------------------
+void MainWindow::onRenameActionTriggered()
+{
+  auto items = getSelectedItems();
+
+  const auto title = tr("Rename");
+
+  if(items.size() != 1 || items.front()->id() == 0)
+  {
+    QMessageBox::information(this, title, tr("Invalid selection!"));
+    return;
+  }
+
+  auto item = items.front();
+
+  bool ok;
+  auto name = QInputDialog::getText(this, tr("Enter new name"), tr("Name:"), QLineEdit::Normal, item->name(), &ok);
+  if(!ok || name.isEmpty() || name == item->name()) return;
+
+  if (name.contains(AWSUtils::DELIMITER))
+  {
+    QMessageBox::information(this, title, tr("The name '%1' is invalid!\nMust not contain the '/' character.").arg(name));
+    return;
+  }
+
+  auto children = item->parent()->children();
+  auto it = std::find_if(children.cbegin(), children.cend(), [&name, item](const Item *i){ if(i && i != item) return (i->name().compare(name, Qt::CaseInsensitive) == 0); return false; });
+  if(it != children.cend())
+  {
+    QMessageBox::information(this, title, tr("The name '%1' is invalid!\nThe parent has already an object with that name.").arg(name));
+    return;
+  }
+
+  auto path = item->parent()->fullName();
+  if(!path.isEmpty()) path += AWSUtils::DELIMITER;
+
+  enqueueMove({ std::make_pair(item, path + name) });
+}
+
+//-----------------------------------------------------------------------------
+void MainWindow::onMoveActionTriggered()
+{
+  auto items = getSelectedItems();
+
+  const auto title = tr("Move objects");
+
+  if(items.empty() || std::any_of(items.cbegin(), items.cend(), [](const Item *i) { return i->id() == 0; }))
+  {
+    QMessageBox::information(this, title, tr("Invalid selection!"));
+    return;
+  }
+
+  auto parent = items.front()->parent();
+  if(std::any_of(items.cbegin(), items.cend(), [parent](const Item *i) { return i->parent() != parent; }))
+  {
+    QMessageBox::information(this, title, tr("Selection musn't have multiple parents."));
+    return;
+  }
+
+  bool ok;
+  auto path = QInputDialog::getText(this, tr("Enter destination directory"), tr("Directory:"), QLineEdit::Normal, parent->fullName(), &ok);
+  if(!ok) return;
+
+  path = path.split(AWSUtils::DELIMITER, QString::SkipEmptyParts).join(AWSUtils::DELIMITER);
+
+  auto directory = m_factory->itemFromKey(path);
+  if(!directory || !isDirectory(directory))
+  {
+    QMessageBox::information(this, title, tr("The directory '%1' doesn't exist!").arg(path));
+    return;
+  }
+
+  if(directory == parent) return;
+
+  auto children = directory->children();
+  std::vector<std::pair<Item *, QString>> moves;
+  for(auto item: items)
+  {
+    const auto key = item->fullName();
+    if(isDirectory(item) && (path == key || path.startsWith(key + AWSUtils::DELIMITER)))
+    {
+      QMessageBox::information(this, title, tr("The directory '%1' can't be moved inside itself!").arg(item->name()));
+      return;
+    }
+
+    auto it = std::find_if(children.cbegin(), children.cend(), [item](const Item *i){ if(i) return (i->name().compare(item->name(), Qt::CaseInsensitive) == 0); return false; });
+    if(it != children.cend())
+    {
+      QMessageBox::information(this, title, tr("The directory '%1' has already an object named '%2'!").arg(path).arg(item->name()));
+      return;
+    }
+
+    moves.emplace_back(item, path.isEmpty() ? item->name() : path + AWSUtils::DELIMITER + item->name());
+  }
+
+  enqueueMove(moves);
+}
+
+//-----------------------------------------------------------------------------
+void MainWindow::enqueueMove(const std::vector<std::pair<Item *, QString>> &items)
+{
+  AWSUtils::Operation op;
+  op.bucket = AWSUtils::toAwsString(m_configuration.AWS_Bucket);
+  op.region = AWSUtils::toAwsString(m_configuration.AWS_Region);
+  op.type   = AWSUtils::OperationType::move;
+  op.credentials = Aws::Auth::AWSCredentials(AWSUtils::toAwsString(Utils::rot13(m_configuration.AWS_Access_key_id)),
+                                             AWSUtils::toAwsString(Utils::rot13(m_configuration.AWS_Secret_access_key)));
+  op.useLogging = true;
+
+  // keys are built from the parent keys, computing the full name of every item is much slower.
+  const auto delimiter = AWSUtils::DELIMITER.toStdString();
+  std::function<void(Item *, const std::string &, const std::string &)> addObjects = [&](Item *i, const std::string &source, const std::string &destination)
+  {
+    if(!isDirectory(i))
+    {
+      op.keys.emplace_back(source, i->objectSize());
+      op.destinations.push_back(destination);
+      return;
+    }
+
+    auto children = i->children();
+    for(auto child: children)
+    {
+      if(!child) continue;
+
+      const auto name = child->name().toStdString();
+      addObjects(child, source + delimiter + name, destination + delimiter + name);
+    }
+  };
+
+  Moves moves;
+  for(auto &item: items)
+  {
+    moves.emplace_back(item.first->fullName().toStdString(), item.second.toStdString());
+    addObjects(item.first, moves.back().first, moves.back().second);
+  }
+
+  // directories without objects only exist in the tree.
+  if(op.keys.empty())
+  {
+    commitMoves(moves, op.keys);
+    return;
+  }
+
+  auto thread = m_queue->enqueue(op, AWSUtils::Priority::normal);
+  m_jobMoves.insert(thread, moves);
+}
+
+//-----------------------------------------------------------------------------
+void MainWindow::commitMoves(const Moves &moves, const std::vector<std::pair<std::string, unsigned long long>> &completed)
+{
+  std::unordered_set<std::string> moved;
+  std::for_each(completed.cbegin(), completed.cend(), [&moved](const std::pair<std::string, unsigned long long> &p) { moved.insert(p.first); });
+
+  const auto delimiter = AWSUtils::DELIMITER.toStdString();
+
+  // the tree could have been modified while the operation was running, items are searched by key.
+  Moves relinks;
+  for(auto &move: moves)
+  {
+    auto item = m_factory->itemFromKey(QString::fromStdString(move.first));
+    if(!item) continue;
+
+    Moves objects;
+    bool complete = true;
+    std::function<void(Item *, const std::string &, const std::string &)> addMoved = [&](Item *i, const std::string &source, const std::string &destination)
+    {
+      if(!isDirectory(i))
+      {
+        if(moved.find(source) != moved.cend()) objects.emplace_back(source, destination);
+        else complete = false;
+        return;
+      }
+
+      auto children = i->children();
+      for(auto child: children)
+      {
+        if(!child) continue;
+
+        const auto name = child->name().toStdString();
+        addMoved(child, source + delimiter + name, destination + delimiter + name);
+      }
+    };
+    addMoved(item, move.first, move.second);
+
+    if(complete) relinks.push_back(move);
+    else relinks.insert(relinks.end(), objects.cbegin(), objects.cend());
+  }
+
+  if(!relinks.empty())
+  {
+    if(!m_factory->moveItems(relinks))
+    {
+      statusBar()->showMessage(tr("Some items have been left in place in the tree, their names are used by other items in the destination."), 5000);
+    }
+
+    m_model->refresh();
+    restoreExpandedIndexes();
+  }
+
+  updateStatusLabel();
+}
+
 //-----------------------------------------------------------------------------
 void MainWindow::onSearchTextChanged(const QString& text)
 {
-  m_searchButton->setEnabled(!text.isEmpty());
+  m_searchButton->setEnabled(!m_searchLine->text().isEmpty() || !m_typeLine->text().isEmpty());
 
   if(text.isEmpty()) onSearchButtonClicked();
 }
 
+//-----------------------------------------------------------------------------
+void MainWindow::onTypeActivated(const QString &extension)
+{
+  m_typeLine->setText(extension);
+
+  onSearchButtonClicked();
+}
+
+//-----------------------------------------------------------------------------
+void MainWindow::onSizeFilterActivated(int index)
+{
+  if(index == CUSTOM_RANGE)
+  {
+    bool accepted = false;
+    const auto minimum = QInputDialog::getDouble(this, tr("Size filter"), tr("Minimum size of the files in MB:"), m_customRange.first / static_cast<double>(MEGABYTE), 0, 1e9, 2, &accepted);
+    if(!accepted) return;
+
+    const auto maximum = QInputDialog::getDouble(this, tr("Size filter"), tr("Maximum size of the files in MB:"), std::max(minimum, 1024.), minimum, 1e9, 2, &accepted);
+    if(!accepted) return;
+
+    m_customRange = std::make_pair(static_cast<unsigned long long>(minimum * MEGABYTE), static_cast<unsigned long long>(maximum * MEGABYTE));
+    m_sizeFilter->setItemText(CUSTOM_RANGE, tr("%1 MB to %2 MB...").arg(minimum).arg(maximum));
+  }
+
+  onSearchButtonClicked();
+}
+
+//-----------------------------------------------------------------------------
+MainWindow::SizeRange MainWindow::sizeRange() const
+{
+  const auto maximum = std::numeric_limits<unsigned long long>::max();
+
+  switch(m_sizeFilter->currentIndex())
+  {
+    case 1:  return std::make_pair(0ULL, 0ULL);
+    case 2:  return std::make_pair(1ULL, MEGABYTE);
+    case 3:  return std::make_pair(MEGABYTE + 1, 100 * MEGABYTE);
+    case 4:  return std::make_pair(100 * MEGABYTE + 1, GIGABYTE);
+    case 5:  return std::make_pair(GIGABYTE + 1, 10 * GIGABYTE);
+    case 6:  return std::make_pair(10 * GIGABYTE + 1, maximum);
+    case CUSTOM_RANGE: return m_customRange;
+    default: break;
+  }
+
+  return std::make_pair(0ULL, maximum);
+}
+
 //-----------------------------------------------------------------------------
 void MainWindow::onSearchButtonClicked()
 {
+  const auto range = sizeRange();
+  auto extension = m_typeLine->text().trimmed();
+  if(extension.startsWith('.')) extension.remove(0, 1);
+
+  // the modes are the text, glob and regular expression syntaxes for names and then for keys.
+  const auto mode = m_searchMode->currentIndex();
+
+  TreeModel::Filter filter;
+  filter.text      = m_searchLine->text();
+  filter.syntax    = static_cast<PatternUtils::Syntax>(mode % 3);
+  filter.fullKey   = mode >= 3;
+  filter.minimum   = range.first;
+  filter.maximum   = range.second;
+  filter.extension = extension;
+
+  const PatternUtils::Pattern pattern(filter.text, filter.syntax);
+  if(!pattern.isValid())
+  {
+    QMessageBox::warning(this, tr("SuperDuck"), tr("Invalid filter pattern: %1").arg(pattern.errorString()));
+    return;
+  }
+
   QApplication::setOverrideCursor(Qt::WaitCursor);
 
   auto selectedIndexes = m_treeView->selectionModel()->selectedIndexes();
 
-  m_model->setFilter(m_searchLine->text());
+  m_model->setFilter(filter);
 
   restoreExpandedIndexes();
 
@@ -465,74 +1022,78 @@ void MainWindow::resizeEvent(QResizeEvent* e)
 }
 
 //-----------------------------------------------------------------------------
-void MainWindow::onOperationFinished()
+void MainWindow::onOperationFinished(AWSUtils::S3Thread *thread)
 {
-  auto thread = qobject_cast<AWSUtils::S3Thread *>(sender());
-  if(thread)
-  {
-    const auto items = getSelectedItems();
-    const auto operation = thread->operation();
-    const auto &errors = thread->errors();
+  const auto operation = thread->operation();
+  const auto &errors = thread->errors();
+  const auto &completed = thread->completed();
+  const auto selection = m_jobSelection.take(thread);
+  const auto moves = m_jobMoves.take(thread);
 
-    if(!errors.isEmpty())
+  if(!errors.isEmpty())
+  {
+    QString details = tr("There has been errors in the following objects:");
+    for(auto i = errors.cbegin(); i != errors.cend(); ++i)
     {
-      QString details = tr("There has been errors in the following objects:");
-      for(auto i = errors.cbegin(); i != errors.cend(); ++i)
-      {
-        details += tr("\n%1: %2").arg(i.key()).arg(i.value().join('\n'));
-      }
-
-      QMessageBox msgBox(this);
-      msgBox.setWindowTitle(tr("%1 operation").arg(AWSUtils::operationTypeToText(operation.type)));
-      msgBox.setWindowIcon(QIcon(":/Pato/rubber-duck.svg"));
-      msgBox.setText(tr("The operation finished with errors."));
-      msgBox.setDetailedText(details);
-      msgBox.setIcon(QMessageBox::Icon::Critical);
-      msgBox.setStandardButtons(QMessageBox::Ok);
-
-      msgBox.exec();
+      details += tr("\n%1: %2").arg(i.key()).arg(i.value().join('\n'));
     }
 
-    auto itemsWithErrors = errors.keys();
+    // non-modal, other operations can finish while the user reads it.
+    auto msgBox = new QMessageBox(this);
+    msgBox->setAttribute(Qt::WA_DeleteOnClose);
+    msgBox->setWindowTitle(tr("%1 operation").arg(AWSUtils::operationTypeToText(operation.type)));
+    msgBox->setWindowIcon(QIcon(":/Pato/rubber-duck.svg"));
+    msgBox->setText(tr("The operation finished with errors."));
+    msgBox->setDetailedText(details);
+    msgBox->setIcon(QMessageBox::Icon::Critical);
+    msgBox->setStandardButtons(QMessageBox::Ok);
+    msgBox->setModal(false);
+    msgBox->show();
+  }
 
-    switch(operation.type)
-    {
-      case AWSUtils::OperationType::remove:
-        for(auto it = items.begin(); it != items.end(); ++it)
+  // the tree could have been modified while the operation was running, items are searched by key.
+  switch(operation.type)
+  {
+    case AWSUtils::OperationType::remove:
+      {
+        for(auto it = completed.cbegin(); it != completed.cend(); ++it)
         {
-          if(!itemsWithErrors.contains((*it)->fullName())) m_model->removeItem(*it);
+          auto item = m_factory->itemFromKey(QString::fromStdString((*it).first));
+          if(item && !isDirectory(item)) m_model->removeItem(item);
         }
-        updateStatusLabel();
-        break;
-      case AWSUtils::OperationType::upload:
+
+        // remove the selected directories that have been emptied.
+        std::function<bool(Item *)> hasFiles = [&hasFiles](Item *i)
+        {
+          if(!isDirectory(i)) return true;
+          auto children = i->children();
+          return std::any_of(children.cbegin(), children.cend(), hasFiles);
+        };
+
+        for(auto key: selection)
         {
-          auto parentItem = items.empty() ? m_factory->items().at(0) : items.at(0);
-          Items items;
-          for(auto it = operation.keys.cbegin(); it != operation.keys.cend(); ++it)
-          {
-            const auto pair = (*it);
-            const auto filename = QString::fromStdString(pair.first);
-            if(!itemsWithErrors.contains(filename))
-            {
-              QFileInfo info(filename);
-              items.push_back(m_factory->createItem(info.fileName(), parentItem, pair.second, Type::File));
-            }
-          }
-
-          if(!items.empty()) m_model->addItems(items);
+          auto item = m_factory->itemFromKey(key);
+          if(item && item->id() != 0 && isDirectory(item) && !hasFiles(item)) m_model->removeItem(item);
         }
-        updateStatusLabel();
-        break;
-      case AWSUtils::OperationType::download:
-      default:
-        break;
-    }
+      }
+      updateStatusLabel();
+      break;
+    case AWSUtils::OperationType::upload:
+      if(!completed.empty() || !thread->directories().empty())
+      {
+        m_factory->createItems(thread->directories(), completed);
 
-    delete thread;
-  }
-  else
-  {
-    QMessageBox::critical(this, tr("Super Duck"), tr("Error: onOperationFinished() -> Unable to identify sender."));
+        m_model->refresh();
+        restoreExpandedIndexes();
+      }
+      updateStatusLabel();
+      break;
+    case AWSUtils::OperationType::move:
+      commitMoves(moves, completed);
+      break;
+    case AWSUtils::OperationType::download:
+    default:
+      break;
   }
 }
 
@@ -545,25 +1106,39 @@ void MainWindow::updateStatusLabel()
   auto directories = rootItem->directoriesNumber();
   if(directories > 0) --directories; // must not count root directory
   m_statusLabel->setText(tr("%1 objects in %2 directories totaling %3 bytes.").arg(files).arg(directories).arg(rootItem->size()));
+
+  m_typesDock->refresh();
 }
 
 //-----------------------------------------------------------------------------
 void MainWindow::closeEvent(QCloseEvent* e)
 {
-  if(m_threads.empty())
+  if(!m_queue->isEmpty() || !m_exports.isEmpty())
   {
-    auto stopThread = [](AWSUtils::S3Thread *t)
+    QMessageBox msgBox(this);
+    msgBox.setWindowTitle(tr("Super Duck"));
+    msgBox.setWindowIcon(QIcon(":/Pato/rubber-duck.svg"));
+    msgBox.setStandardButtons(QMessageBox::Cancel|QMessageBox::Ok);
+    msgBox.setText(tr("There are operations in progress. Do you want to cancel them and exit?"));
+    msgBox.setIcon(QMessageBox::Icon::Question);
+
+    if(msgBox.exec() != QMessageBox::Ok)
     {
-      if(!t->isFinished())
-      {
-        t->abort();
-        t->thread()->terminate();
-      }
+      e->ignore();
+      return;
+    }
 
-      delete t;
-    };
-    std::for_each(m_threads.begin(), m_threads.end(), stopThread);
-    m_threads.clear();
+    disconnect(m_queue, SIGNAL(jobFinished(AWSUtils::S3Thread *)), this, SLOT(onOperationFinished(AWSUtils::S3Thread *)));
+    m_queue->stop(30000);
+  }
+
+  // exports stop on the next block of rows and remove their incomplete files.
+  for(auto job: m_exports.keys())
+  {
+    auto thread = qobject_cast<ListExportUtils::ExportThread *>(job);
+    disconnect(thread, SIGNAL(finished()), this, SLOT(onExportFinished()));
+    thread->abort();
+    thread->wait();
   }
 
   QMainWindow::closeEvent(e);
@@ -597,32 +1172,50 @@ void MainWindow::onContextMenuRequested(const QPoint &pos)
 
   QAction downloadAction(QIcon(":/Pato/cloud-download.svg"), "Download selected objects...");
   QAction uploadAction(QIcon(":/Pato/cloud-upload.svg"), "Upload files...");
+  QAction uploadDirAction(QIcon(":/Pato/cloud-upload.svg"), "Upload directory...");
   QAction createAction(QIcon(":/Pato/cloud-create.svg"), "Create subdirectory...");
+  QAction renameAction(QIcon(":/Pato/folder.svg"), "Rename...");
+  QAction moveAction(QIcon(":/Pato/folder.svg"), "Move selected objects...");
   QAction deleteAction(QIcon(":/Pato/cloud-delete.svg"), "Delete selected objects...");
   QAction exportAction(QIcon(":/Pato/excel.svg"), "Export object list...");
-
-  connect(&downloadAction, SIGNAL(triggered()), this, SLOT(onDownloadActionTriggered()));
-  connect(&uploadAction,   SIGNAL(triggered()), this, SLOT(onUploadActionTriggered()));
-  connect(&createAction,   SIGNAL(triggered()), this, SLOT(onCreateActionTriggered()));
-  connect(&deleteAction,   SIGNAL(triggered()), this, SLOT(onDeleteActionTriggered()));
-  connect(&exportAction,   SIGNAL(triggered()), this, SLOT(onExportActionTriggered()));
+  QAction summaryAction(QIcon(":/Pato/excel.svg"), "Export directory summary...");
+
+  connect(&downloadAction,  SIGNAL(triggered()), this, SLOT(onDownloadActionTriggered()));
+  connect(&uploadAction,    SIGNAL(triggered()), this, SLOT(onUploadActionTriggered()));
+  connect(&uploadDirAction, SIGNAL(triggered()), this, SLOT(onUploadDirectoryActionTriggered()));
+  connect(&createAction,    SIGNAL(triggered()), this, SLOT(onCreateActionTriggered()));
+  connect(&renameAction,    SIGNAL(triggered()), this, SLOT(onRenameActionTriggered()));
+  connect(&moveAction,      SIGNAL(triggered()), this, SLOT(onMoveActionTriggered()));
+  connect(&deleteAction,    SIGNAL(triggered()), this, SLOT(onDeleteActionTriggered()));
+  connect(&exportAction,    SIGNAL(triggered()), this, SLOT(onExportActionTriggered()));
+  connect(&summaryAction,   SIGNAL(triggered()), this, SLOT(onSummaryActionTriggered()));
 
   contextMenu.addAction(&downloadAction);
   contextMenu.addAction(&uploadAction);
+  contextMenu.addAction(&uploadDirAction);
   contextMenu.addAction(&createAction);
+  contextMenu.addAction(&renameAction);
+  contextMenu.addAction(&moveAction);
   contextMenu.addAction(&deleteAction);
   contextMenu.addAction(&exportAction);
+  contextMenu.addAction(&summaryAction);
 
   if(!index.isValid())
   {
     downloadAction.setEnabled(false);
     uploadAction.setText("Upload files to 'root'");
+    uploadDirAction.setText("Upload directory to 'root'");
     createAction.setText("Create subdirectory in 'root'");
+    renameAction.setEnabled(false);
+    moveAction.setEnabled(false);
     deleteAction.setEnabled(false);
   }
   else
   {
+    // moves delete the source objects.
     deleteAction.setEnabled(!m_configuration.DisableDelete);
+    renameAction.setEnabled(!m_configuration.DisableDelete);
+    moveAction.setEnabled(!m_configuration.DisableDelete);
 
     if(items.size() == 1)
     {
@@ -633,7 +1226,10 @@ void MainWindow::onContextMenuRequested(const QPoint &pos)
         contextMenu.setTitle(itemName);
         downloadAction.setText(tr("Download objects in '%1'").arg(itemName));
         uploadAction.setText(tr("Upload files to '%1'").arg(itemName));
+        uploadDirAction.setText(tr("Upload directory to '%1'").arg(itemName));
         createAction.setText(tr("Create subdirectory in '%1'").arg(itemName));
+        renameAction.setText(tr("Rename '%1'...").arg(itemName));
+        moveAction.setText(tr("Move '%1' to...").arg(itemName));
         deleteAction.setText(tr("Delete '%1' and its contents").arg(itemName));
 
         downloadAction.setEnabled(item->childrenCount() > 0);
@@ -642,7 +1238,10 @@ void MainWindow::onContextMenuRequested(const QPoint &pos)
       {
         downloadAction.setText(tr("Donwload '%1'").arg(itemName));
         uploadAction.setEnabled(false);
+        uploadDirAction.setEnabled(false);
         createAction.setEnabled(false);
+        renameAction.setText(tr("Rename '%1'...").arg(itemName));
+        moveAction.setText(tr("Move '%1' to...").arg(itemName));
         deleteAction.setText(tr("Delete '%1'").arg(itemName));
       }
     }
@@ -660,7 +1259,10 @@ void MainWindow::onContextMenuRequested(const QPoint &pos)
       bool multipleParents = (it != items.cend());
 
       deleteAction.setEnabled(!m_configuration.DisableDelete && !multipleParents);
+      renameAction.setEnabled(false);
+      moveAction.setEnabled(!m_configuration.DisableDelete && !multipleParents);
       uploadAction.setEnabled(false);
+      uploadDirAction.setEnabled(false);
       createAction.setEnabled(false);
     }
   }
@@ -693,12 +1295,13 @@ std::vector<std::pair<std::string, unsigned long long>> MainWindow::getSelectedF
 
   std::vector<std::pair<std::string, unsigned long long>> selected;
 
-  std::function<void(Item *)> searchSelectedFiles = [&selected, &searchSelectedFiles, this, useFullNames](Item *i)
+  std::string key;
+  std::function<void(Item *)> searchSelectedFiles = [&selected, &searchSelectedFiles, &key, this, useFullNames](Item *i)
   {
     if(i->type() == Type::File)
     {
-      const auto name = useFullNames ? i->fullName() : i->name();
-      selected.emplace_back(name.toStdString(), i->size());
+      if(useFullNames) i->fullName(key);
+      selected.emplace_back(useFullNames ? key : i->name().toStdString(), i->size());
     }
     else
     {
@@ -748,3 +1351,12 @@ void MainWindow::onAboutButtonTriggered()
   AboutDialog dialog(this);
   dialog.exec();
 }
+
+//-----------------------------------------------------------------------------
+void MainWindow::applyBandwidthLimits()
+{
+  const auto now = QTime::currentTime();
+
+  TransferUtils::uploadLimiter()->SetRate(m_configuration.uploadLimit(now) * 1024LL);
+  TransferUtils::downloadLimiter()->SetRate(m_configuration.downloadLimit(now) * 1024LL);
+}
@@ -25,13 +25,22 @@
 #include <Model/TreeModel.h>
 #include <Utils/Utils.h>
 #include <Utils/AWSUtils.h>
+#include <Utils/ListExportUtils.h>
+#include <Utils/TransferQueue.h>
+#include <Dialogs/TransferDock.h>
+#include <Dialogs/LargestDock.h>
+#include <Dialogs/TypesDock.h>
 #include "ui_MainWindow.h"
 
 // Qt
 #include <QMainWindow>
+#include <QProgressBar>
+#include <QTimer>
 
 // C++
+#include <limits>
 #include <map>
+#include <utility>
 
 /** \class MainWindow
  * \brief Implements the main window of the application.
@@ -63,11 +72,46 @@ class MainWindow
     virtual void closeEvent(QCloseEvent *e) override;
 
   private slots:
-    /** \brief Looks for selected items and writes an excel or csv file to disk.
+    /** \brief Looks for selected items and writes an excel or csv file to disk in the background.
      *
      */
     void onExportActionTriggered();
 
+    /** \brief Writes the summary of the selected directories, or of the bucket if none is selected,
+     * to an excel or csv file in the background.
+     *
+     */
+    void onSummaryActionTriggered();
+
+    /** \brief Finds the largest items of the tree and shows them in the largest items panel.
+     *
+     */
+    void onLargestSearchRequested();
+
+    /** \brief Selects the item with the given key in the tree view.
+     * \param[in] key Item key.
+     *
+     */
+    void onItemActivated(const QString &key);
+
+    /** \brief Shows the quick open dialog and selects the chosen item.
+     *
+     */
+    void onQuickOpenActionTriggered();
+
+    /** \brief Updates the status bar widgets of the export that emitted the signal.
+     * \param[in] rows Number of files written.
+     * \param[in] total Number of files to export.
+     * \param[in] rowsPerSecond Files written per second.
+     *
+     */
+    void onExportProgress(unsigned long long rows, unsigned long long total, double rowsPerSecond);
+
+    /** \brief Removes the status bar widgets of the finished export and reports its result.
+     *
+     */
+    void onExportFinished();
+
     /** \brief Looks for selected items to download from S3 bucket.
      *
      */
@@ -83,6 +127,11 @@ class MainWindow
      */
     void onUploadActionTriggered();
 
+    /** \brief Shows a directory selection dialog and uploads the directory and its contents to the S3 bucket.
+     *
+     */
+    void onUploadDirectoryActionTriggered();
+
     /** \brief Deletes selected items from the S3 bucket.
      *
      */
@@ -93,7 +142,17 @@ class MainWindow
      */
     void onCreateActionTriggered();
 
-    /** \brief Updates the UI when the search text changes.
+    /** \brief Renames the selected item in the S3 bucket.
+     *
+     */
+    void onRenameActionTriggered();
+
+    /** \brief Moves the selected items to another directory of the S3 bucket.
+     *
+     */
+    void onMoveActionTriggered();
+
+    /** \brief Updates the UI when the search or the type text changes.
      * \param[in] text Filter text.
      *
      */
@@ -104,15 +163,28 @@ class MainWindow
      */
     void onSearchButtonClicked();
 
+    /** \brief Asks for the custom size range if selected and updates the filter of the model.
+     * \param[in] index Index of the size filter.
+     *
+     */
+    void onSizeFilterActivated(int index);
+
+    /** \brief Shows only the files of the given type.
+     * \param[in] extension File extension.
+     *
+     */
+    void onTypeActivated(const QString &extension);
+
     /** \brief Forces the user to add a valid configuration.
      *
      */
     void onInvalidConfiguration();
 
-    /** \brief Gets the results of a finished operation.
+    /** \brief Gets the results of a finished operation and commits the changes to the tree.
+     * \param[in] thread Operation thread.
      *
      */
-    void onOperationFinished();
+    void onOperationFinished(AWSUtils::S3Thread *thread);
 
     /** \brief Prepares and shows a menu at the given position.
      * \param[in] pos Position in the tree where a menu was requested.
@@ -137,7 +209,26 @@ class MainWindow
      */
     void onAboutButtonTriggered();
 
+    /** \brief Applies the bandwidth limits of the configuration for the current time.
+     *
+     */
+    void applyBandwidthLimits();
+
   private:
+    using Moves     = std::vector<std::pair<std::string, std::string>>;
+    using SizeRange = std::pair<unsigned long long, unsigned long long>;
+
+    /** \struct ExportWidgets
+     * \brief Status bar widgets of a background export.
+     *
+     */
+    struct ExportWidgets
+    {
+      QWidget      *widget;   /** container of the widgets. */
+      QLabel       *label;    /** progress text.            */
+      QProgressBar *progress; /** progress bar.             */
+    };
+
     /** \brief Helper method to restore application position and size.
      *
      */
@@ -163,6 +254,17 @@ class MainWindow
      */
     void configureTreeView();
 
+    /** \brief Returns the size range of the files of the size filter.
+     *
+     */
+    SizeRange sizeRange() const;
+
+    /** \brief Adds the status bar widgets of the given export and starts it.
+     * \param[in] job Export thread.
+     *
+     */
+    void startExport(ListExportUtils::ExportThread *job);
+
     /** \brief Returns the list of items selected in the tree view.
      *
      */
@@ -179,12 +281,55 @@ class MainWindow
      */
     std::vector<std::pair<std::string, unsigned long long> > getSelectedFileList(bool useFullNames = true) const;
 
-    ItemFactory               *m_factory;       /** item factory pointer.                            */
-    TreeModel                 *m_model;         /** tree model for the items.                        */
-    Utils::Configuration      &m_configuration; /** application configuration.                       */
-    QLabel                    *m_statusLabel;   /** status bar label.                                */
-    QList<AWSUtils::S3Thread*> m_threads;       /** list of threads executing or pending execution.  */
-    QModelIndexList            m_expanded;      /** list of expanded nodes to store tree view state. */
+    /** \brief Returns the destination key prefix of an upload from the current selection. Returns
+     * false if the selection is invalid.
+     * \param[out] path Destination key prefix, empty for the root.
+     *
+     */
+    bool uploadDestination(QString &path);
+
+    /** \brief Adds an upload operation of the given files and directories to the queue.
+     * \param[in] keys Absolute paths of the files and directories and their sizes.
+     * \param[in] path Destination key prefix.
+     *
+     */
+    void enqueueUpload(std::vector<std::pair<std::string, unsigned long long>> &&keys, const QString &path);
+
+    /** \brief Returns the sizes of the objects under the given key prefix in the tree.
+     * \param[in] path Key prefix, empty for the root.
+     *
+     */
+    std::shared_ptr<const AWSUtils::SizesMap> objectSizes(const QString &path);
+
+    /** \brief Adds a move operation of the objects of the given items to the queue. Items without
+     * objects are moved only in the tree.
+     * \param[in] items Items and their destination keys.
+     *
+     */
+    void enqueueMove(const std::vector<std::pair<Item *, QString>> &items);
+
+    /** \brief Moves the items of the tree of a finished move. Items whose objects have been moved
+     * are relinked with their contents, otherwise only the moved objects are relinked.
+     * \param[in] moves Source and destination keys of the moved items.
+     * \param[in] completed Source keys of the moved objects.
+     *
+     */
+    void commitMoves(const Moves &moves, const std::vector<std::pair<std::string, unsigned long long>> &completed);
+
+    ItemFactory                            *m_factory;       /** item factory pointer.                            */
+    TreeModel                              *m_model;         /** tree model for the items.                        */
+    Utils::Configuration                   &m_configuration; /** application configuration.                       */
+    QLabel                                 *m_statusLabel;   /** status bar label.                                */
+    AWSUtils::TransferQueue                *m_queue;         /** operations queue.                                */
+    TransferDock                           *m_transferDock;  /** operations queue panel.                          */
+    LargestDock                            *m_largestDock;   /** largest items panel.                             */
+    TypesDock                              *m_typesDock;     /** file types statistics panel.                     */
+    QMap<AWSUtils::S3Thread *, QStringList> m_jobSelection;  /** keys of the tree items of the queued operations. */
+    QMap<AWSUtils::S3Thread *, Moves>       m_jobMoves;      /** source and destination keys of the queued moves. */
+    QMap<QObject *, ExportWidgets>          m_exports;       /** status bar widgets of the running exports.       */
+    QModelIndexList                         m_expanded;      /** list of expanded nodes to store tree view state. */
+    SizeRange                               m_customRange;   /** custom range of the size filter.                 */
+    QTimer                                  m_limitsTimer;   /** timer to update the scheduled bandwidth limits.  */
 };
 
 #endif // MAINWINDOW_H_
@@ -21,9 +21,13 @@
 #include <Model/ItemsTree.h>
 #include <Dialogs/SplashScreen.h>
 #include <Utils/AWSUtils.h>
+#include <Utils/ParallelUtils.h>
+#include <Utils/SearchUtils.h>
 
 // Qt
 #include <QDir>
+#include <QHash>
+#include <QSet>
 #include <QMessageBox>
 #include <QString>
 #include <QIcon>
@@ -34,12 +38,70 @@
 #include <cassert>
 #include <algorithm>
 #include <iterator>
+#include <functional>
+#include <tuple>
+
+// number of names folded or scanned by a thread at once.
+const std::size_t NAMES_CHUNK_SIZE = 65536;
+
+// maximum length of the extensions, longer suffixes are part of the name.
+const int MAX_EXTENSION_LENGTH = 16;
+
+// number of directories whose children are sorted by a thread at once.
+const std::size_t SORT_CHUNK_SIZE = 64;
+
+//-----------------------------------------------------------------------------
+static int utf16Length(const char *name, const std::size_t length)
+{
+  // a code point is a lead byte, those of four bytes are a surrogate pair.
+  int units = 0;
+  for(std::size_t i = 0; i < length; ++i)
+  {
+    const auto byte = static_cast<unsigned char>(name[i]);
+    if((byte & 0xC0) != 0x80) units += (byte >= 0xF0 ? 2 : 1);
+  }
+
+  return units;
+}
+
+//-----------------------------------------------------------------------------
+static void decodeUtf8(const char *name, const std::size_t length, QChar *data)
+{
+  // writes the units counted by utf16Length, stray continuation bytes are ignored.
+  std::size_t i = 0;
+  while(i < length)
+  {
+    const auto lead = static_cast<unsigned char>(name[i++]);
+    if((lead & 0xC0) == 0x80) continue;
+
+    const int continuations = lead >= 0xF0 ? 3 : (lead >= 0xE0 ? 2 : (lead >= 0xC0 ? 1 : 0));
+    char32_t codePoint = continuations == 0 ? lead : (lead & (0x3F >> continuations));
+    for(int c = 0; c < continuations && i < length && (static_cast<unsigned char>(name[i]) & 0xC0) == 0x80; ++c)
+    {
+      codePoint = (codePoint << 6) | (static_cast<unsigned char>(name[i++]) & 0x3F);
+    }
+
+    if(continuations < 3)
+    {
+      *data++ = QChar(static_cast<ushort>(codePoint));
+    }
+    else
+    {
+      const auto valid = codePoint >= 0x10000 && codePoint <= 0x10FFFF;
+      *data++ = valid ? QChar(QChar::highSurrogate(codePoint)) : QChar(QChar::ReplacementCharacter);
+      *data++ = valid ? QChar(QChar::lowSurrogate(codePoint))  : QChar(QChar::ReplacementCharacter);
+    }
+  }
+}
 
 //-----------------------------------------------------------------------------
 ItemFactory::ItemFactory()
 : m_counter{0}
+, m_namesFolded{false}
 , m_modified{false}
 {
+  // files without extension have the id 0.
+  internExtension(QString());
 }
 
 //-----------------------------------------------------------------------------
@@ -51,11 +113,13 @@ ItemFactory::~ItemFactory()
 //-----------------------------------------------------------------------------
 Item* ItemFactory::createItem(const QString& name, Item* parent, const unsigned long long size, const Type type)
 {
-  const auto item = new Item(name, parent, size, type, m_counter++);
+  const auto item = new Item(namePool().intern(name), parent, size, type, m_counter++);
   if(parent) parent->addChild(item);
 
   m_items.push_back(item);
-  m_modified = true;
+  indexFiles(sizeEntries(Items{item}));
+  m_namesFolded = false;
+  m_modified    = true;
 
   return item;
 }
@@ -198,7 +262,7 @@ void ItemFactory::deserializeItems(std::ifstream& stream, SplashScreen *splash,
 
       unsigned long long size = std::strtoull(line.c_str(), nullptr, 10);
 
-      auto item = new Item(QString::fromStdString(name), nullptr, size, type, id);
+      auto item = new Item(namePool().intern(name.data(), name.size()), nullptr, size, type, id);
       max = std::max(max, id);
       m_items.push_back(item);
     }
@@ -257,14 +321,19 @@ void ItemFactory::deserializeItems(std::ifstream& stream, SplashScreen *splash,
   m_modified = false;
   m_counter = m_items.size();
 
-  auto sortChildren = [this](Item *i)
+  // the children of each directory are sorted independently, in parallel.
+  Items directories;
+  std::copy_if(m_items.cbegin(), m_items.cend(), std::back_inserter(directories), [](const Item *i) { return isDirectory(i) && i->m_childs.size() > 1; });
+
+  auto sortChildren = [&directories](const std::size_t first, const std::size_t last, const std::size_t)
   {
-    if(isDirectory(i))
-    {
-      std::sort(begin(i->m_childs), end(i->m_childs), lessThan);
-    }
+    for(auto i = first; i < last; ++i) std::sort(begin(directories[i]->m_childs), end(directories[i]->m_childs), lessThan);
   };
-  std::for_each(begin(m_items), end(m_items), sortChildren);
+  ParallelUtils::runChunked(directories.size(), SORT_CHUNK_SIZE, sortChildren);
+
+  m_sizes.clear();
+  indexFiles(sizeEntries(m_items));
+  m_namesFolded = false;
 
   if(m_items.empty())
   {
@@ -322,6 +391,8 @@ void ItemFactory::deleteItem(Item* item)
 
   if(item->parent()) item->parent()->removeChild(item);
 
+  unindexFiles(sizeEntries(toDelete));
+
   auto eraseAndDelete = [this](Item *i)
   {
     m_items.erase(std::remove(begin(m_items), end(m_items), i), end(m_items));
@@ -329,37 +400,647 @@ void ItemFactory::deleteItem(Item* item)
   };
   std::for_each(toDelete.begin(), toDelete.end(), eraseAndDelete);
 
-  m_modified = true;
+  m_namesFolded = false;
+  m_modified    = true;
+}
+
+//-----------------------------------------------------------------------------
+Item* ItemFactory::itemFromKey(const QString& key)
+{
+  if(m_items.empty()) return nullptr;
+
+  auto item = m_items.at(0);
+  const auto parts = key.split(AWSUtils::DELIMITER, QString::SkipEmptyParts);
+
+  for(auto part: parts)
+  {
+    // a name that isn't in the pool isn't the name of any item.
+    const auto handle = namePool().find(part);
+    if(handle == NamePool::NOT_FOUND) return nullptr;
+
+    const auto &children = item->children();
+    auto it = std::find_if(children.cbegin(), children.cend(), [handle](const Item *i) { return i && i->nameHandle() == handle; });
+    if(it == children.cend()) return nullptr;
+
+    item = *it;
+  }
+
+  return item;
+}
+
+//-----------------------------------------------------------------------------
+Items ItemFactory::filesInRange(const unsigned long long minimum, const unsigned long long maximum) const
+{
+  Items files;
+  if(minimum > maximum) return files;
+
+  auto first = std::lower_bound(m_sizes.cbegin(), m_sizes.cend(), minimum, [](const SizeEntry &e, const unsigned long long value) { return e.first < value; });
+  auto last  = std::upper_bound(first, m_sizes.cend(), maximum, [](const unsigned long long value, const SizeEntry &e) { return value < e.first; });
+
+  files.reserve(std::distance(first, last));
+  std::transform(first, last, std::back_inserter(files), [](const SizeEntry &e) { return e.second; });
+
+  return files;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<ItemFactory::SizeEntry> ItemFactory::sizeEntries(const Items &items)
+{
+  std::vector<SizeEntry> entries;
+  for(auto item: items)
+  {
+    if(item && item->type() == Type::File) entries.emplace_back(item->m_size, item);
+  }
+
+  return entries;
+}
+
+//-----------------------------------------------------------------------------
+void ItemFactory::indexFiles(std::vector<SizeEntry> entries)
+{
+  if(entries.empty()) return;
+
+  for(auto &entry: entries)
+  {
+    auto item = entry.second;
+    item->m_extension = internExtension(extensionOf(item->name()));
+
+    auto &statistics = m_extensionStats[item->m_extension];
+    ++statistics.files;
+    statistics.bytes += entry.first;
+  }
+
+  // a single insertion is cheaper than the merge.
+  if(entries.size() == 1)
+  {
+    m_sizes.insert(std::upper_bound(m_sizes.begin(), m_sizes.end(), entries.front()), entries.front());
+    return;
+  }
+
+  std::sort(entries.begin(), entries.end());
+
+  const auto middle = m_sizes.size();
+  m_sizes.insert(m_sizes.end(), entries.cbegin(), entries.cend());
+  std::inplace_merge(m_sizes.begin(), m_sizes.begin() + middle, m_sizes.end());
+}
+
+//-----------------------------------------------------------------------------
+void ItemFactory::unindexFiles(std::vector<SizeEntry> entries)
+{
+  if(entries.empty()) return;
+
+  auto removeStatistics = [this](const SizeEntry &e)
+  {
+    auto &statistics = m_extensionStats[e.second->m_extension];
+    --statistics.files;
+    statistics.bytes -= e.first;
+  };
+
+  // a single entry is found by its size, many are removed in one pass.
+  if(entries.size() == 1)
+  {
+    auto it = std::lower_bound(m_sizes.begin(), m_sizes.end(), entries.front());
+    if(it != m_sizes.end() && *it == entries.front())
+    {
+      removeStatistics(*it);
+      m_sizes.erase(it);
+    }
+    return;
+  }
+
+  std::sort(entries.begin(), entries.end());
+
+  auto isRemoved = [&entries, &removeStatistics](const SizeEntry &e)
+  {
+    if(!std::binary_search(entries.cbegin(), entries.cend(), e)) return false;
+
+    removeStatistics(e);
+    return true;
+  };
+  m_sizes.erase(std::remove_if(m_sizes.begin(), m_sizes.end(), isRemoved), m_sizes.end());
+}
+
+//-----------------------------------------------------------------------------
+unsigned int ItemFactory::internExtension(const QString &extension)
+{
+  auto it = m_extensionIds.constFind(extension);
+  if(it != m_extensionIds.constEnd()) return it.value();
+
+  const unsigned int id = m_extensions.size();
+  m_extensions << extension;
+  m_extensionIds.insert(extension, id);
+  m_extensionStats.push_back(ExtensionStatistics{extension, 0, 0});
+
+  return id;
+}
+
+//-----------------------------------------------------------------------------
+QString ItemFactory::extensionOf(const QString &name)
+{
+  // hidden files and names with a dot in the middle of a sentence don't have an extension.
+  const auto position = name.lastIndexOf('.');
+  if(position <= 0 || position == name.length() - 1 || name.length() - position - 1 > MAX_EXTENSION_LENGTH) return QString();
+
+  const auto extension = name.mid(position + 1);
+  if(extension.contains(' ')) return QString();
+
+  return extension.toLower();
+}
+
+//-----------------------------------------------------------------------------
+void ItemFactory::foldNames()
+{
+  m_nameItems.clear();
+  std::copy_if(m_items.cbegin(), m_items.cend(), std::back_inserter(m_nameItems), [](const Item *i) { return i != nullptr; });
+
+  // each chunk is folded by a thread and then copied to the buffer.
+  const auto chunks = (m_nameItems.size() + NAMES_CHUNK_SIZE - 1) / NAMES_CHUNK_SIZE;
+  std::vector<std::string> buffers(chunks);
+  m_nameOffsets.resize(m_nameItems.size() + 1);
+
+  auto foldChunk = [this, &buffers](const std::size_t first, const std::size_t last, const std::size_t)
+  {
+    auto &buffer = buffers[first / NAMES_CHUNK_SIZE];
+    for(auto i = first; i < last; ++i)
+    {
+      m_nameOffsets[i] = buffer.size();
+      buffer += m_nameItems[i]->name().toCaseFolded().toUtf8().toStdString();
+      buffer += '\0';
+    }
+  };
+  ParallelUtils::runChunked(m_nameItems.size(), NAMES_CHUNK_SIZE, foldChunk);
+
+  std::size_t size = 0;
+  std::for_each(buffers.cbegin(), buffers.cend(), [&size](const std::string &b) { size += b.size(); });
+
+  m_names.clear();
+  m_names.reserve(size);
+  for(std::size_t chunk = 0; chunk < chunks; ++chunk)
+  {
+    const auto offset = m_names.size();
+    const auto last   = std::min((chunk + 1) * NAMES_CHUNK_SIZE, m_nameItems.size());
+    for(auto i = chunk * NAMES_CHUNK_SIZE; i < last; ++i) m_nameOffsets[i] += offset;
+
+    m_names += buffers[chunk];
+    std::string().swap(buffers[chunk]);
+  }
+  m_nameOffsets.back() = m_names.size();
+
+  m_namesFolded = true;
+}
+
+//-----------------------------------------------------------------------------
+Items ItemFactory::findByName(const QString &text)
+{
+  if(!m_namesFolded) foldNames();
+
+  const auto needle = text.toCaseFolded().toUtf8();
+  if(needle.isEmpty()) return m_nameItems;
+
+  // the names are separated by a null character so a match can't span two names.
+  std::vector<char> matched(m_nameItems.size(), 0);
+  auto scanChunk = [this, &needle, &matched](const std::size_t first, const std::size_t last, const std::size_t)
+  {
+    auto position = m_nameOffsets[first];
+    const auto end = m_nameOffsets[last];
+    auto name = m_nameOffsets.cbegin() + first;
+
+    while(position < end)
+    {
+      const auto hit = SearchUtils::find(m_names.data() + position, end - position, needle.constData(), needle.size());
+      if(hit == SearchUtils::NOT_FOUND) break;
+
+      // the search continues in the name after the one that contains the hit.
+      name = std::upper_bound(name, m_nameOffsets.cbegin() + last, position + hit) - 1;
+      const auto index = name - m_nameOffsets.cbegin();
+      matched[index] = 1;
+      position = m_nameOffsets[index + 1];
+    }
+  };
+  ParallelUtils::runChunked(m_nameItems.size(), NAMES_CHUNK_SIZE, scanChunk);
+
+  Items result;
+  for(std::size_t i = 0; i < matched.size(); ++i)
+  {
+    if(matched[i]) result.push_back(m_nameItems[i]);
+  }
+
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+Items ItemFactory::bestMatches(const QString &query, const std::size_t count)
+{
+  if(!m_namesFolded) foldNames();
+
+  const SearchUtils::FuzzyPattern pattern(query.toCaseFolded().toUtf8().toStdString());
+  if(pattern.isEmpty() || count == 0) return Items();
+
+  // score, depth and name index. The worst candidate is on top of the heaps.
+  using Candidate = std::tuple<int, unsigned int, std::size_t>;
+  auto better = [](const Candidate &lhs, const Candidate &rhs)
+  {
+    if(std::get<0>(lhs) != std::get<0>(rhs)) return std::get<0>(lhs) > std::get<0>(rhs);
+    if(std::get<1>(lhs) != std::get<1>(rhs)) return std::get<1>(lhs) < std::get<1>(rhs);
+    return std::get<2>(lhs) < std::get<2>(rhs);
+  };
+
+  auto offer = [count, &better](std::vector<Candidate> &heap, const Candidate &candidate)
+  {
+    if(heap.size() < count)
+    {
+      heap.push_back(candidate);
+      std::push_heap(heap.begin(), heap.end(), better);
+    }
+    else if(better(candidate, heap.front()))
+    {
+      std::pop_heap(heap.begin(), heap.end(), better);
+      heap.back() = candidate;
+      std::push_heap(heap.begin(), heap.end(), better);
+    }
+  };
+
+  std::vector<std::vector<Candidate>> heaps(ParallelUtils::threadsCount());
+  auto scoreChunk = [&](const std::size_t first, const std::size_t last, const std::size_t thread)
+  {
+    auto &heap = heaps[thread];
+    for(auto i = first; i < last; ++i)
+    {
+      const auto score = pattern.score(m_names.data() + m_nameOffsets[i], m_nameOffsets[i + 1] - m_nameOffsets[i] - 1);
+      if(score == SearchUtils::FuzzyPattern::NO_MATCH) continue;
+
+      // the depth is only needed if the score can enter the heap.
+      if(heap.size() == count && score < std::get<0>(heap.front())) continue;
+
+      unsigned int depth = 0;
+      for(auto parent = m_nameItems[i]->parent(); parent; parent = parent->parent()) ++depth;
+
+      offer(heap, Candidate{score, depth, i});
+    }
+  };
+  ParallelUtils::runChunked(m_nameItems.size(), NAMES_CHUNK_SIZE, scoreChunk);
+
+  std::vector<Candidate> merged;
+  for(auto &heap: heaps)
+  {
+    std::for_each(heap.cbegin(), heap.cend(), [&merged, &offer](const Candidate &c) { offer(merged, c); });
+  }
+  std::sort(merged.begin(), merged.end(), better);
+
+  Items result;
+  std::transform(merged.cbegin(), merged.cend(), std::back_inserter(result), [this](const Candidate &c) { return m_nameItems[std::get<2>(c)]; });
+
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<ItemFactory::ExtensionStatistics> ItemFactory::extensionStatistics() const
+{
+  std::vector<ExtensionStatistics> result;
+  std::copy_if(m_extensionStats.cbegin(), m_extensionStats.cend(), std::back_inserter(result), [](const ExtensionStatistics &e) { return e.files != 0; });
+
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+int ItemFactory::extensionId(const QString &extension) const
+{
+  auto it = m_extensionIds.constFind(extension.toLower());
+  if(it == m_extensionIds.constEnd() || m_extensionStats[it.value()].files == 0) return -1;
+
+  return it.value();
+}
+
+//-----------------------------------------------------------------------------
+Items ItemFactory::createItems(const std::vector<std::string> &directories, const std::vector<std::pair<std::string, unsigned long long>> &files)
+{
+  Items created;
+  if(m_items.empty()) return created;
+
+  QHash<QString, Item *> directoryItems;         // directory key -> item.
+  QHash<Item *, QHash<QString, Item *>> contents; // directory item -> children by name, built on demand.
+  QSet<Item *> modified;                          // directories whose children must be sorted.
+  std::vector<SizeEntry> resized;                 // index entries of the existing files with a new size.
+
+  directoryItems.insert(QString(), m_items.at(0));
+
+  auto childrenOf = [&contents](Item *directory) -> QHash<QString, Item *> &
+  {
+    if(!contents.contains(directory))
+    {
+      auto &names = contents[directory];
+      std::for_each(directory->m_childs.cbegin(), directory->m_childs.cend(), [&names](Item *i) { if(i) names.insert(i->name(), i); });
+    }
+
+    return contents[directory];
+  };
+
+  auto newItem = [&](const QString &name, Item *parent, const unsigned long long size, const Type type)
+  {
+    auto item = new Item(namePool().intern(name), parent, size, type, m_counter++);
+    parent->m_childs.push_back(item);
+    m_items.push_back(item);
+
+    childrenOf(parent).insert(name, item);
+    modified.insert(parent);
+    created.push_back(item);
+
+    return item;
+  };
+
+  std::function<Item *(const QString &)> directoryItem = [&](const QString &key) -> Item *
+  {
+    auto it = directoryItems.constFind(key);
+    if(it != directoryItems.constEnd()) return it.value();
+
+    const auto position = key.lastIndexOf(AWSUtils::DELIMITER);
+    auto parent = directoryItem(position == -1 ? QString() : key.left(position));
+    const auto name = key.mid(position + 1);
+
+    auto &children = childrenOf(parent);
+    auto child = children.value(name, nullptr);
+    if(!child || !isDirectory(child)) child = newItem(name, parent, 0, Type::Directory);
+
+    directoryItems.insert(key, child);
+    return child;
+  };
+
+  auto cleanKey = [](const std::string &key)
+  {
+    return QString::fromStdString(key).split(AWSUtils::DELIMITER, QString::SkipEmptyParts).join(AWSUtils::DELIMITER);
+  };
+
+  for(auto &directory: directories)
+  {
+    directoryItem(cleanKey(directory));
+  }
+
+  for(auto &file: files)
+  {
+    const auto key = cleanKey(file.first);
+    const auto position = key.lastIndexOf(AWSUtils::DELIMITER);
+    auto parent = directoryItem(position == -1 ? QString() : key.left(position));
+    const auto name = key.mid(position + 1);
+
+    auto existing = childrenOf(parent).value(name, nullptr);
+    if(existing && !isDirectory(existing))
+    {
+      if(existing->m_size != file.second)
+      {
+        resized.emplace_back(existing->m_size, existing);
+        existing->m_size = file.second;
+      }
+    }
+    else
+    {
+      newItem(name, parent, file.second, Type::File);
+    }
+  }
+
+  std::for_each(modified.begin(), modified.end(), [](Item *i) { std::sort(begin(i->m_childs), end(i->m_childs), lessThan); });
+
+  // the resized files are indexed again with their new size.
+  auto changed = created;
+  for(auto &entry: resized) changed.push_back(entry.second);
+  unindexFiles(resized);
+  indexFiles(sizeEntries(changed));
+
+  m_namesFolded = false;
+  m_modified    = true;
+
+  return created;
+}
+
+//-----------------------------------------------------------------------------
+bool ItemFactory::moveItems(const std::vector<std::pair<std::string, std::string>> &moves)
+{
+  if(m_items.empty() || moves.empty()) return true;
+
+  QHash<Item *, QHash<QString, Item *>> contents; // directory item -> children by name, built on demand.
+  QSet<Item *> modified;                          // directories whose children must be sorted.
+  QSet<Item *> oldParents;                        // directories that have lost children.
+  QSet<Item *> removed;                           // items replaced or merged in the destination.
+  std::vector<SizeEntry> renamed;                 // files whose extension may have changed.
+  bool complete = true;                           // false if any item has been left in place.
+
+  auto childrenOf = [&contents](Item *directory) -> QHash<QString, Item *> &
+  {
+    if(!contents.contains(directory))
+    {
+      auto &names = contents[directory];
+      std::for_each(directory->m_childs.cbegin(), directory->m_childs.cend(), [&names](Item *i) { if(i) names.insert(i->name(), i); });
+    }
+
+    return contents[directory];
+  };
+
+  // returns the item of the given key, creating the missing directories if requested. Returns
+  // nullptr if a directory to create has the key of a file.
+  auto itemOf = [&](const QString &key, const bool create) -> Item *
+  {
+    auto item = m_items.at(0);
+    for(auto part: key.split(AWSUtils::DELIMITER, QString::SkipEmptyParts))
+    {
+      auto &children = childrenOf(item);
+      auto child = children.value(part, nullptr);
+      if(create && child && !isDirectory(child)) return nullptr;
+
+      if(create && !child)
+      {
+        child = new Item(namePool().intern(part), item, 0, Type::Directory, m_counter++);
+        item->m_childs.push_back(child);
+        m_items.push_back(child);
+        children.insert(part, child);
+        modified.insert(item);
+      }
+
+      if(!child) return nullptr;
+      item = child;
+    }
+
+    return item;
+  };
+
+  // directories are relinked with their whole subtree, or their children are moved if the
+  // destination already has a directory with the same name. Returns false if the item or any of
+  // its contents have been left in place.
+  std::function<bool(Item *, Item *, const QString &)> relink = [&](Item *item, Item *parent, const QString &name)
+  {
+    auto &children = childrenOf(parent);
+    auto existing = children.value(name, nullptr);
+    if(existing == item) return true;
+
+    // a file and a directory with the same key can't be in the tree.
+    if(existing && isDirectory(existing) != isDirectory(item)) return false;
+
+    const auto oldParent = item->m_parent;
+
+    if(existing && isDirectory(item))
+    {
+      bool complete = true;
+      const auto grandchildren = item->m_childs;
+      std::for_each(grandchildren.cbegin(), grandchildren.cend(), [&](Item *i) { if(i && !relink(i, existing, i->name())) complete = false; });
+
+      // the merged directory is kept with the contents that couldn't be moved.
+      if(!complete) return false;
+
+      childrenOf(oldParent).remove(item->name());
+      oldParents.insert(oldParent);
+      removed.insert(item);
+      return true;
+    }
+
+    childrenOf(oldParent).remove(item->name());
+    oldParents.insert(oldParent);
+
+    if(existing)
+    {
+      // the object in the destination has been overwritten.
+      children.remove(name);
+      oldParents.insert(parent);
+      removed.insert(existing);
+    }
+
+    const auto handle = namePool().intern(name);
+    if(!isDirectory(item) && item->m_name != handle) renamed.emplace_back(item->m_size, item);
+
+    item->m_parent = parent;
+    item->m_name   = handle;
+    if(oldParent != parent) parent->m_childs.push_back(item);
+    children.insert(name, item);
+    modified.insert(parent);
+
+    return true;
+  };
+
+  for(auto &move: moves)
+  {
+    const auto sourceKey = QString::fromStdString(move.first).split(AWSUtils::DELIMITER, QString::SkipEmptyParts).join(AWSUtils::DELIMITER);
+    auto item = itemOf(sourceKey, false);
+    if(!item || item->id() == 0) continue;
+
+    const auto destinationKey = QString::fromStdString(move.second).split(AWSUtils::DELIMITER, QString::SkipEmptyParts).join(AWSUtils::DELIMITER);
+    if(destinationKey.isEmpty() || destinationKey == sourceKey) continue;
+
+    // a directory can't be moved inside itself.
+    if(isDirectory(item) && destinationKey.startsWith(sourceKey + AWSUtils::DELIMITER)) continue;
+
+    const auto position = destinationKey.lastIndexOf(AWSUtils::DELIMITER);
+    auto parent = itemOf(position == -1 ? QString() : destinationKey.left(position), true);
+
+    if(!parent || !relink(item, parent, destinationKey.mid(position + 1))) complete = false;
+  }
+
+  // the children of the old parents are updated in one pass instead of once per moved item.
+  for(auto parent: oldParents)
+  {
+    auto moved = [parent, &removed](Item *i) { return !i || i->m_parent != parent || removed.contains(i); };
+    parent->m_childs.erase(std::remove_if(parent->m_childs.begin(), parent->m_childs.end(), moved), parent->m_childs.end());
+  }
+
+  // an item moved back to its original directory is listed twice.
+  for(auto parent: modified)
+  {
+    std::sort(begin(parent->m_childs), end(parent->m_childs), lessThan);
+    parent->m_childs.erase(std::unique(parent->m_childs.begin(), parent->m_childs.end()), parent->m_childs.end());
+  }
+
+  // renamed files are indexed again with their new extension.
+  std::sort(renamed.begin(), renamed.end());
+  renamed.erase(std::unique(renamed.begin(), renamed.end()), renamed.end());
+  unindexFiles(renamed);
+  indexFiles(renamed);
+
+  if(!removed.isEmpty())
+  {
+    unindexFiles(sizeEntries(Items(removed.cbegin(), removed.cend())));
+    m_items.erase(std::remove_if(m_items.begin(), m_items.end(), [&removed](Item *i) { return removed.contains(i); }), m_items.end());
+    std::for_each(removed.cbegin(), removed.cend(), [](Item *i) { delete i; });
+  }
+
+  m_namesFolded = false;
+  m_modified    = true;
+
+  return complete;
 }
 
 //-----------------------------------------------------------------------------
-Item::Item(const QString& name, Item* parent, const unsigned long long size, const Type type, unsigned long long id)
-: m_name    (name)
-, m_parent  {parent}
-, m_size    {size}
-, m_type    {type}
-, m_id      {id}
-, m_visible {true}
+Item::Item(const NamePool::Handle name, Item* parent, const unsigned long long size, const Type type, unsigned long long id)
+: m_name     {name}
+, m_parent   {parent}
+, m_size     {size}
+, m_type     {type}
+, m_id       {id}
+, m_extension{0}
+, m_visible  {true}
 {
 }
 
 //-----------------------------------------------------------------------------
 QString Item::name() const
 {
-  return m_name;
+  return namePool().name(m_name);
 }
 
 //-----------------------------------------------------------------------------
 QString Item::fullName() const
 {
-  QStringList paths;
+  QString key;
+  fullName(key);
+
+  return key;
+}
+
+//-----------------------------------------------------------------------------
+void Item::fullName(QString &buffer) const
+{
+  // the path is a branch of the tree, its length is known before decoding the names from the end.
+  const auto &pool = namePool();
+  int length = 0;
+  for(auto item = this; item; item = item->m_parent)
+  {
+    if(item->m_name != NamePool::EMPTY) length += utf16Length(pool.data(item->m_name), pool.length(item->m_name)) + 1;
+  }
+
+  buffer.resize(std::max(0, length - 1));
+  auto data = buffer.data();
+  const auto delimiter = AWSUtils::DELIMITER.at(0);
+
+  auto position = buffer.length();
+  for(auto item = this; item; item = item->m_parent)
+  {
+    if(item->m_name == NamePool::EMPTY) continue;
+
+    if(position != buffer.length()) data[--position] = delimiter;
+    const auto name = pool.data(item->m_name);
+    const auto size = pool.length(item->m_name);
+    position -= utf16Length(name, size);
+    decodeUtf8(name, size, data + position);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void Item::fullName(std::string &buffer) const
+{
+  const auto &pool = namePool();
+  std::size_t length = 0;
+  for(auto item = this; item; item = item->m_parent)
+  {
+    if(item->m_name != NamePool::EMPTY) length += pool.length(item->m_name) + 1;
+  }
 
-  if(m_parent) paths << m_parent->fullName();
-  paths << name();
+  buffer.resize(std::max<std::size_t>(1, length) - 1);
+  const auto delimiter = AWSUtils::DELIMITER.toStdString().at(0);
 
-  paths.removeAll(QString(""));
+  auto position = buffer.size();
+  for(auto item = this; item; item = item->m_parent)
+  {
+    if(item->m_name == NamePool::EMPTY) continue;
 
-  return paths.join(AWSUtils::DELIMITER);
+    if(position != buffer.size()) buffer[--position] = delimiter;
+    position -= pool.length(item->m_name);
+    std::copy_n(pool.data(item->m_name), pool.length(item->m_name), &buffer[0] + position);
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -385,7 +1066,7 @@ Type Item::type() const
 }
 
 //-----------------------------------------------------------------------------
-Items Item::children()
+const Items &Item::children() const
 {
   return m_childs;
 }
@@ -411,9 +1092,8 @@ bool lessThan(const Item* lhs, const Item* rhs)
 {
   if(!lhs) return false;
   if(!rhs) return true;
-  if(lhs->type() == Type::Directory && rhs->type() != Type::Directory) return true;
-  if(lhs->type() != Type::Directory && rhs->type() == Type::Directory) return false;
-  return (lhs->name() < rhs->name());
+  if(lhs->type() != rhs->type()) return lhs->type() == Type::Directory;
+  return namePool().collate(lhs->nameHandle(), rhs->nameHandle()) < 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -423,7 +1103,8 @@ Item* find(const QString& name, Item* base)
   {
     auto children = base->children();
 
-    auto it = std::find_if(children.cbegin(), children.cend(), [&name](Item *c) { return c && (c->fullName() == name); });
+    QString key;
+    auto it = std::find_if(children.cbegin(), children.cend(), [&name, &key](Item *c) { if(c) c->fullName(key); return c && key == name; });
     if(it == children.cend())
     {
       return find(name, base->parent());
@@ -442,7 +1123,7 @@ void Item::serializeState(std::ofstream& stream) const
 {
   stream << std::to_string(m_id);                           // id
   stream << " " << (m_type == Type::Directory ? "d" : "f"); // type
-  stream << " \"" << m_name.toStdString() << "\" ";         // name
+  stream << " \"" << namePool().data(m_name) << "\" ";      // name
   stream << std::to_string(size()) << std::endl;            // size
 }
 
@@ -20,12 +20,19 @@
 #ifndef ITEMSTREE_H_
 #define ITEMSTREE_H_
 
+// Project
+#include <Model/NamePool.h>
+
 // C++
 #include <atomic>
+#include <utility>
 #include <vector>
+#include <string>
 
 // Qt
+#include <QHash>
 #include <QString>
+#include <QStringList>
 #include <QList>
 #include <QObject>
 
@@ -100,16 +107,132 @@ class ItemFactory
      */
     void deleteItem(Item *item);
 
+    /** \brief Creates in bulk the items of the given keys and their missing parent directories.
+     * Existing files are updated with the new size. Returns the created items.
+     * \param[in] directories Directory keys.
+     * \param[in] files File keys and sizes.
+     *
+     */
+    Items createItems(const std::vector<std::string> &directories, const std::vector<std::pair<std::string, unsigned long long>> &files);
+
+    /** \brief Moves in bulk the items of the given keys to their new keys, creating the missing
+     * destination directories. Directories are moved with their contents and merged with the
+     * existing ones, files replace the existing ones. Items whose key is used by an item of the
+     * other type (file or directory) are left in place. Returns false if any item was left in
+     * place and true otherwise.
+     * \param[in] moves Source and destination keys.
+     *
+     */
+    bool moveItems(const std::vector<std::pair<std::string, std::string>> &moves);
+
+    /** \brief Returns the item with the given key (full name) or nullptr if it doesn't exist.
+     * \param[in] key Item key, directories can end with the delimiter.
+     *
+     */
+    Item *itemFromKey(const QString &key);
+
+    /** \brief Returns the files with a size in the given range, in ascending order of size.
+     * \param[in] minimum Minimum size in bytes.
+     * \param[in] maximum Maximum size in bytes, included.
+     *
+     */
+    Items filesInRange(const unsigned long long minimum, const unsigned long long maximum) const;
+
+    /** \struct ExtensionStatistics
+     * \brief Number and size of the files of an extension.
+     *
+     */
+    struct ExtensionStatistics
+    {
+      QString            extension; /** extension in lower case, empty for the files without one. */
+      unsigned long long files;     /** number of files.                                           */
+      unsigned long long bytes;     /** size of the files.                                         */
+    };
+
+    /** \brief Returns the statistics of the extensions that have files.
+     *
+     */
+    std::vector<ExtensionStatistics> extensionStatistics() const;
+
+    /** \brief Returns the id of the given extension or -1 if no file has it.
+     * \param[in] extension Extension without the dot, case insensitive.
+     *
+     */
+    int extensionId(const QString &extension) const;
+
+    /** \brief Returns the extension of the given file name in lower case, or empty if it doesn't have one.
+     * \param[in] name File name.
+     *
+     */
+    static QString extensionOf(const QString &name);
+
+    /** \brief Returns the items whose name contains the given text, case insensitive. The case
+     * folded names are scanned in parallel, the buffer is rebuilt if the items have changed.
+     * \param[in] text Text to find, not empty.
+     *
+     */
+    Items findByName(const QString &text);
+
+    /** \brief Returns up to the given number of items whose names best match the given fuzzy
+     * query, best first. Equal scores are ordered by the depth of the items. The case folded names
+     * are scored in parallel, each thread keeping its best candidates.
+     * \param[in] query Space separated words in any order.
+     * \param[in] count Maximum number of results.
+     *
+     */
+    Items bestMatches(const QString &query, const std::size_t count);
+
   private:
+    using SizeEntry = std::pair<unsigned long long, Item *>;
+
+    /** \brief Returns the size index entries of the files of the given items.
+     * \param[in] items Item pointers, directories are ignored.
+     *
+     */
+    static std::vector<SizeEntry> sizeEntries(const Items &items);
+
+    /** \brief Adds the given entries to the size index in a single merge, and their files to the
+     * statistics of their extensions.
+     * \param[in] entries Size index entries.
+     *
+     */
+    void indexFiles(std::vector<SizeEntry> entries);
+
+    /** \brief Returns the id of the given extension, adding it to the dictionary if new.
+     * \param[in] extension Extension in lower case.
+     *
+     */
+    unsigned int internExtension(const QString &extension);
+
+    /** \brief Removes the given entries from the size index in a single pass, and their files from
+     * the statistics of their extensions.
+     * \param[in] entries Size index entries.
+     *
+     */
+    void unindexFiles(std::vector<SizeEntry> entries);
+
+    /** \brief Builds the buffer of the case folded names of the items.
+     *
+     */
+    void foldNames();
+
     /** \brief Returns the list of items contained in the given one.
      * \param[in] item Item object pointer.
      *
      */
     Items traverseItem(Item *item);
 
-    std::atomic<unsigned long long int> m_counter;  /** object counter.                                                  */
-    std::vector<Item *>                 m_items;    /** list of items.                                                   */
-    bool                                m_modified; /** true if items have been deleted or created from a certain point. */
+    std::atomic<unsigned long long int> m_counter;        /** object counter.                                                  */
+    std::vector<Item *>                 m_items;          /** list of items.                                                   */
+    std::vector<SizeEntry>              m_sizes;          /** files sorted by size, then by item.                              */
+    QStringList                         m_extensions;     /** extensions by id, the first one is empty.                        */
+    QHash<QString, unsigned int>        m_extensionIds;   /** extension ids by extension.                                      */
+    std::vector<ExtensionStatistics>    m_extensionStats; /** number and size of the files by extension id.                    */
+    std::string                         m_names;          /** case folded UTF-8 names separated by a null character.          */
+    std::vector<std::size_t>            m_nameOffsets;    /** offset of each name in the buffer and the buffer size.           */
+    Items                               m_nameItems;      /** item of each name in the buffer.                                 */
+    bool                                m_namesFolded;    /** true if the names buffer is up to date.                          */
+    bool                                m_modified;       /** true if items have been deleted or created from a certain point. */
 };
 
 class Item
@@ -122,16 +245,43 @@ class Item
      */
     QString name() const;
 
+    /** \brief Returns the handle of the item name in the names pool. Items with equal names have
+     * equal handles.
+     *
+     */
+    NamePool::Handle nameHandle() const
+    { return m_name; }
+
     /** \brief Returns the item full name (path + name).
      *
      */
     QString fullName() const;
 
+    /** \brief Writes the item full name (path + name) to the given buffer. The buffer isn't
+     * reallocated if its capacity is enough, so it can be reused for many items.
+     * \param[out] buffer Full name buffer.
+     *
+     */
+    void fullName(QString &buffer) const;
+
+    /** \brief Writes the item full name (path + name) in UTF-8 to the given buffer. The buffer
+     * isn't reallocated if its capacity is enough, so it can be reused for many items.
+     * \param[out] buffer Full name buffer.
+     *
+     */
+    void fullName(std::string &buffer) const;
+
     /** \brief Returns the item size.
      *
      */
     unsigned long long size() const;
 
+    /** \brief Returns the size of the object of a file, even if it's hidden by the filter. 0 if a directory.
+     *
+     */
+    unsigned long long objectSize() const
+    { return m_type == Type::File ? m_size : 0; }
+
     /** \brief Returns the item parent or null if root item.
      *
      */
@@ -145,7 +295,7 @@ class Item
     /** \brief Returns the items inside this item. Or empty if it's a file.
      *
      */
-    Items children();
+    const Items &children() const;
 
     /** \brief Adds an item to the children list.
      * \param[in] child Item to add.
@@ -164,6 +314,13 @@ class Item
      */
     long long int id() const;
 
+    /** \brief Returns the id of the extension of a file in the factory dictionary, 0 if it doesn't
+     * have one or if a directory.
+     *
+     */
+    unsigned int extension() const
+    { return m_extension; }
+
     /** \brief Returns the number of files in the item and subitems. 1 if a file.
      *
      */
@@ -193,14 +350,14 @@ class Item
 
   private:
     /** \brief Item class constructor.
-     * \param[in] name Item name.
+     * \param[in] name Handle of the item name in the names pool.
      * \param[in] parent Pointer to parent item.
      * \param[in] size Item size.
      * \param[in] type Item type.
      * \param[in] id Item id.
      *
      */
-    explicit Item(const QString &name, Item *parent, const unsigned long long size, const Type type, unsigned long long id);
+    explicit Item(const NamePool::Handle name, Item *parent, const unsigned long long size, const Type type, unsigned long long id);
 
     /** \brief Item class destructor.
      *
@@ -222,16 +379,18 @@ class Item
 
     friend class ItemFactory;
 
-    QString             m_name;     /** item name.                        */
-    Item               *m_parent;   /** pointer to item parent.           */
-    unsigned long long  m_size;     /** item size.                        */
-    Type                m_type;     /** item type.                        */
-    std::vector<Item *> m_childs;   /** list of children items.           */
-    unsigned long long  m_id;       /** item id.                          */
-    bool                m_visible;  /** true if visible, false otherwise. */
+    NamePool::Handle    m_name;      /** handle of the item name.          */
+    Item               *m_parent;    /** pointer to item parent.           */
+    unsigned long long  m_size;      /** item size.                        */
+    Type                m_type;      /** item type.                        */
+    std::vector<Item *> m_childs;    /** list of children items.           */
+    unsigned long long  m_id;        /** item id.                          */
+    unsigned int        m_extension; /** id of the extension of a file.    */
+    bool                m_visible;   /** true if visible, false otherwise. */
 };
 
-/** \brief Less than method for sorting. Returns true if lhs < rhs.
+/** \brief Less than method for sorting. Returns true if lhs < rhs. Directories go first and the
+ * names are ordered by their collation keys in the names pool.
  * \param[in] lhs Item pointer.
  * \param[in] rhs Item pointer.
  *
@@ -0,0 +1,264 @@
+/*
+ File: NamePool.cpp
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Project
+#include <Model/NamePool.h>
+
+// C++
+#include <algorithm>
+#include <cstring>
+
+// number of slots of the table of a new pool, a power of two.
+const std::size_t INITIAL_SLOTS = 1024;
+
+// maximum number of significant digits of a number in a collation key, longer ones are split.
+const std::size_t MAX_KEY_DIGITS = 254;
+
+// size of the blocks of the keys, longer keys get a block of their own.
+const std::size_t BLOCK_SIZE = 1024 * 1024;
+
+const NamePool::Handle NamePool::NOT_FOUND;
+const NamePool::Handle NamePool::EMPTY;
+const unsigned int NamePool::SEGMENT_BITS;
+const NamePool::Handle NamePool::SEGMENT_MASK;
+
+//-----------------------------------------------------------------------------
+NamePool::NamePool()
+: m_segments {new std::unique_ptr<Entry[]>[(static_cast<std::size_t>(NOT_FOUND) >> SEGMENT_BITS) + 1]}
+, m_free     {nullptr}
+, m_available{0}
+, m_size     {0}
+, m_table    (INITIAL_SLOTS, NOT_FOUND)
+{
+  // the empty name has the handle 0.
+  intern("", 0);
+}
+
+//-----------------------------------------------------------------------------
+NamePool::Handle NamePool::intern(const QString &name)
+{
+  const auto bytes = name.toUtf8();
+
+  return intern(bytes.constData(), bytes.size());
+}
+
+//-----------------------------------------------------------------------------
+NamePool::Handle NamePool::intern(const char *name, const std::size_t length)
+{
+  const auto nameHash = hash(name, length);
+  const auto position = slot(name, length, nameHash);
+  if(m_table[position] != NOT_FOUND) return m_table[position];
+
+  const auto handle = static_cast<Handle>(m_size);
+  auto &segment = m_segments[handle >> SEGMENT_BITS];
+  if(!segment) segment.reset(new Entry[SEGMENT_MASK + 1]);
+
+  // the segments and the blocks are never moved, so the names of the existing handles can be read
+  // while this one is stored.
+  const auto key = collationKey(name, length);
+  const auto storage = allocate(key.size() + 1);
+  std::memcpy(storage, key.c_str(), key.size() + 1);
+
+  auto &stored = segment[handle & SEGMENT_MASK];
+  stored.key       = storage;
+  stored.keyLength = static_cast<std::uint32_t>(key.size());
+  stored.length    = static_cast<std::uint32_t>(length);
+  stored.hash      = nameHash;
+  ++m_size;
+
+  m_table[position] = handle;
+
+  // the table is kept at most half full so the probes are short.
+  if(2 * size() > m_table.size()) grow();
+
+  return handle;
+}
+
+//-----------------------------------------------------------------------------
+char *NamePool::allocate(const std::size_t bytes)
+{
+  if(bytes > BLOCK_SIZE)
+  {
+    m_blocks.emplace_back(new char[bytes]);
+    const auto storage = m_blocks.back().get();
+
+    // keep filling the current block.
+    if(m_blocks.size() > 1) std::swap(m_blocks.back(), m_blocks[m_blocks.size() - 2]);
+
+    return storage;
+  }
+
+  if(bytes > m_available)
+  {
+    m_blocks.emplace_back(new char[BLOCK_SIZE]);
+    m_free      = m_blocks.back().get();
+    m_available = BLOCK_SIZE;
+  }
+
+  const auto storage = m_free;
+  m_free      += bytes;
+  m_available -= bytes;
+
+  return storage;
+}
+
+//-----------------------------------------------------------------------------
+NamePool::Handle NamePool::find(const QString &name) const
+{
+  const auto bytes = name.toUtf8();
+
+  return find(bytes.constData(), bytes.size());
+}
+
+//-----------------------------------------------------------------------------
+NamePool::Handle NamePool::find(const char *name, const std::size_t length) const
+{
+  return m_table[slot(name, length, hash(name, length))];
+}
+
+//-----------------------------------------------------------------------------
+std::size_t NamePool::slot(const char *name, const std::size_t length, const std::size_t nameHash) const
+{
+  const auto mask = m_table.size() - 1;
+  auto position = nameHash & mask;
+  while(m_table[position] != NOT_FOUND)
+  {
+    const auto handle = m_table[position];
+    const auto &stored = entry(handle);
+    if(stored.hash == nameHash && stored.length == length && std::memcmp(data(handle), name, length) == 0) break;
+
+    position = (position + 1) & mask;
+  }
+
+  return position;
+}
+
+//-----------------------------------------------------------------------------
+void NamePool::grow()
+{
+  std::vector<Handle> table(2 * m_table.size(), NOT_FOUND);
+  const auto mask = table.size() - 1;
+
+  for(Handle handle = 0; handle < m_size; ++handle)
+  {
+    auto position = entry(handle).hash & mask;
+    while(table[position] != NOT_FOUND) position = (position + 1) & mask;
+    table[position] = handle;
+  }
+
+  m_table.swap(table);
+}
+
+//-----------------------------------------------------------------------------
+int NamePool::compare(const Handle lhs, const Handle rhs) const
+{
+  if(lhs == rhs) return 0;
+
+  const auto lhsLength = length(lhs);
+  const auto rhsLength = length(rhs);
+
+  const auto result = std::memcmp(data(lhs), data(rhs), std::min(lhsLength, rhsLength));
+  if(result != 0) return result;
+
+  return lhsLength < rhsLength ? -1 : (lhsLength == rhsLength ? 0 : 1);
+}
+
+//-----------------------------------------------------------------------------
+int NamePool::collate(const Handle lhs, const Handle rhs) const
+{
+  if(lhs == rhs) return 0;
+
+  const auto &lhsEntry = entry(lhs);
+  const auto &rhsEntry = entry(rhs);
+  const auto lhsLength = lhsEntry.keyLength;
+  const auto rhsLength = rhsEntry.keyLength;
+
+  const auto result = std::memcmp(lhsEntry.key, rhsEntry.key, std::min(lhsLength, rhsLength));
+  if(result != 0) return result;
+
+  return lhsLength < rhsLength ? -1 : (lhsLength == rhsLength ? 0 : 1);
+}
+
+//-----------------------------------------------------------------------------
+std::string NamePool::collationKey(const char *name, const std::size_t length)
+{
+  std::string key;
+
+  // ASCII names are folded here, the rest by Qt.
+  std::string folded(name, length);
+  if(std::all_of(folded.cbegin(), folded.cend(), [](const char c) { return (c & 0x80) == 0; }))
+  {
+    std::transform(folded.begin(), folded.end(), folded.begin(), [](const char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; });
+  }
+  else
+  {
+    folded = QString::fromUtf8(name, static_cast<int>(length)).toCaseFolded().toUtf8().toStdString();
+  }
+
+  // numbers are written as '0', the number of significant digits plus one and the digits, so
+  // longer numbers come later and numbers stay before letters. The key never has a null.
+  auto isDigit = [](const char c) { return c >= '0' && c <= '9'; };
+  for(std::size_t i = 0; i < folded.size();)
+  {
+    if(!isDigit(folded[i]))
+    {
+      key += folded[i++];
+      continue;
+    }
+
+    while(i + 1 < folded.size() && folded[i] == '0' && isDigit(folded[i + 1])) ++i;
+    if(folded[i] == '0') ++i;
+
+    std::size_t digits = 0;
+    while(i + digits < folded.size() && digits < MAX_KEY_DIGITS && isDigit(folded[i + digits])) ++digits;
+
+    key += '0';
+    key += static_cast<char>(digits + 1);
+    key.append(folded, i, digits);
+    i += digits;
+  }
+
+  // names with equal keys are ordered by their bytes.
+  key += '\0';
+  key.append(name, length);
+
+  return key;
+}
+
+//-----------------------------------------------------------------------------
+std::size_t NamePool::hash(const char *name, const std::size_t length)
+{
+  // FNV-1a of the bytes.
+  std::uint64_t hash = 14695981039346656037ULL;
+  for(std::size_t i = 0; i < length; ++i)
+  {
+    hash ^= static_cast<unsigned char>(name[i]);
+    hash *= 1099511628211ULL;
+  }
+
+  return static_cast<std::size_t>(hash);
+}
+
+//-----------------------------------------------------------------------------
+NamePool &namePool()
+{
+  static NamePool pool;
+
+  return pool;
+}
@@ -0,0 +1,205 @@
+/*
+ File: NamePool.h
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NAMEPOOL_H_
+#define NAMEPOOL_H_
+
+// C++
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Qt
+#include <QString>
+
+/** \class NamePool
+ * \brief Deduplicated UTF-8 storage of the item names. Each distinct name is stored once and
+ * referenced by a 32-bit handle, so equal names have equal handles. Names are never removed.
+ * The collation key of each name is computed when interned, so names can be ordered with a
+ * memcmp. The names are stored in blocks that never move, so the names of the handles already
+ * obtained can be read from any thread while other names are interned. Interning and finding
+ * names aren't thread safe and must be done from a single thread.
+ *
+ */
+class NamePool
+{
+  public:
+    using Handle = std::uint32_t;
+
+    /** \brief Handle returned when a name isn't in the pool.
+     *
+     */
+    static const Handle NOT_FOUND = static_cast<Handle>(-1);
+
+    /** \brief Handle of the empty name.
+     *
+     */
+    static const Handle EMPTY = 0;
+
+    /** \brief NamePool class constructor.
+     *
+     */
+    NamePool();
+
+    NamePool(const NamePool &) = delete;
+    NamePool &operator=(const NamePool &) = delete;
+
+    /** \brief Returns the handle of the given name, adding it to the pool if new.
+     * \param[in] name Item name.
+     *
+     */
+    Handle intern(const QString &name);
+
+    /** \brief Returns the handle of the given UTF-8 name, adding it to the pool if new.
+     * \param[in] name UTF-8 item name.
+     * \param[in] length Length of the name in bytes.
+     *
+     */
+    Handle intern(const char *name, const std::size_t length);
+
+    /** \brief Returns the handle of the given name or NOT_FOUND if it isn't in the pool.
+     * \param[in] name Item name.
+     *
+     */
+    Handle find(const QString &name) const;
+
+    /** \brief Returns the handle of the given UTF-8 name or NOT_FOUND if it isn't in the pool.
+     * \param[in] name UTF-8 item name.
+     * \param[in] length Length of the name in bytes.
+     *
+     */
+    Handle find(const char *name, const std::size_t length) const;
+
+    /** \brief Returns the name of the given handle converted to UTF-16.
+     * \param[in] handle Name handle.
+     *
+     */
+    QString name(const Handle handle) const
+    { return QString::fromUtf8(data(handle), static_cast<int>(length(handle))); }
+
+    /** \brief Returns the UTF-8 bytes of the name of the given handle, null terminated.
+     * \param[in] handle Name handle.
+     *
+     */
+    const char *data(const Handle handle) const
+    { const auto &e = entry(handle); return e.key + e.keyLength - e.length; }
+
+    /** \brief Returns the length in bytes of the name of the given handle.
+     * \param[in] handle Name handle.
+     *
+     */
+    std::size_t length(const Handle handle) const
+    { return entry(handle).length; }
+
+    /** \brief Compares the UTF-8 bytes of the names of the given handles, returns a negative
+     * value, zero or a positive value if lhs is less, equal or greater than rhs.
+     * \param[in] lhs Name handle.
+     * \param[in] rhs Name handle.
+     *
+     */
+    int compare(const Handle lhs, const Handle rhs) const;
+
+    /** \brief Compares the collation keys of the names of the given handles. Names are ordered
+     * case insensitive and the numbers in them by their value, the names with equal keys are
+     * ordered by their bytes. Returns a negative value, zero or a positive value if lhs is less,
+     * equal or greater than rhs.
+     * \param[in] lhs Name handle.
+     * \param[in] rhs Name handle.
+     *
+     */
+    int collate(const Handle lhs, const Handle rhs) const;
+
+    /** \brief Returns the number of names in the pool. Must be called from the interning thread.
+     *
+     */
+    std::size_t size() const
+    { return m_size; }
+
+  private:
+    /** \brief Stored name. The key is the collation key followed by a null and the name, so the
+     * name is the end of the key.
+     *
+     */
+    struct Entry
+    {
+      const char    *key;       /** collation key, null terminated.        */
+      std::uint32_t  keyLength; /** length of the key in bytes.            */
+      std::uint32_t  length;    /** length of the name in bytes.           */
+      std::size_t    hash;      /** hash of the name.                      */
+    };
+
+    /** \brief Returns the entry of the given handle.
+     * \param[in] handle Name handle.
+     *
+     */
+    const Entry &entry(const Handle handle) const
+    { return m_segments[handle >> SEGMENT_BITS][handle & SEGMENT_MASK]; }
+
+    static const unsigned int SEGMENT_BITS = 16;                          /** log2 of the entries of a segment.    */
+    static const Handle       SEGMENT_MASK = (1u << SEGMENT_BITS) - 1;    /** mask of the entry in its segment.    */
+
+    /** \brief Returns the FNV-1a hash of the given bytes.
+     * \param[in] name UTF-8 name.
+     * \param[in] length Length of the name in bytes.
+     *
+     */
+    static std::size_t hash(const char *name, const std::size_t length);
+
+    /** \brief Returns the slot of the table with the handle of the given name, or the empty slot
+     * where it would be inserted if it isn't in the pool.
+     * \param[in] name UTF-8 name.
+     * \param[in] length Length of the name in bytes.
+     * \param[in] nameHash Hash of the name.
+     *
+     */
+    std::size_t slot(const char *name, const std::size_t length, const std::size_t nameHash) const;
+
+    /** \brief Doubles the size of the table and inserts the handles again.
+     *
+     */
+    void grow();
+
+    /** \brief Returns the collation key of the given name followed by a null and the name.
+     * \param[in] name UTF-8 name.
+     * \param[in] length Length of the name in bytes.
+     *
+     */
+    static std::string collationKey(const char *name, const std::size_t length);
+
+    /** \brief Returns storage for the given number of bytes, that never moves.
+     * \param[in] bytes Number of bytes.
+     *
+     */
+    char *allocate(const std::size_t bytes);
+
+    std::unique_ptr<std::unique_ptr<Entry[]>[]> m_segments;  /** entries of the names by segment.                   */
+    std::vector<std::unique_ptr<char[]>>        m_blocks;    /** storage of the keys.                                */
+    char                                       *m_free;      /** first unused byte of the last block.               */
+    std::size_t                                 m_available; /** unused bytes of the last block.                    */
+    std::size_t                                 m_size;      /** number of names.                                    */
+    std::vector<Handle>                         m_table;     /** open addressing table of the handles, NOT_FOUND if empty. */
+};
+
+/** \brief Returns the pool of the names of the items.
+ *
+ */
+NamePool &namePool();
+
+#endif // NAMEPOOL_H_
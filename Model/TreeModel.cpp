@@ -19,6 +19,7 @@
 
 // Project
 #include <Model/TreeModel.h>
+#include <Utils/ParallelUtils.h>
 
 // Qt
 #include <QApplication>
@@ -26,6 +27,9 @@
 // C++
 #include <cassert>
 
+// number of items matched by a thread at once when filtering.
+const std::size_t FILTER_CHUNK_SIZE = 4096;
+
 //-----------------------------------------------------------------------------
 TreeModel::TreeModel(ItemFactory *factory, QObject* parent)
 : QAbstractItemModel(parent)
@@ -177,7 +181,9 @@ void TreeModel::createSubdirectory(Item* parent, const QString &name)
   auto children = parent->children();
   const auto childrenSize = parent->childrenCount();
   int row = 0;
-  std::for_each(children.cbegin(), children.cend(), [&row, name](const Item *i) { if(i->isVisible() && i->name() < name) ++row; });
+  const auto handle = namePool().intern(name);
+  auto before = [handle](const Item *i) { return isDirectory(i) && namePool().collate(i->nameHandle(), handle) < 0; };
+  std::for_each(children.cbegin(), children.cend(), [&row, &before](const Item *i) { if(i->isVisible() && before(i)) ++row; });
 
   beginInsertRows(idx, row, row);
 
@@ -214,19 +220,68 @@ void TreeModel::removeItems(Items items)
 }
 
 //-----------------------------------------------------------------------------
-void TreeModel::setFilter(const QString& text)
+void TreeModel::setFilter(const Filter &filter)
 {
-  if(m_filter != text)
+  if(!(m_filter == filter))
   {
-    m_filter = text;
+    m_filter = filter;
 
-    auto items = m_factory->items();
+    const auto &items = m_factory->items();
 
     beginResetModel();
 
     std::for_each(items.begin(), items.end(), [](Item *i) {if(i) i->setVisible(false); });
 
-    std::for_each(items.begin(), items.end(), [text](Item *i) { if(i) i->setVisible(text.isEmpty() || i->name().contains(text, Qt::CaseInsensitive)); });
+    if(!filter.filesOnly() && !filter.fullKey && filter.syntax == PatternUtils::Syntax::Text && !filter.text.isEmpty())
+    {
+      // plain name searches scan the case folded names buffer of the factory.
+      const auto found = m_factory->findByName(filter.text);
+      std::for_each(found.cbegin(), found.cend(), [](Item *i) { i->setVisible(true); });
+    }
+    else
+    {
+      // only the files in the size range are candidates of a files filter.
+      const auto id = filter.extension.isEmpty() ? -1 : m_factory->extensionId(filter.extension);
+      Items candidates;
+      if(filter.filesOnly())
+      {
+        if(filter.extension.isEmpty() || id != -1) candidates = m_factory->filesInRange(filter.minimum, filter.maximum);
+      }
+
+      const auto &subjects = filter.filesOnly() ? candidates : items;
+
+      // the pattern isn't shared between threads, each one compiles its own.
+      std::vector<PatternUtils::Pattern> patterns;
+      for(std::size_t i = 0; i < ParallelUtils::threadsCount(); ++i) patterns.emplace_back(filter.text, filter.syntax);
+
+      // extension ids are compared before the text, the visibility is set serially as it changes the parents.
+      std::vector<char> matched(subjects.size(), 0);
+      auto matchChunk = [&](const std::size_t first, const std::size_t last, const std::size_t thread)
+      {
+        const auto &pattern = patterns[thread];
+        QString key;
+        for(auto i = first; i < last; ++i)
+        {
+          const auto item = subjects[i];
+          if(!item || (id != -1 && item->extension() != static_cast<unsigned int>(id))) continue;
+          if(filter.text.isEmpty())
+          {
+            matched[i] = true;
+            continue;
+          }
+
+          // the keys are written to the same buffer.
+          if(filter.fullKey) item->fullName(key);
+          matched[i] = pattern.matches(filter.fullKey ? key : item->name());
+        }
+      };
+      ParallelUtils::runChunked(subjects.size(), FILTER_CHUNK_SIZE, matchChunk);
+
+      for(std::size_t i = 0; i < subjects.size(); ++i)
+      {
+        if(matched[i]) subjects[i]->setVisible(true);
+      }
+    }
 
     endResetModel();
   }
@@ -254,6 +309,13 @@ void TreeModel::addItems(Items items)
   std::for_each(items.begin(), items.end(), [this](Item *i) { addItem(i); });
 }
 
+//-----------------------------------------------------------------------------
+void TreeModel::refresh()
+{
+  beginResetModel();
+  endResetModel();
+}
+
 //-----------------------------------------------------------------------------
 Item* TreeModel::findVisibleItem(Item *parent, int row) const
 {
@@ -22,6 +22,10 @@
 
 // Project
 #include <Model/ItemsTree.h>
+#include <Utils/PatternUtils.h>
+
+// C++
+#include <limits>
 
 // Qt
 #include <QAbstractItemModel>
@@ -96,10 +100,60 @@ class TreeModel
      */
     void addItems(Items items);
 
-    /** \brief Set the text to filter by name.
-     * \param[in] text Text string.
+    /** \brief Notifies the views that the items have been modified in bulk outside the model.
+     *
+     */
+    void refresh();
+
+    /** \struct Filter
+     * \brief Conditions of the visible items. With a size range or an extension only the files
+     * that match them and whose name or key matches the text are shown.
+     *
+     */
+    struct Filter
+    {
+      QString              text;      /** pattern of the names or keys.                       */
+      PatternUtils::Syntax syntax;    /** syntax of the text.                                 */
+      bool                 fullKey;   /** true to match the full keys, false for the names.   */
+      unsigned long long   minimum;   /** minimum size of the visible files.                  */
+      unsigned long long   maximum;   /** maximum size of the visible files, included.        */
+      QString              extension; /** extension of the visible files, empty for any item. */
+
+      /** \brief Filter struct constructor.
+       *
+       */
+      Filter()
+      : syntax{PatternUtils::Syntax::Text}, fullKey{false}, minimum{0}, maximum{std::numeric_limits<unsigned long long>::max()}
+      {}
+
+      /** \brief Returns true if the filter only shows files.
+       *
+       */
+      bool filesOnly() const
+      { return minimum != 0 || maximum != std::numeric_limits<unsigned long long>::max() || !extension.isEmpty(); }
+
+      /** \brief Returns true if the filter shows every item.
+       *
+       */
+      bool isEmpty() const
+      { return text.isEmpty() && !filesOnly(); }
+
+      bool operator==(const Filter &other) const
+      { return text == other.text && syntax == other.syntax && fullKey == other.fullKey && minimum == other.minimum && maximum == other.maximum && extension == other.extension; }
+    };
+
+    /** \brief Sets the filter of the items. The pattern is compiled once and the items are
+     * matched in parallel.
+     * \param[in] filter Filter conditions, the pattern of the text must be valid.
+     *
+     */
+    void setFilter(const Filter &filter);
+
+    /** \brief Returns the current filter.
+     *
      */
-    void setFilter(const QString &text);
+    const Filter &filter() const
+    { return m_filter; }
 
     /** \brief Returns the index of the given item.
      * \param[in] item Item pointer.
@@ -113,9 +167,9 @@ class TreeModel
      */
     Item *findVisibleItem(Item *parent, int row) const;
 
-    ItemFactory      *m_factory;      /** Item factory object. */
-    QFileIconProvider m_iconProvider; /** icons provider.      */
-    QString           m_filter;       /** text to filter by.   */
+    ItemFactory       *m_factory;      /** Item factory object. */
+    QFileIconProvider  m_iconProvider; /** icons provider.      */
+    Filter             m_filter;       /** current filter.      */
 };
 
 #endif // TREEMODEL_H_
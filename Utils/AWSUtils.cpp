@@ -19,9 +19,20 @@
 
 // Project
 #include <Utils/AWSUtils.h>
+#include <Utils/TransferUtils.h>
+#include <Utils/CacheUtils.h>
 
 // C++
 #include <winsock2.h>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <list>
+#include <set>
+#include <thread>
 
 // AWS
 #include <aws/core/Aws.h>
@@ -29,14 +40,28 @@
 #include <aws/core/utils/logging/DefaultLogSystem.h>
 #include <aws/core/utils/threading/ThreadTask.h>
 #include <aws/core/client/ClientConfiguration.h>
+#include <aws/core/client/DefaultRetryStrategy.h>
+#include <aws/core/http/HttpResponse.h>
 #include <aws/core/utils/memory/stl/AWSAllocator.h>
+#include <aws/core/utils/memory/stl/AWSStreamFwd.h>
+#include <aws/core/utils/StringUtils.h>
 #include <aws/s3/S3Client.h>
+#include <aws/s3/model/AbortMultipartUploadRequest.h>
+#include <aws/s3/model/CompleteMultipartUploadRequest.h>
+#include <aws/s3/model/CopyObjectRequest.h>
+#include <aws/s3/model/CreateMultipartUploadRequest.h>
 #include <aws/s3/model/DeleteObjectRequest.h>
+#include <aws/s3/model/DeleteObjectsRequest.h>
+#include <aws/s3/model/HeadObjectRequest.h>
+#include <aws/s3/model/UploadPartCopyRequest.h>
 #include <aws/s3/model/Object.h>
 #include <aws/transfer/TransferHandle.h>
 
 // Qt
 #include <QFileInfo>
+#include <QFile>
+#include <QDateTime>
+#include <QCryptographicHash>
 #include <QApplication>
 #include <QDir>
 
@@ -45,256 +70,1413 @@ using namespace Aws::Transfer;
 
 static const char *ALLOCATION_TAG = "SuperDuckTransfer";
 
+// threads walking the directories of an upload.
+const unsigned int SCAN_THREADS = 4;
+
+// threads comparing local files and objects in sync mode.
+const unsigned int SYNC_THREADS = 8;
+
+// files of a directory upload compared at the same time in sync mode.
+const std::size_t SYNC_BATCH = 512;
+
+// maximum number of objects downloading at the same time in an operation.
+const std::size_t DOWNLOAD_WINDOW = 16;
+
+// threads creating the local directories of a download.
+const unsigned int DIRECTORY_THREADS = 8;
+
+// size of the parts of the multipart transfers, also used for the multipart ETags.
+const unsigned long long PART_SIZE = 5*1024*1024;
+
+// interval in milliseconds between progress samples.
+const int SAMPLE_INTERVAL = 500;
+
+// maximum number of part buffers of the transfer manager of an operation.
+const unsigned long long TRANSFER_BUFFERS = 16;
+
+// objects being copied inside the bucket at the same time in a move.
+const unsigned int COPY_THREADS = 16;
+
+// maximum size of an object copied with a single request.
+const unsigned long long COPY_LIMIT = 5ULL*1024*1024*1024;
+
+// minimum size of the parts of a multipart copy.
+const unsigned long long COPY_PART_SIZE = 512*1024*1024;
+
+// maximum number of parts of a multipart upload.
+const unsigned long long MAX_PARTS = 10000;
+
+// maximum number of keys of a DeleteObjects request.
+const std::size_t DELETE_BATCH = 1000;
+
+// number of threads requesting the ETags of the cached objects.
+const unsigned int CACHE_THREADS = 8;
+
+static std::mutex   s_loggingMutex;   /** protects the logging counter.                 */
+static unsigned int s_loggingCount{0}; /** number of operations using the AWS SDK logging. */
+
+//-----------------------------------------------------------------------------
+static Aws::String copySource(const Aws::String &bucket, const Aws::String &key)
+{
+  // each part of the key is encoded, the delimiters must be kept.
+  Aws::String source = bucket;
+  std::size_t begin = 0;
+  std::size_t end;
+  do
+  {
+    end = key.find('/', begin);
+    source += "/" + Aws::Utils::StringUtils::URLEncode(key.substr(begin, end == Aws::String::npos ? end : end - begin).c_str());
+    begin = end + 1;
+  }
+  while(end != Aws::String::npos);
+
+  return source;
+}
+
 //-----------------------------------------------------------------------------
 AWSUtils::S3Thread::S3Thread(Operation operation, QObject* parent)
 : QThread(parent)
 , m_operation(operation)
-, m_abort{false}
 , m_fileCount{0}
+, m_retries{0}
+, m_retriesTime{0}
+, m_skipped{0}
+, m_cacheHits{0}
+, m_generator{std::random_device()()}
 {
+  m_sampler.setInterval(SAMPLE_INTERVAL);
+
+  connect(this, SIGNAL(started()), &m_sampler, SLOT(start()));
+  connect(this, SIGNAL(finished()), &m_sampler, SLOT(stop()));
+  connect(this, SIGNAL(finished()), this, SLOT(onSampleTimeout()));
+  connect(&m_sampler, SIGNAL(timeout()), this, SLOT(onSampleTimeout()));
 }
 
 //-----------------------------------------------------------------------------
 void AWSUtils::S3Thread::run()
 {
-  if(m_operation.useLogging)
-  {
-    Utils::Logging::InitializeAWSLogging(MakeShared<Utils::Logging::DefaultLogSystem>(ALLOCATION_TAG, Utils::Logging::LogLevel::Trace, "aws_sdk_"));
-  }
+  if(m_operation.useLogging) initializeLogging();
 
-  SDKOptions options;
-  InitAPI(options);
-  {
-    Aws::Client::ClientConfiguration clientConfig;
-    clientConfig.region = m_operation.region;
-    clientConfig.connectTimeoutMs = 30000;
-    clientConfig.requestTimeoutMs = 30000;
+  Aws::Client::ClientConfiguration clientConfig;
+  clientConfig.region = m_operation.region;
+  clientConfig.connectTimeoutMs = 30000;
+  clientConfig.requestTimeoutMs = 30000;
+  clientConfig.writeRateLimiter = TransferUtils::uploadLimiter();
+  clientConfig.readRateLimiter  = TransferUtils::downloadLimiter();
+
+  // failed requests are retried only by the retry policy, the SDK would retry them again on each attempt.
+  clientConfig.retryStrategy = Aws::MakeShared<Aws::Client::DefaultRetryStrategy>(ALLOCATION_TAG, 0);
 
-    auto executor  = Aws::MakeShared<Aws::Utils::Threading::PooledThreadExecutor>(ALLOCATION_TAG, 4);
-    auto s3_client = Aws::MakeShared<Aws::S3::S3Client>(ALLOCATION_TAG, m_operation.credentials, clientConfig);
+  auto executor  = m_executor;
+  if(!executor) executor = Aws::MakeShared<Aws::Utils::Threading::PooledThreadExecutor>(ALLOCATION_TAG, 4);
+  auto s3_client = Aws::MakeShared<Aws::S3::S3Client>(ALLOCATION_TAG, m_operation.credentials, clientConfig);
 
-    int progressValue = 0;
-    int globalProgressValue = 0;
-    QString fileNameKey;
+  int globalProgressValue = 0;
 
-    if(m_operation.type == AWSUtils::OperationType::remove)
+  // requests in progress stop as soon as the operation is cancelled.
+  auto continueRequest = [this](const Aws::Http::HttpRequest *) { return !m_token.isCancelled(); };
+
+  if(m_operation.type == AWSUtils::OperationType::remove)
+  {
+    m_tracker.addTotal(m_operation.keys.size(), 0);
+
+    unsigned int count = 0;
+    for(auto it = m_operation.keys.cbegin(); it != m_operation.keys.cend() && !m_token.isCancelled(); ++it)
     {
-      unsigned int count = 0;
-      for(auto it = m_operation.keys.cbegin(); it != m_operation.keys.cend() && !m_abort; ++it)
-      {
-        auto p = *it;
-        auto shortName = QFileInfo(QString::fromStdString(p.first)).fileName();
-        emit message(operationTypeToText(m_operation.type) + " '" + shortName + "'");
+      auto p = *it;
+      auto shortName = QFileInfo(QString::fromStdString(p.first)).fileName();
+      emit message(operationTypeToText(m_operation.type) + " '" + shortName + "'");
 
-        auto filename = Aws::String(p.first.c_str(), p.first.length());
+      auto filename = Aws::String(p.first.c_str(), p.first.length());
 
-        Aws::S3::Model::DeleteObjectRequest object_request;
-        object_request.WithBucket(m_operation.bucket).WithKey(filename);
+      Aws::S3::Model::DeleteObjectRequest object_request;
+      object_request.WithBucket(m_operation.bucket).WithKey(filename);
+      object_request.SetContinueRequestHandler(continueRequest);
 
-        auto result = s3_client->DeleteObject(object_request);
+      auto result = s3_client->DeleteObject(object_request);
 
-        if(m_abort) break;
+      unsigned int attempt = 0;
+      while(!result.IsSuccess() && !m_token.isCancelled() && retry(result.GetError(), attempt++))
+      {
+        result = s3_client->DeleteObject(object_request);
+      }
 
-        if (!result.IsSuccess())
-        {
-          const auto error = result.GetError();
-          auto exceptionName = AWSUtils::toQString(error.GetExceptionName());
-          auto errorMessage = AWSUtils::toQString(error.GetMessage());
-          m_errors[QString::fromStdString(p.first)] << exceptionName + " -> " + errorMessage;
-        }
+      if(m_token.isCancelled()) break;
 
-        int pValue = (++count * 100)/m_operation.keys.size();
-        if(progressValue != pValue)
-        {
-          progressValue = pValue;
-          emit globalProgress(progressValue);
-        }
+      if (!result.IsSuccess())
+      {
+        addError(p.first, result.GetError());
+      }
+      else
+      {
+        m_completed.push_back(p);
+      }
+
+      m_tracker.finish(0);
+
+      int pValue = (++count * 100)/m_operation.keys.size();
+      if(globalProgressValue != pValue)
+      {
+        globalProgressValue = pValue;
+        emit globalProgress(globalProgressValue);
       }
     }
-    else
+  }
+  else if(m_operation.type == AWSUtils::OperationType::move)
+  {
+    moveObjects(s3_client);
+  }
+  else
+  {
+    // called from the executor threads, only updates the counters of the transfer.
+    auto transferCallback = [](const TransferManager *tm, const std::shared_ptr<const TransferHandle> &th)
+    {
+      auto counters = static_cast<const TransferUtils::TransferProgress *>(th->GetContext().get());
+      if(counters) counters->update(th->GetBytesTransferred(), th->GetBytesTotalSize());
+    };
+
+    // wakes up the transfers loop when a transfer changes its status.
+    std::mutex statusMutex;
+    std::condition_variable statusCondition;
+    bool statusChanged = false;
+    auto statusCallback = [&](const TransferManager *tm, const std::shared_ptr<const TransferHandle> &th)
+    {
+      std::lock_guard<std::mutex> lock(statusMutex);
+      statusChanged = true;
+      statusCondition.notify_one();
+    };
+
+    TransferManagerConfiguration transferManagerConfig(executor.get());
+    transferManagerConfig.s3Client = s3_client;
+    transferManagerConfig.downloadProgressCallback = transferCallback;
+    transferManagerConfig.uploadProgressCallback = transferCallback;
+    transferManagerConfig.transferStatusUpdatedCallback = statusCallback;
+    transferManagerConfig.bufferSize = PART_SIZE;
+
+    // the part buffers come from the memory budget shared by all the operations, waits for
+    // other operations if there isn't enough. Must outlive the transfer manager.
+    auto memory = TransferUtils::bufferPool()->reserve(PART_SIZE, PART_SIZE * TRANSFER_BUFFERS, m_token);
+    transferManagerConfig.transferBufferMaxHeapSize = std::max(PART_SIZE, memory->bytes());
+
+    auto manager = TransferManager::Create(transferManagerConfig);
+
+    // cancels the transfers in progress, their requests stop on the next block of data.
+    TransferUtils::CancellationScope cancelTransfers(m_token, [&]()
+    {
+      manager->CancelAll();
+
+      std::lock_guard<std::mutex> lock(statusMutex);
+      statusChanged = true;
+      statusCondition.notify_one();
+    });
+
+    if(m_operation.type == AWSUtils::OperationType::download)
     {
-      auto transferCallback = [&](const TransferManager *tm, const std::shared_ptr<const TransferHandle> &th)
+      const auto path = QDir(QString::fromLocal8Bit(m_operation.parameters.c_str(), m_operation.parameters.size()));
+
+      std::vector<QString> files;
+      files.reserve(m_operation.keys.size());
+      for(auto it = m_operation.keys.cbegin(); it != m_operation.keys.cend(); ++it)
+      {
+        files.push_back(localFile(path, (*it).first));
+        m_tracker.addTotal(1, (*it).second);
+      }
+
+      // in sync mode the objects with an identical local file are skipped.
+      std::vector<bool> skip(m_operation.keys.size(), false);
+      if(m_operation.sync)
       {
-        auto fileKey = AWSUtils::toQString(th->GetKey());
-        if(fileNameKey != fileKey)
+        std::vector<SyncItem> items;
+        std::vector<std::size_t> indexes;
+        for(std::size_t i = 0; i < m_operation.keys.size(); ++i)
+        {
+          if(files.at(i).isEmpty()) continue;
+
+          const auto &p = m_operation.keys.at(i);
+          items.push_back(SyncItem{files.at(i), Aws::String(p.first.c_str(), p.first.length()), p.second, 0, false});
+          indexes.push_back(i);
+        }
+
+        compare(items, s3_client);
+
+        for(std::size_t i = 0; i < items.size(); ++i)
         {
-          fileNameKey = fileKey;
-          auto shortName = QFileInfo(fileKey).fileName();
-          emit message(tr("%1 '%2'").arg(operationTypeToText(m_operation.type)).arg(shortName));
+          if(!items.at(i).differs)
+          {
+            skip[indexes.at(i)] = true;
+            files[indexes.at(i)].clear();
+          }
         }
+      }
 
-        auto total = th->GetBytesTotalSize();
-        auto current = th->GetBytesTransferred();
-        int pValue = (current * 100)/total;
+      if(m_operation.fullPaths) createDirectories(files);
 
-        if(progressValue != pValue)
+      std::vector<char> cached(m_operation.keys.size(), false);
+      if(m_operation.cache) restoreCached(files, cached, s3_client);
+
+      auto updateGlobalProgress = [&]()
+      {
+        int gValue = ((m_fileCount + m_skipped) * 100)/m_operation.keys.size();
+        if(globalProgressValue != gValue)
         {
-          progressValue = pValue;
-          emit progress(pValue);
+          globalProgressValue = gValue;
+          emit globalProgress(gValue);
         }
       };
 
-      TransferManagerConfiguration transferManagerConfig(executor.get());
-      transferManagerConfig.s3Client = s3_client;
-      transferManagerConfig.downloadProgressCallback = transferCallback;
-      transferManagerConfig.uploadProgressCallback = transferCallback;
+      // files of failed or cancelled downloads are incomplete.
+      auto removePartialFile = [this](const QString &file)
+      {
+        if(QFile::exists(file) && !QFile::remove(file)) m_errors[QDir::toNativeSeparators(file)] << tr("Unable to remove the incomplete file.");
+      };
 
-      auto manager = TransferManager::Create(transferManagerConfig);
+      // up to DOWNLOAD_WINDOW objects are transferred at the same time.
+      struct Transfer
+      {
+        std::shared_ptr<TransferHandle>                  handle;   /** transfer handle.                   */
+        std::size_t                                      index;    /** index of the object.               */
+        unsigned int                                     attempt;  /** retry attempt of the transfer.     */
+        std::shared_ptr<ChecksumUtils::StreamChecksum>   checksum; /** checksum of the written data.      */
+        std::shared_ptr<TransferUtils::TransferProgress> progress; /** progress counters.                 */
+        std::shared_ptr<std::atomic<bool>>               opened;   /** true if the local file was opened. */
+        std::chrono::steady_clock::time_point            failed;   /** time of the failure to retry.      */
+        std::chrono::steady_clock::time_point            retryAt;  /** time of the retry, if failed.      */
+      };
+      std::list<Transfer> inFlight;
+      std::size_t index = 0;
 
-      if(m_operation.type == AWSUtils::OperationType::download)
+      while(!m_token.isCancelled() && (index < m_operation.keys.size() || !inFlight.empty()))
       {
-        std::shared_ptr<TransferHandle> downloadHandle;
-        for(auto it = m_operation.keys.cbegin(); it != m_operation.keys.cend(); ++it)
+        while(!m_token.isCancelled() && index < m_operation.keys.size() && inFlight.size() < DOWNLOAD_WINDOW)
+        {
+          const auto &p = m_operation.keys.at(index);
+          if(skip.at(index))
+          {
+            ++m_skipped;
+            m_tracker.finish(p.second);
+          }
+          else if(files.at(index).isEmpty())
+          {
+            m_errors[QString::fromStdString(p.first)] << tr("Invalid key for a local file.");
+            m_tracker.finish(p.second);
+          }
+          else if(cached.at(index))
+          {
+            ++m_fileCount;
+            ++m_cacheHits;
+            m_completed.push_back(p);
+            m_tracker.finish(p.second);
+
+            updateGlobalProgress();
+          }
+          else
+          {
+            auto fKey = Aws::String(p.first.c_str(), p.first.length());
+            auto filePath = AWSUtils::toAwsString(files.at(index));
+
+            const auto shortName = QFileInfo(files.at(index)).fileName();
+            emit message(tr("%1 '%2'").arg(operationTypeToText(m_operation.type)).arg(shortName));
+
+            auto progress = m_tracker.start(shortName, p.second);
+
+            // data is hashed while it's written, the whole MD5 is only needed for big single part objects.
+            std::shared_ptr<ChecksumUtils::StreamChecksum> checksum;
+            if(m_operation.checksums) checksum = std::make_shared<ChecksumUtils::StreamChecksum>(PART_SIZE, p.second > PART_SIZE);
+
+            // the local file can be a hard link of a cache entry, it must not be overwritten in place.
+            if(m_operation.cache) QFile::remove(files.at(index));
+
+            auto opened = std::make_shared<std::atomic<bool>>(false);
+            const auto fileName = files.at(index).toStdString();
+            auto createStream = [checksum, opened, fileName]() -> Aws::IOStream *
+            {
+              const auto mode = std::ios_base::out|std::ios_base::in|std::ios_base::trunc|std::ios_base::binary;
+
+              *opened = true;
+              if(!checksum) return Aws::New<Aws::FStream>(ALLOCATION_TAG, fileName.c_str(), mode);
+
+              checksum->reset();
+              return Aws::New<ChecksumUtils::ChecksumStream>(ALLOCATION_TAG, fileName, mode, checksum);
+            };
+
+            inFlight.push_back(Transfer{manager->DownloadFile(m_operation.bucket, fKey, createStream, DownloadConfiguration(), filePath, progress), index, 0, checksum, progress, opened, {}, {}});
+          }
+
+          ++index;
+        }
+
         {
-          auto p = *it;
-          auto fKey = Aws::String(p.first.c_str(), p.first.length());
-          auto fNameStr = QFileInfo(QString::fromStdString(p.first)).fileName();
-          auto path = QDir(QString::fromLocal8Bit(m_operation.parameters.c_str(), m_operation.parameters.size()));
-          auto fName = AWSUtils::toAwsString(fNameStr);
-          auto filePath = AWSUtils::toAwsString(path.absoluteFilePath(fNameStr));
+          // the wait also ends when the first failed transfer is due to be retried.
+          auto wakeUp = std::chrono::steady_clock::now() + std::chrono::milliseconds(250);
+          for(auto &transfer: inFlight)
+          {
+            if(transfer.handle->GetStatus() == TransferStatus::FAILED && transfer.retryAt != std::chrono::steady_clock::time_point()) wakeUp = std::min(wakeUp, transfer.retryAt);
+          }
 
-          emit message(tr("%1 '%2'").arg(operationTypeToText(m_operation.type)).arg(fNameStr));
+          std::unique_lock<std::mutex> lock(statusMutex);
+          statusCondition.wait_until(lock, wakeUp, [&statusChanged]() { return statusChanged; });
+          statusChanged = false;
+        }
+
+        for(auto it = inFlight.begin(); it != inFlight.end() && !m_token.isCancelled();)
+        {
+          auto &transfer = *it;
+          const auto status = transfer.handle->GetStatus();
+          if(status == TransferStatus::IN_PROGRESS || status == TransferStatus::NOT_STARTED)
+          {
+            ++it;
+            continue;
+          }
 
-          downloadHandle = manager->DownloadFile(m_operation.bucket, fKey, filePath);
-          waitUntilFinished(downloadHandle);
+          // the backoff of a failed transfer is waited in the next iterations, the others keep being dispatched.
+          unsigned int delay = 0;
+          if(status == TransferStatus::FAILED && transfer.retryAt == std::chrono::steady_clock::time_point() &&
+             scheduleRetry(transfer.handle->GetLastError(), transfer.attempt++, delay))
+          {
+            transfer.failed  = std::chrono::steady_clock::now();
+            transfer.retryAt = transfer.failed + std::chrono::milliseconds(delay);
+          }
 
-          int retries = 0;
-          while(downloadHandle->GetStatus() == TransferStatus::FAILED && retries++ < 5)
+          if(status == TransferStatus::FAILED && transfer.retryAt != std::chrono::steady_clock::time_point())
           {
-            manager->RetryDownload(downloadHandle);
-            waitUntilFinished(downloadHandle);
+            const auto now = std::chrono::steady_clock::now();
+            if(now >= transfer.retryAt)
+            {
+              {
+                std::lock_guard<std::mutex> lock(m_retryMutex);
+                m_retriesTime += std::chrono::duration_cast<std::chrono::milliseconds>(now - transfer.failed).count();
+              }
+
+              transfer.retryAt = std::chrono::steady_clock::time_point();
+              transfer.handle  = manager->RetryDownload(transfer.handle);
+            }
+            ++it;
+            continue;
           }
 
-          if(downloadHandle->GetStatus() != TransferStatus::COMPLETED)
+          const auto &p = m_operation.keys.at(transfer.index);
+          bool partial = false;
+          if(status != TransferStatus::COMPLETED)
           {
-            const auto error = downloadHandle->GetLastError();
-            auto exceptionName = AWSUtils::toQString(error.GetExceptionName());
-            auto errorMessage = AWSUtils::toQString(error.GetMessage());
-            m_errors[QString::fromStdString(p.first)] << exceptionName + " -> " + errorMessage;
+            addError(p.first, transfer.handle->GetLastError());
+            partial = *transfer.opened;
           }
-          else
+          else if(!transfer.checksum || verifyChecksum(transfer.handle, *transfer.checksum, p.first, p.second))
           {
             ++m_fileCount;
+            m_completed.push_back(p);
 
-            int gValue = (m_fileCount * 100)/m_operation.keys.size();
-            if(globalProgressValue != gValue)
+            // all the parts of a download return the ETag of the object. The CRC32C of the verified
+            // data is stored with the entry to detect a corrupted cache.
+            const auto parts = transfer.handle->GetCompletedParts();
+            if(m_operation.cache && !parts.empty())
             {
-              globalProgressValue = gValue;
-              emit globalProgress(gValue);
+              const auto etag     = AWSUtils::toQString((*parts.cbegin()).second->GetETag()).remove('"');
+              const auto checksum = m_checksums.find(p.first);
+              const auto crc32c   = checksum == m_checksums.cend() ? nullptr : &checksum->second.crc32c;
+              CacheUtils::contentCache()->insert(p.first, etag, files.at(transfer.index), crc32c);
             }
+
+            updateGlobalProgress();
           }
 
-          if(m_abort) break;
+          const auto fileIndex = transfer.index;
+          m_tracker.finish(transfer.progress);
+          it = inFlight.erase(it);
 
-          QApplication::processEvents();
+          if(partial) removePartialFile(files.at(fileIndex));
         }
+
+        QApplication::processEvents();
       }
-      else
+
+      if(m_token.isCancelled())
       {
-        assert(m_operation.type == AWSUtils::OperationType::upload);
+        emit message(tr("Cancelling %1 transfers").arg(inFlight.size()));
 
-        std::shared_ptr<TransferHandle> uploadHandle;
-        for(auto it = m_operation.keys.cbegin(); it != m_operation.keys.cend(); ++it)
+        // transfers started after the cancellation weren't cancelled by the token callback.
+        std::for_each(inFlight.cbegin(), inFlight.cend(), [](const Transfer &t) { t.handle->Cancel(); });
+        std::for_each(inFlight.cbegin(), inFlight.cend(), [](const Transfer &t) { t.handle->WaitUntilFinished(); });
+
+        std::vector<QString> partials;
+        for(auto &transfer: inFlight)
         {
-          auto p = *it;
-          auto fName = Aws::String(p.first.c_str(), p.first.length());
-          auto baseFile = QFileInfo(QString::fromStdString(p.first)).fileName();
-          auto baseFileAws = AWSUtils::toAwsString(baseFile);
-          auto fKeyStr = m_operation.parameters + baseFileAws;
+          if(transfer.handle->GetStatus() != TransferStatus::COMPLETED && *transfer.opened) partials.push_back(files.at(transfer.index));
+        }
+        inFlight.clear();
+
+        std::for_each(partials.cbegin(), partials.cend(), removePartialFile);
+      }
 
-          emit message(tr("%1 '%2'").arg(operationTypeToText(m_operation.type)).arg(baseFile));
+      if(m_operation.cache) CacheUtils::contentCache()->save();
+    }
+    else
+    {
+      assert(m_operation.type == AWSUtils::OperationType::upload);
 
-          uploadHandle = manager->UploadFile(fName, m_operation.bucket,  fKeyStr, "binary", Aws::Map<Aws::String, Aws::String>());
-          waitUntilFinished(uploadHandle);
+      // selected directories are walked while their files are being uploaded.
+      std::vector<std::pair<std::string, unsigned long long>> files, directories;
+      for(auto it = m_operation.keys.cbegin(); it != m_operation.keys.cend(); ++it)
+      {
+        if(QFileInfo(QString::fromStdString((*it).first)).isDir()) directories.push_back(*it);
+        else files.push_back(*it);
+      }
+      unsigned long long total = files.size();
 
-          int retries = 0;
-          while(uploadHandle->GetStatus() == TransferStatus::FAILED && retries++ < 5)
-          {
-            manager->RetryUpload(fName, uploadHandle);
-            waitUntilFinished(uploadHandle);
-          }
+      auto updateGlobalProgress = [&]()
+      {
+        int gValue = total == 0 ? 0 : ((m_fileCount + m_skipped) * 100)/total;
+        if(globalProgressValue != gValue)
+        {
+          globalProgressValue = gValue;
+          emit globalProgress(gValue);
+        }
+      };
+
+      // in sync mode only the files that differ from the objects in the bucket are uploaded.
+      auto uploadItems = [&](std::vector<SyncItem> &items)
+      {
+        if(m_operation.sync) compare(items, s3_client);
 
-          if(uploadHandle->GetStatus() != TransferStatus::COMPLETED)
+        for(auto it = items.cbegin(); it != items.cend() && !m_token.isCancelled(); ++it)
+        {
+          const auto &item = *it;
+          if(item.differs)
           {
-            const auto error = uploadHandle->GetLastError();
-            auto exceptionName = AWSUtils::toQString(error.GetExceptionName());
-            auto errorMessage = AWSUtils::toQString(error.GetMessage());
-            m_errors[QString::fromStdString(p.first)] << exceptionName + " -> " + errorMessage;
+            uploadFile(manager, s3_client, item.file.toStdString(), item.key, item.localSize);
           }
           else
           {
-            ++m_fileCount;
-
-            int gValue = (m_fileCount * 100)/m_operation.keys.size();
-            if(globalProgressValue != gValue)
-            {
-              globalProgressValue = gValue;
-              emit globalProgress(gValue);
-            }
+            ++m_skipped;
+            m_tracker.finish(item.localSize);
           }
 
-          if(m_abort) break;
+          updateGlobalProgress();
 
           QApplication::processEvents();
         }
+
+        items.clear();
+      };
+
+      auto uploadItem = [this](const std::string &file, const Aws::String &key, const unsigned long long size)
+      {
+        SyncItem item{QString::fromStdString(file), key, 0, size, true};
+        m_tracker.addTotal(1, size);
+
+        if(m_operation.sync && m_operation.remoteSizes)
+        {
+          auto it = m_operation.remoteSizes->find(std::string(key.c_str(), key.size()));
+          if(it != m_operation.remoteSizes->cend())
+          {
+            item.size    = (*it).second;
+            item.differs = false;
+          }
+        }
+
+        return item;
+      };
+
+      std::vector<SyncItem> items;
+      items.reserve(files.size());
+      for(auto it = files.cbegin(); it != files.cend(); ++it)
+      {
+        auto baseFile = QFileInfo(QString::fromStdString((*it).first)).fileName();
+        items.push_back(uploadItem((*it).first, m_operation.parameters + AWSUtils::toAwsString(baseFile), (*it).second));
       }
-    }
+      uploadItems(items);
 
-    emit message("Finished!");
-  }
-  ShutdownAPI(options);
+      for(auto it = directories.cbegin(); it != directories.cend() && !m_token.isCancelled(); ++it)
+      {
+        const auto dirName = QString::fromStdString((*it).first);
+        emit message(tr("Scanning '%1'").arg(QFileInfo(dirName).fileName()));
 
-  if(m_operation.useLogging)
-  {
-    Utils::Logging::ShutdownAWSLogging();
+        TransferUtils::DirectoryScanner scanner(dirName, SCAN_THREADS);
+        scanner.start();
+
+        TransferUtils::CancellationScope stopScan(m_token, [&scanner]() { scanner.abort(); });
+
+        const auto previous = total;
+        const std::size_t batchSize = m_operation.sync ? SYNC_BATCH : 1;
+        TransferUtils::DirectoryScanner::Entry entry;
+        while(!m_token.isCancelled() && scanner.next(entry))
+        {
+          total = previous + scanner.filesCount();
+
+          items.push_back(uploadItem(entry.path, m_operation.parameters + Aws::String(entry.key.c_str(), entry.key.size()), entry.size));
+          if(items.size() >= batchSize) uploadItems(items);
+        }
+        if(!m_token.isCancelled()) uploadItems(items);
+
+        if(m_token.isCancelled()) break;
+
+        total = previous + scanner.filesCount();
+        updateGlobalProgress();
+
+        const auto found = scanner.directories();
+        std::for_each(found.cbegin(), found.cend(), [this](const std::string &d) { m_directories.push_back(std::string(m_operation.parameters.c_str(), m_operation.parameters.size()) + d); });
+      }
+    }
   }
+
+  QString finished = tr("Finished!");
+  if(m_skipped > 0) finished += tr(" %1 unchanged objects skipped.").arg(m_skipped);
+  if(m_cacheHits > 0) finished += tr(" %1 objects from the local cache.").arg(m_cacheHits);
+  if(m_retries > 0) finished += tr(" %1 retries, %2 seconds waiting.").arg(m_retries).arg(QString::number(m_retriesTime/1000., 'f', 1));
+  emit message(finished);
+
+  if(m_operation.useLogging) shutdownLogging();
 }
 
 //-----------------------------------------------------------------------------
-void AWSUtils::S3Thread::abort()
+QString AWSUtils::S3Thread::localFile(const QDir &path, const std::string &key) const
 {
-  m_abort = true;
+  const auto parts = QString::fromStdString(key).split(DELIMITER, QString::SkipEmptyParts);
+
+  // keys must not escape the download path.
+  if(parts.isEmpty() || parts.contains("..") || parts.contains(".")) return QString();
+
+  return path.absoluteFilePath(m_operation.fullPaths ? parts.join('/') : parts.last());
 }
 
 //-----------------------------------------------------------------------------
-void AWSUtils::S3Thread::waitUntilFinished(std::shared_ptr<Aws::Transfer::TransferHandle> handle)
+void AWSUtils::S3Thread::compare(std::vector<SyncItem> &items, std::shared_ptr<Aws::S3::S3Client> client)
 {
-  auto status = handle->GetStatus();
-  while((status == TransferStatus::IN_PROGRESS || status == TransferStatus::NOT_STARTED) && !m_abort)
+  emit message(tr("Comparing %1 objects").arg(items.size()));
+
+  std::atomic<std::size_t> next{0};
+
+  auto compareItems = [&]()
   {
-    this->sleep(1);
-    QApplication::processEvents();
-    status = handle->GetStatus();
-  }
+    std::size_t i;
+    while(!m_token.isCancelled() && (i = next++) < items.size())
+    {
+      auto &item = items[i];
+      if(item.differs) continue;
+
+      QFileInfo info(item.file);
+      item.localSize = info.exists() ? info.size() : 0;
+      item.differs   = !info.exists() || item.localSize != item.size;
+      if(item.differs || !m_operation.verify) continue;
+
+      Aws::S3::Model::HeadObjectRequest request;
+      request.WithBucket(m_operation.bucket).WithKey(item.key);
+      request.SetContinueRequestHandler([this](const Aws::Http::HttpRequest *) { return !m_token.isCancelled(); });
+
+      auto result = client->HeadObject(request);
+      if(!result.IsSuccess())
+      {
+        item.differs = true;
+        continue;
+      }
+
+      // the side modified after the last transfer is newer than the other.
+      const auto remoteTime = result.GetResult().GetLastModified().Millis();
+      const auto localTime  = info.lastModified().toMSecsSinceEpoch();
+      const bool newer      = (m_operation.type == OperationType::upload) ? localTime > remoteTime : remoteTime > localTime;
+
+      auto remoteETag = AWSUtils::toQString(result.GetResult().GetETag());
+      remoteETag.remove('"');
+
+      const auto position = remoteETag.indexOf('-');
+      const auto parts    = position == -1 ? 0 : remoteETag.mid(position + 1).toUInt();
 
-  if(m_abort && status != TransferStatus::COMPLETED) handle->Cancel();
+      item.differs = newer || !computeETags(item.file, item.size, parts).contains(remoteETag, Qt::CaseInsensitive);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  const auto threadsNum = std::min<std::size_t>(SYNC_THREADS, items.size());
+  for(std::size_t i = 1; i < threadsNum; ++i) threads.emplace_back(compareItems);
+  compareItems();
+  std::for_each(threads.begin(), threads.end(), [](std::thread &t) { t.join(); });
+
+  // an aborted comparison must not skip anything.
+  if(m_token.isCancelled()) std::for_each(items.begin(), items.end(), [](SyncItem &i) { i.differs = true; });
 }
 
 //-----------------------------------------------------------------------------
-Aws::String AWSUtils::toAwsString(const QString& text)
+void AWSUtils::S3Thread::restoreCached(const std::vector<QString> &files, std::vector<char> &cached, std::shared_ptr<Aws::S3::S3Client> client)
 {
-  return Aws::String(text.toStdString().c_str(), text.length());
+  auto cache = CacheUtils::contentCache();
+
+  // only the objects with a cached version need the ETag request, the rest are lookups that missed.
+  std::vector<std::size_t> indexes;
+  std::atomic<unsigned long long> misses{0};
+  for(std::size_t i = 0; i < files.size(); ++i)
+  {
+    if(files.at(i).isEmpty()) continue;
+
+    if(cache->contains(m_operation.keys.at(i).first))
+    {
+      indexes.push_back(i);
+    }
+    else
+    {
+      ++misses;
+    }
+  }
+
+  if(indexes.empty())
+  {
+    cache->addMisses(misses);
+    return;
+  }
+
+  emit message(tr("Checking %1 cached objects").arg(indexes.size()));
+
+  std::atomic<std::size_t> next{0};
+
+  auto restoreFiles = [&]()
+  {
+    std::size_t i;
+    while(!m_token.isCancelled() && (i = next++) < indexes.size())
+    {
+      const auto index = indexes.at(i);
+      const auto &key  = m_operation.keys.at(index).first;
+
+      Aws::S3::Model::HeadObjectRequest request;
+      request.WithBucket(m_operation.bucket).WithKey(Aws::String(key.c_str(), key.length()));
+      request.SetContinueRequestHandler([this](const Aws::Http::HttpRequest *) { return !m_token.isCancelled(); });
+
+      auto result = client->HeadObject(request);
+      if(!result.IsSuccess())
+      {
+        ++misses;
+        continue;
+      }
+
+      const auto etag = AWSUtils::toQString(result.GetResult().GetETag()).remove('"');
+      cached[index] = cache->materialize(key, etag, files.at(index));
+    }
+  };
+
+  std::vector<std::thread> threads;
+  const auto threadsNum = std::min<std::size_t>(CACHE_THREADS, indexes.size());
+  for(std::size_t i = 1; i < threadsNum; ++i) threads.emplace_back(restoreFiles);
+  restoreFiles();
+  std::for_each(threads.begin(), threads.end(), [](std::thread &t) { t.join(); });
+
+  cache->addMisses(misses);
 }
 
 //-----------------------------------------------------------------------------
-QString AWSUtils::toQString(const Aws::String& text)
+void AWSUtils::S3Thread::createDirectories(const std::vector<QString> &files)
 {
-  return QString::fromLocal8Bit(text.c_str(), text.length());
+  emit message(tr("Creating directories"));
+
+  std::set<QString> directories;
+  for(auto &file: files)
+  {
+    if(!file.isEmpty()) directories.insert(file.left(file.lastIndexOf('/')));
+  }
+
+  // only the deepest directories are needed, mkpath() creates the rest.
+  std::set<QString> parents;
+  for(auto &directory: directories)
+  {
+    parents.insert(directory.left(directory.lastIndexOf('/')));
+  }
+
+  std::vector<QString> leaves;
+  std::copy_if(directories.cbegin(), directories.cend(), std::back_inserter(leaves), [&parents](const QString &d) { return parents.find(d) == parents.cend(); });
+
+  std::mutex failedMutex;
+  std::vector<QString> failed;
+  std::atomic<std::size_t> next{0};
+
+  auto createPaths = [&]()
+  {
+    std::size_t i;
+    while(!m_token.isCancelled() && (i = next++) < leaves.size())
+    {
+      if(!QDir().mkpath(leaves.at(i)))
+      {
+        std::lock_guard<std::mutex> lock(failedMutex);
+        failed.push_back(leaves.at(i));
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  const auto threadsNum = std::min<std::size_t>(DIRECTORY_THREADS, leaves.size());
+  for(std::size_t i = 1; i < threadsNum; ++i) threads.emplace_back(createPaths);
+  createPaths();
+  std::for_each(threads.begin(), threads.end(), [](std::thread &t) { t.join(); });
+
+  std::for_each(failed.cbegin(), failed.cend(), [this](const QString &d) { m_errors[QDir::toNativeSeparators(d)] << tr("Unable to create directory."); });
 }
 
 //-----------------------------------------------------------------------------
-QString AWSUtils::operationTypeToText(const OperationType& type)
+void AWSUtils::S3Thread::uploadFile(std::shared_ptr<Aws::Transfer::TransferManager> manager, std::shared_ptr<Aws::S3::S3Client> client,
+                                    const std::string &file, const Aws::String &key, const unsigned long long size)
 {
-  switch(type)
+  const auto fName = Aws::String(file.c_str(), file.length());
+
+  const auto shortName = QFileInfo(QString::fromStdString(file)).fileName();
+  emit message(tr("%1 '%2'").arg(operationTypeToText(m_operation.type)).arg(shortName));
+
+  auto progress = m_tracker.start(shortName, size);
+
+  // data is hashed while the transfer manager reads it, retries re-read already hashed data.
+  std::shared_ptr<ChecksumUtils::StreamChecksum> checksum;
+  std::shared_ptr<Aws::IOStream> stream;
+  if(m_operation.checksums)
   {
-    case OperationType::download:
-      return "Download";
-      break;
-    case OperationType::remove:
-      return "Delete";
-      break;
-    case OperationType::upload:
-      return "Upload";
+    checksum = std::make_shared<ChecksumUtils::StreamChecksum>(PART_SIZE, false);
+    stream   = Aws::MakeShared<ChecksumUtils::ChecksumStream>(ALLOCATION_TAG, file, std::ios_base::in, checksum);
+
+    // let the transfer manager report the error.
+    if(!stream->good())
+    {
+      stream.reset();
+      checksum.reset();
+    }
+  }
+
+  auto startUpload = [&]() -> std::shared_ptr<TransferHandle>
+  {
+    if(stream) return manager->UploadFile(stream, m_operation.bucket, key, "binary", Aws::Map<Aws::String, Aws::String>(), progress);
+    return manager->UploadFile(fName, m_operation.bucket, key, "binary", Aws::Map<Aws::String, Aws::String>(), progress);
+  };
+
+  auto uploadHandle = startUpload();
+  waitUntilFinished(uploadHandle);
+
+  unsigned int attempt = 0;
+  while(uploadHandle->GetStatus() == TransferStatus::FAILED && retry(uploadHandle->GetLastError(), attempt++))
+  {
+    if(stream)
+    {
+      stream->clear();
+      uploadHandle = manager->RetryUpload(stream, uploadHandle);
+    }
+    else
+    {
+      uploadHandle = manager->RetryUpload(fName, uploadHandle);
+    }
+    waitUntilFinished(uploadHandle);
+  }
+
+  if(uploadHandle->GetStatus() != TransferStatus::COMPLETED)
+  {
+    if(!m_token.isCancelled()) addError(file, uploadHandle->GetLastError());
+
+    // parts already uploaded are stored (and billed) until the upload is aborted.
+    if(uploadHandle->IsMultipart() && !uploadHandle->GetMultiPartId().empty())
+    {
+      Aws::S3::Model::AbortMultipartUploadRequest request;
+      request.WithBucket(m_operation.bucket).WithKey(key).WithUploadId(uploadHandle->GetMultiPartId());
+
+      auto result = client->AbortMultipartUpload(request);
+      if(!result.IsSuccess()) addError(file, result.GetError());
+    }
+  }
+  else if(!checksum || verifyChecksum(uploadHandle, *checksum, file, size))
+  {
+    ++m_fileCount;
+    m_completed.emplace_back(std::string(key.c_str(), key.size()), size);
+  }
+
+  m_tracker.finish(progress);
+}
+
+//-----------------------------------------------------------------------------
+void AWSUtils::S3Thread::moveObjects(std::shared_ptr<Aws::S3::S3Client> client)
+{
+  const auto &keys = m_operation.keys;
+  assert(keys.size() == m_operation.destinations.size());
+  if(keys.empty()) return;
+
+  unsigned long long bytes = 0;
+  std::for_each(keys.cbegin(), keys.cend(), [&bytes](const std::pair<std::string, unsigned long long> &p) { bytes += p.second; });
+  m_tracker.addTotal(keys.size(), bytes);
+
+  emit message(tr("Copying %1 objects").arg(keys.size()));
+
+  // objects are copied by the server, no data goes through the client.
+  std::vector<char> copied(keys.size(), false);
+  std::mutex errorsMutex;
+  std::atomic<std::size_t> next{0};
+  std::atomic<std::size_t> finished{0};
+  std::atomic<int> progressValue{0};
+
+  auto copyObjects = [&]()
+  {
+    std::size_t i;
+    while(!m_token.isCancelled() && (i = next++) < keys.size())
+    {
+      const auto &source      = keys.at(i).first;
+      const auto &destination = m_operation.destinations.at(i);
+
+      Aws::Client::AWSError<Aws::S3::S3Errors> error;
+      copied[i] = copyObject(client, Aws::String(source.c_str(), source.length()), Aws::String(destination.c_str(), destination.length()), keys.at(i).second, error);
+
+      if(!copied[i] && !m_token.isCancelled())
+      {
+        std::lock_guard<std::mutex> lock(errorsMutex);
+        addError(source, error);
+      }
+
+      // deletions are fast, the copies are the progress of the operation.
+      const int value = (++finished * 100) / keys.size();
+      if(progressValue.exchange(value) != value) emit globalProgress(value);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  const auto threadsNum = std::min<std::size_t>(COPY_THREADS, keys.size());
+  for(std::size_t i = 1; i < threadsNum; ++i) threads.emplace_back(copyObjects);
+  copyObjects();
+  std::for_each(threads.begin(), threads.end(), [](std::thread &t) { t.join(); });
+
+  // the sources of the finished copies are deleted even if the operation has been cancelled,
+  // otherwise the objects would be duplicated.
+  std::vector<std::size_t> toDelete;
+  for(std::size_t i = 0; i < copied.size(); ++i)
+  {
+    if(copied[i]) toDelete.push_back(i);
+  }
+
+  if(!toDelete.empty()) emit message(tr("Deleting %1 moved objects").arg(toDelete.size()));
+
+  for(std::size_t begin = 0; begin < toDelete.size(); begin += DELETE_BATCH)
+  {
+    const auto end = std::min(begin + DELETE_BATCH, toDelete.size());
+
+    Aws::S3::Model::Delete objects;
+    objects.SetQuiet(true);
+    for(auto i = begin; i < end; ++i)
+    {
+      const auto &key = keys.at(toDelete.at(i)).first;
+      objects.AddObjects(Aws::S3::Model::ObjectIdentifier().WithKey(Aws::String(key.c_str(), key.length())));
+    }
+
+    Aws::S3::Model::DeleteObjectsRequest request;
+    request.WithBucket(m_operation.bucket).WithDelete(objects);
+
+    auto result = client->DeleteObjects(request);
+
+    unsigned int attempt = 0;
+    while(!result.IsSuccess() && retry(result.GetError(), attempt++))
+    {
+      result = client->DeleteObjects(request);
+    }
+
+    if(!result.IsSuccess())
+    {
+      for(auto i = begin; i < end; ++i)
+      {
+        const auto &p = keys.at(toDelete.at(i));
+        addError(p.first, result.GetError());
+        m_errors[QString::fromStdString(p.first)] << tr("Copied to '%1' but not deleted.").arg(QString::fromStdString(m_operation.destinations.at(toDelete.at(i))));
+      }
+      continue;
+    }
+
+    // in quiet mode only the keys that couldn't be deleted are returned.
+    std::set<std::string> failed;
+    for(auto &error: result.GetResult().GetErrors())
+    {
+      const auto key = std::string(error.GetKey().c_str(), error.GetKey().size());
+      failed.insert(key);
+      m_errors[QString::fromStdString(key)] << AWSUtils::toQString(error.GetCode()) + " -> " + AWSUtils::toQString(error.GetMessage());
+    }
+
+    for(auto i = begin; i < end; ++i)
+    {
+      const auto &p = keys.at(toDelete.at(i));
+      if(failed.find(p.first) == failed.cend())
+      {
+        ++m_fileCount;
+        m_completed.push_back(p);
+      }
+      else
+      {
+        m_errors[QString::fromStdString(p.first)] << tr("Copied to '%1' but not deleted.").arg(QString::fromStdString(m_operation.destinations.at(toDelete.at(i))));
+      }
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool AWSUtils::S3Thread::copyObject(std::shared_ptr<Aws::S3::S3Client> client, const Aws::String &source, const Aws::String &destination,
+                                    const unsigned long long size, Aws::Client::AWSError<Aws::S3::S3Errors> &error)
+{
+  const auto sourceCopy = copySource(m_operation.bucket, source);
+
+  auto continueRequest = [this](const Aws::Http::HttpRequest *) { return !m_token.isCancelled(); };
+
+  // the size in the tree can be stale, the copy is done with the current size of the source.
+  Aws::S3::Model::HeadObjectRequest headRequest;
+  headRequest.WithBucket(m_operation.bucket).WithKey(source);
+  headRequest.SetContinueRequestHandler(continueRequest);
+
+  auto head = client->HeadObject(headRequest);
+
+  unsigned int attempt = 0;
+  while(!head.IsSuccess() && retry(head.GetError(), attempt++))
+  {
+    head = client->HeadObject(headRequest);
+  }
+
+  if(!head.IsSuccess())
+  {
+    error = head.GetError();
+    m_tracker.finish(size);
+    return false;
+  }
+
+  const auto objectSize = static_cast<unsigned long long>(head.GetResult().GetContentLength());
+
+  if(objectSize <= COPY_LIMIT)
+  {
+    Aws::S3::Model::CopyObjectRequest request;
+    request.WithBucket(m_operation.bucket).WithKey(destination).WithCopySource(sourceCopy);
+    request.SetContinueRequestHandler(continueRequest);
+
+    auto result = client->CopyObject(request);
+
+    attempt = 0;
+    while(!result.IsSuccess() && retry(result.GetError(), attempt++))
+    {
+      result = client->CopyObject(request);
+    }
+
+    if(!result.IsSuccess()) error = result.GetError();
+
+    m_tracker.finish(size);
+
+    return result.IsSuccess();
+  }
+
+  // the parts of a copy don't keep the metadata of the source.
+  Aws::S3::Model::CreateMultipartUploadRequest createRequest;
+  createRequest.WithBucket(m_operation.bucket).WithKey(destination);
+  createRequest.WithContentType(head.GetResult().GetContentType()).WithMetadata(head.GetResult().GetMetadata());
+  createRequest.SetContinueRequestHandler(continueRequest);
+
+  auto create = client->CreateMultipartUpload(createRequest);
+
+  attempt = 0;
+  while(!create.IsSuccess() && retry(create.GetError(), attempt++))
+  {
+    create = client->CreateMultipartUpload(createRequest);
+  }
+
+  if(!create.IsSuccess())
+  {
+    error = create.GetError();
+    m_tracker.finish(size);
+    return false;
+  }
+
+  const auto uploadId = create.GetResult().GetUploadId();
+  auto progress = m_tracker.start(QFileInfo(AWSUtils::toQString(source)).fileName(), objectSize);
+
+  // the parts are as big as needed to fit in the maximum number of parts.
+  const auto partSize = std::max(COPY_PART_SIZE, (objectSize + MAX_PARTS - 1) / MAX_PARTS);
+
+  Aws::S3::Model::CompletedMultipartUpload parts;
+  bool success = true;
+  int part = 1;
+  for(unsigned long long first = 0; success && first < objectSize; first += partSize, ++part)
+  {
+    const auto last  = std::min(first + partSize, objectSize) - 1;
+    const auto range = "bytes=" + std::to_string(first) + "-" + std::to_string(last);
+
+    Aws::S3::Model::UploadPartCopyRequest partRequest;
+    partRequest.WithBucket(m_operation.bucket).WithKey(destination).WithUploadId(uploadId).WithPartNumber(part);
+    partRequest.WithCopySource(sourceCopy).WithCopySourceRange(Aws::String(range.c_str(), range.length()));
+    partRequest.SetContinueRequestHandler(continueRequest);
+
+    auto result = client->UploadPartCopy(partRequest);
+
+    attempt = 0;
+    while(!result.IsSuccess() && retry(result.GetError(), attempt++))
+    {
+      result = client->UploadPartCopy(partRequest);
+    }
+
+    if(result.IsSuccess())
+    {
+      parts.AddParts(Aws::S3::Model::CompletedPart().WithETag(result.GetResult().GetCopyPartResult().GetETag()).WithPartNumber(part));
+      progress->update(last + 1, objectSize);
+    }
+    else
+    {
+      error = result.GetError();
+      success = false;
+    }
+  }
+
+  if(success)
+  {
+    Aws::S3::Model::CompleteMultipartUploadRequest completeRequest;
+    completeRequest.WithBucket(m_operation.bucket).WithKey(destination).WithUploadId(uploadId).WithMultipartUpload(parts);
+
+    auto result = client->CompleteMultipartUpload(completeRequest);
+
+    attempt = 0;
+    while(!result.IsSuccess() && retry(result.GetError(), attempt++))
+    {
+      result = client->CompleteMultipartUpload(completeRequest);
+    }
+
+    if(!result.IsSuccess())
+    {
+      error = result.GetError();
+      success = false;
+    }
+  }
+
+  if(!success)
+  {
+    // parts already copied are stored (and billed) until the upload is aborted.
+    Aws::S3::Model::AbortMultipartUploadRequest request;
+    request.WithBucket(m_operation.bucket).WithKey(destination).WithUploadId(uploadId);
+
+    client->AbortMultipartUpload(request);
+  }
+
+  m_tracker.finish(progress);
+
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+bool AWSUtils::S3Thread::verifyChecksum(std::shared_ptr<Aws::Transfer::TransferHandle> handle, ChecksumUtils::StreamChecksum &checksum,
+                                        const std::string &key, const unsigned long long size)
+{
+  // data not hashed completely, the transfer can't be verified.
+  if(checksum.size() != size) return true;
+
+  auto unquote = [](const Aws::String &etag) { return AWSUtils::toQString(etag).remove('"'); };
+  const auto parts = handle->GetCompletedParts();
+
+  QString etag;
+  bool valid = true;
+
+  if(handle->GetTransferDirection() == TransferDirection::UPLOAD)
+  {
+    // the ETag of each uploaded part is the MD5 of the part.
+    etag = checksum.etag();
+    for(auto it = parts.cbegin(); it != parts.cend() && valid; ++it)
+    {
+      const auto partETag = unquote((*it).second->GetETag());
+      const auto expected = handle->IsMultipart() ? checksum.partMD5((*it).first - 1) : etag;
+
+      valid = partETag.compare(expected, Qt::CaseInsensitive) == 0;
+    }
+  }
+  else
+  {
+    // all the parts of a download return the ETag of the object.
+    if(parts.empty()) return true;
+
+    etag = unquote((*parts.cbegin()).second->GetETag());
+
+    const auto position = etag.indexOf('-');
+    if(position == -1)
+    {
+      valid = etag.compare(checksum.md5(), Qt::CaseInsensitive) == 0;
+    }
+    else
+    {
+      // the part size used by the uploader is unknown, the ETag can only be verified if ours is the
+      // only part size in whole MB that gives the same number of parts.
+      const unsigned long long MB = 1024*1024;
+      const auto count = etag.mid(position + 1).toUInt();
+      if(count < 2 || count != checksum.partsCount() || PART_SIZE + MB <= (size - 1) / (count - 1)) return true;
+
+      valid = etag.compare(checksum.etag(), Qt::CaseInsensitive) == 0;
+    }
+  }
+
+  if(!valid)
+  {
+    m_errors[QString::fromStdString(key)] << tr("Checksum mismatch, the transferred data doesn't match the ETag '%1'.").arg(etag);
+    return false;
+  }
+
+  const auto &objectKey = handle->GetKey();
+  m_checksums[std::string(objectKey.c_str(), objectKey.size())] = ObjectChecksum{etag, checksum.crc32c()};
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void AWSUtils::S3Thread::onSampleTimeout()
+{
+  emit progressSampled(m_tracker.sample());
+}
+
+//-----------------------------------------------------------------------------
+void AWSUtils::S3Thread::abort()
+{
+  m_token.cancel();
+}
+
+//-----------------------------------------------------------------------------
+bool AWSUtils::S3Thread::isAborted() const
+{
+  return m_token.isCancelled();
+}
+
+//-----------------------------------------------------------------------------
+bool AWSUtils::S3Thread::retry(const Aws::Client::AWSError<Aws::S3::S3Errors> &error, const unsigned int attempt)
+{
+  unsigned int delay;
+  if(!scheduleRetry(error, attempt, delay)) return false;
+
+  // the wait ends as soon as the operation is cancelled.
+  const auto start     = std::chrono::steady_clock::now();
+  const auto cancelled = m_token.waitFor(std::chrono::milliseconds(delay));
+  const auto elapsed   = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+  std::lock_guard<std::mutex> lock(m_retryMutex);
+  m_retriesTime += elapsed;
+
+  return !cancelled;
+}
+
+//-----------------------------------------------------------------------------
+bool AWSUtils::S3Thread::scheduleRetry(const Aws::Client::AWSError<Aws::S3::S3Errors> &error, const unsigned int attempt, unsigned int &delay)
+{
+  const auto &policy = m_operation.retryPolicy;
+
+  {
+    std::lock_guard<std::mutex> lock(m_retryMutex);
+
+    if(m_token.isCancelled() || attempt >= policy.maxAttempts || m_retries >= policy.budget || !isRetryable(error)) return false;
+
+    ++m_retries;
+
+    delay = backoffDelay(policy, attempt, m_generator);
+  }
+
+  emit message(tr("Retrying in %1 ms (%2)").arg(delay).arg(AWSUtils::toQString(error.GetExceptionName())));
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void AWSUtils::S3Thread::addError(const std::string &key, const Aws::Client::AWSError<Aws::S3::S3Errors> &error)
+{
+  auto exceptionName = AWSUtils::toQString(error.GetExceptionName());
+  auto errorMessage = AWSUtils::toQString(error.GetMessage());
+  m_errors[QString::fromStdString(key)] << exceptionName + " -> " + errorMessage;
+}
+
+//-----------------------------------------------------------------------------
+bool AWSUtils::isRetryable(const Aws::Client::AWSError<Aws::S3::S3Errors> &error)
+{
+  switch(error.GetErrorType())
+  {
+    case Aws::S3::S3Errors::THROTTLING:
+    case Aws::S3::S3Errors::SLOW_DOWN:
+    case Aws::S3::S3Errors::REQUEST_TIMEOUT:
+    case Aws::S3::S3Errors::SERVICE_UNAVAILABLE:
+    case Aws::S3::S3Errors::INTERNAL_FAILURE:
+    case Aws::S3::S3Errors::NETWORK_CONNECTION:
+      return true;
+    case Aws::S3::S3Errors::ACCESS_DENIED:
+    case Aws::S3::S3Errors::INVALID_ACCESS_KEY_ID:
+    case Aws::S3::S3Errors::SIGNATURE_DOES_NOT_MATCH:
+    case Aws::S3::S3Errors::NO_SUCH_BUCKET:
+    case Aws::S3::S3Errors::NO_SUCH_KEY:
+    case Aws::S3::S3Errors::NO_SUCH_UPLOAD:
+    case Aws::S3::S3Errors::RESOURCE_NOT_FOUND:
+    case Aws::S3::S3Errors::VALIDATION:
+      return false;
+    default:
+      break;
+  }
+
+  switch(error.GetResponseCode())
+  {
+    case Aws::Http::HttpResponseCode::REQUEST_TIMEOUT:
+    case Aws::Http::HttpResponseCode::TOO_MANY_REQUESTS:
+    case Aws::Http::HttpResponseCode::INTERNAL_SERVER_ERROR:
+    case Aws::Http::HttpResponseCode::BAD_GATEWAY:
+    case Aws::Http::HttpResponseCode::SERVICE_UNAVAILABLE:
+    case Aws::Http::HttpResponseCode::GATEWAY_TIMEOUT:
+      return true;
+    case Aws::Http::HttpResponseCode::BAD_REQUEST:
+    case Aws::Http::HttpResponseCode::UNAUTHORIZED:
+    case Aws::Http::HttpResponseCode::FORBIDDEN:
+    case Aws::Http::HttpResponseCode::NOT_FOUND:
+    case Aws::Http::HttpResponseCode::METHOD_NOT_ALLOWED:
+    case Aws::Http::HttpResponseCode::PRECONDITION_FAILED:
+      return false;
+    default:
+      break;
+  }
+
+  return error.ShouldRetry();
+}
+
+//-----------------------------------------------------------------------------
+unsigned int AWSUtils::backoffDelay(const RetryPolicy &policy, const unsigned int attempt, std::mt19937 &generator)
+{
+  // full jitter: random value in [0, min(maxDelay, baseDelay * 2^attempt)].
+  const auto exponent = std::min(attempt, 20U);
+  const auto ceiling  = std::min(static_cast<unsigned long long>(policy.maxDelay), static_cast<unsigned long long>(policy.baseDelay) << exponent);
+
+  std::uniform_int_distribution<unsigned int> distribution(0, static_cast<unsigned int>(ceiling));
+  return distribution(generator);
+}
+
+//-----------------------------------------------------------------------------
+void AWSUtils::S3Thread::waitUntilFinished(std::shared_ptr<Aws::Transfer::TransferHandle> handle)
+{
+  // the transfer manager cancels the handle if the operation is cancelled, check the
+  // transfers started after the cancellation.
+  if(m_token.isCancelled()) handle->Cancel();
+
+  handle->WaitUntilFinished();
+}
+
+//-----------------------------------------------------------------------------
+void AWSUtils::S3Thread::setExecutor(std::shared_ptr<Aws::Utils::Threading::Executor> executor)
+{
+  m_executor = executor;
+}
+
+//-----------------------------------------------------------------------------
+void AWSUtils::initializeLogging()
+{
+  std::lock_guard<std::mutex> lock(s_loggingMutex);
+
+  if(s_loggingCount++ == 0)
+  {
+    Utils::Logging::InitializeAWSLogging(MakeShared<Utils::Logging::DefaultLogSystem>(ALLOCATION_TAG, Utils::Logging::LogLevel::Trace, "aws_sdk_"));
+  }
+}
+
+//-----------------------------------------------------------------------------
+void AWSUtils::shutdownLogging()
+{
+  std::lock_guard<std::mutex> lock(s_loggingMutex);
+
+  if(s_loggingCount > 0 && --s_loggingCount == 0)
+  {
+    Utils::Logging::ShutdownAWSLogging();
+  }
+}
+
+//-----------------------------------------------------------------------------
+QStringList AWSUtils::computeETags(const QString &fileName, const unsigned long long size, const unsigned int parts)
+{
+  const unsigned long long MB = 1024*1024;
+
+  // multipart ETags are the MD5 of the MD5s of the parts. The part size is not stored, the sizes
+  // of this application, of the usual clients and the smallest multiple of 1MB that give the same
+  // number of parts are tried.
+  std::vector<unsigned long long> partSizes;
+  if(parts <= 1)
+  {
+    partSizes.push_back(std::max(1ULL, size));
+  }
+  else
+  {
+    const unsigned long long candidates[] = { PART_SIZE, 8*MB, 16*MB, (((size + parts - 1) / parts + MB - 1) / MB) * MB };
+    for(auto partSize: candidates)
+    {
+      const bool valid = (size + partSize - 1) / partSize == parts;
+      if(valid && std::find(partSizes.cbegin(), partSizes.cend(), partSize) == partSizes.cend()) partSizes.push_back(partSize);
+    }
+  }
+
+  QStringList etags;
+  if(partSizes.empty()) return etags;
+
+  QFile file(fileName);
+  if(!file.open(QIODevice::ReadOnly)) return etags;
+
+  // the file is read once for all the part sizes.
+  struct Digest
+  {
+    explicit Digest(const unsigned long long size)
+    : partSize{size}, partRead{0}, part{QCryptographicHash::Md5}, etag{QCryptographicHash::Md5}
+    {}
+
+    const unsigned long long partSize; /** size of the parts.                */
+    unsigned long long       partRead; /** bytes hashed of the current part. */
+    QCryptographicHash       part;     /** MD5 of the current part.          */
+    QCryptographicHash       etag;     /** MD5 of the MD5s of the parts.     */
+  };
+  std::vector<std::unique_ptr<Digest>> digests;
+  std::for_each(partSizes.cbegin(), partSizes.cend(), [&digests](const unsigned long long size) { digests.emplace_back(new Digest(size)); });
+
+  while(!file.atEnd())
+  {
+    const auto buffer = file.read(MB);
+    if(buffer.isEmpty()) return QStringList();
+
+    for(auto &digest: digests)
+    {
+      int position = 0;
+      while(position < buffer.size())
+      {
+        const auto toHash = static_cast<int>(std::min<unsigned long long>(buffer.size() - position, digest->partSize - digest->partRead));
+        digest->part.addData(buffer.constData() + position, toHash);
+        digest->partRead += toHash;
+        position += toHash;
+
+        if(parts > 1 && digest->partRead == digest->partSize)
+        {
+          digest->etag.addData(digest->part.result());
+          digest->part.reset();
+          digest->partRead = 0;
+        }
+      }
+    }
+  }
+
+  for(auto &digest: digests)
+  {
+    if(parts <= 1)
+    {
+      etags << QString(digest->part.result().toHex());
+      continue;
+    }
+
+    if(digest->partRead > 0) digest->etag.addData(digest->part.result());
+    etags << QString("%1-%2").arg(QString(digest->etag.result().toHex())).arg(parts);
+  }
+
+  return etags;
+}
+
+//-----------------------------------------------------------------------------
+Aws::String AWSUtils::toAwsString(const QString& text)
+{
+  return Aws::String(text.toStdString().c_str(), text.length());
+}
+
+//-----------------------------------------------------------------------------
+QString AWSUtils::toQString(const Aws::String& text)
+{
+  return QString::fromLocal8Bit(text.c_str(), text.length());
+}
+
+//-----------------------------------------------------------------------------
+QString AWSUtils::operationTypeToText(const OperationType& type)
+{
+  switch(type)
+  {
+    case OperationType::download:
+      return "Download";
+      break;
+    case OperationType::remove:
+      return "Delete";
+      break;
+    case OperationType::upload:
+      return "Upload";
+      break;
+    case OperationType::move:
+      return "Move";
       break;
     default:
       break;
@@ -20,19 +20,33 @@
 #ifndef AWSUTILS_H_
 #define AWSUTILS_H_
 
+// Project
+#include <Utils/ChecksumUtils.h>
+#include <Utils/TransferUtils.h>
+
 // C++
 #include <vector>
+#include <random>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <winsock2.h>
 
 // AWS
 #include <aws/core/auth/AWSCredentialsProvider.h>
 #include <aws/core/auth/AWSCredentials.h>
 #include <aws/s3/model/Permission.h>
+#include <aws/s3/S3Errors.h>
+#include <aws/s3/S3Client.h>
 #include <aws/transfer/TransferManager.h>
+#include <aws/core/utils/threading/Executor.h>
 
 // Qt
 #include <QThread>
 #include <QMap>
+#include <QDir>
+#include <QTimer>
+#include <QStringList>
 
 namespace AWSUtils
 {
@@ -48,7 +62,18 @@ namespace AWSUtils
    */
   QString toQString(const Aws::String &text);
 
-  enum class OperationType: char { download = 0, upload, remove };
+  /** \brief Initializes the AWS SDK logging if it's not already initialized. Every call must
+   * be paired with a shutdownLogging() call.
+   *
+   */
+  void initializeLogging();
+
+  /** \brief Shuts down the AWS SDK logging when the last user ends.
+   *
+   */
+  void shutdownLogging();
+
+  enum class OperationType: char { download = 0, upload, remove, move };
 
   /** \brief Returns the text of the given operation.
    * \param[in] type Operation type.
@@ -64,19 +89,79 @@ namespace AWSUtils
 
   static const QString DELIMITER =  "/";
 
+  /** \struct RetryPolicy
+   * \brief Defines how failed requests of an operation are retried. Delays are computed
+   * with exponential backoff and full jitter.
+   *
+   */
+  struct RetryPolicy
+  {
+    unsigned int maxAttempts = 5;     /** maximum number of retries of a single object.            */
+    unsigned int baseDelay   = 250;   /** base delay of the backoff in milliseconds.               */
+    unsigned int maxDelay    = 20000; /** maximum delay of a single backoff in milliseconds.       */
+    unsigned int budget      = 200;   /** maximum number of retries for the whole operation.       */
+  };
+
+  /** \brief Returns true if the given error is transient and the request can be retried, and
+   * false if it's a fatal error (permissions, missing objects, invalid requests...).
+   * \param[in] error AWS S3 error.
+   *
+   */
+  bool isRetryable(const Aws::Client::AWSError<Aws::S3::S3Errors> &error);
+
+  /** \brief Returns the delay in milliseconds to wait before the given retry attempt.
+   * \param[in] policy Retry policy.
+   * \param[in] attempt Retry attempt number, starting at 0.
+   * \param[in] generator Random number generator for the jitter.
+   *
+   */
+  unsigned int backoffDelay(const RetryPolicy &policy, const unsigned int attempt, std::mt19937 &generator);
+
+  /** \brief Returns the possible ETags of the given local file, one for each usual part size that
+   * gives the given number of parts, starting with the part size of this application. Empty if
+   * the file can't be read.
+   * \param[in] fileName Absolute path of the file.
+   * \param[in] size Size of the file.
+   * \param[in] parts Number of parts of the multipart ETag or 0 if it's not multipart.
+   *
+   */
+  QStringList computeETags(const QString &fileName, const unsigned long long size, const unsigned int parts);
+
+  using SizesMap = std::unordered_map<std::string, unsigned long long>;
+
+  /** \struct ObjectChecksum
+   * \brief Checksums of a transferred object.
+   *
+   */
+  struct ObjectChecksum
+  {
+    QString  etag;   /** ETag of the object, without quotes. */
+    uint32_t crc32c; /** CRC32C of the object data.          */
+  };
+
+  using ChecksumsMap = std::unordered_map<std::string, ObjectChecksum>;
+
   /** \struct Operation
    * \brief Defines an operation over a bucket.
    *
    */
   struct Operation
   {
-    Aws::Auth::AWSCredentials                                credentials; /** S3 credentials.                             */
-    Aws::String                                              bucket;      /** S3 bucket.                                  */
-    Aws::String                                              region;      /** S3 region.                                  */
-    OperationType                                            type;        /** type of operation.                          */
-    std::vector<std::pair<std::string, unsigned long long>>  keys;        /** operation elements.                         */
-    Aws::String                                              parameters;  /** additional operation parameters.            */
-    bool                                                     useLogging;  /** true to log the operation, false otherwise. */
+    Aws::Auth::AWSCredentials                               credentials;       /** S3 credentials.                                              */
+    Aws::String                                             bucket;            /** S3 bucket.                                                   */
+    Aws::String                                             region;            /** S3 region.                                                   */
+    OperationType                                           type;              /** type of operation.                                           */
+    std::vector<std::pair<std::string, unsigned long long>> keys;              /** operation elements.                                          */
+    Aws::String                                             parameters;        /** additional operation parameters.                             */
+    bool                                                    useLogging;        /** true to log the operation, false otherwise.                  */
+    RetryPolicy                                             retryPolicy;       /** retry policy of failed requests.                             */
+    bool                                                    fullPaths = false; /** true to download the objects with their full key path.       */
+    bool                                                    sync = false;      /** true to transfer only the objects that differ.               */
+    bool                                                    verify = false;    /** true to confirm unchanged objects with the ETag.             */
+    bool                                                    checksums = true;  /** true to verify the checksums of the transferred data.        */
+    std::shared_ptr<const SizesMap>                         remoteSizes;       /** sizes of the objects in the bucket for uploads in sync mode. */
+    std::vector<std::string>                                destinations;      /** destination keys of a move, in the same order as the keys.   */
+    bool                                                    cache = false;     /** true to use the local cache of the downloaded objects.       */
   };
 
   /** \class S3Thread
@@ -125,12 +210,89 @@ namespace AWSUtils
        */
       bool isAborted() const;
 
+      /** \brief Returns the list of objects successfully processed and their sizes. Keys of
+       * the bucket for downloads, uploads and deletions, source keys for moves.
+       *
+       */
+      const std::vector<std::pair<std::string, unsigned long long>> &completed() const
+      { return m_completed; }
+
+      /** \brief Returns the keys of the directories created by an upload of local directories.
+       *
+       */
+      const std::vector<std::string> &directories() const
+      { return m_directories; }
+
+      /** \brief Sets the executor to use for the transfers. If not set the operation uses its own.
+       * \param[in] executor Executor shared pointer.
+       *
+       */
+      void setExecutor(std::shared_ptr<Aws::Utils::Threading::Executor> executor);
+
+      /** \brief Returns the number of retries done during the operation.
+       *
+       */
+      unsigned int retriesCount() const
+      { return m_retries; }
+
+      /** \brief Returns the time in milliseconds spent waiting between retries.
+       *
+       */
+      unsigned long long retriesTime() const
+      { return m_retriesTime; }
+
+      /** \brief Returns the number of unchanged objects skipped in sync mode.
+       *
+       */
+      unsigned long long skippedCount() const
+      { return m_skipped; }
+
+      /** \brief Returns the number of objects created from the local cache instead of downloaded.
+       *
+       */
+      unsigned long long cacheHits() const
+      { return m_cacheHits; }
+
+      /** \brief Returns the checksums of the objects transferred and verified, if the operation
+       * verifies the checksums.
+       *
+       */
+      const ChecksumsMap &checksums() const
+      { return m_checksums; }
+
     signals:
-      void progress(int);
       void globalProgress(int);
       void message(const QString &);
+      void progressSampled(const TransferUtils::ProgressSample &);
+
+    private slots:
+      /** \brief Samples the progress of the transfers and emits it.
+       *
+       */
+      void onSampleTimeout();
 
     private:
+      /** \struct SyncItem
+       * \brief Local file and object pair compared in sync mode.
+       *
+       */
+      struct SyncItem
+      {
+        QString            file;      /** absolute path of the local file.          */
+        Aws::String        key;       /** object key.                               */
+        unsigned long long size;      /** size of the object.                       */
+        unsigned long long localSize; /** size of the local file.                   */
+        bool               differs;   /** true if the object must be transferred.   */
+      };
+
+      /** \brief Compares in parallel the local files and the objects of the given items and marks
+       * the ones that differ. Items already marked are not compared.
+       * \param[in] items Items to compare.
+       * \param[in] client S3 client for the ETag requests.
+       *
+       */
+      void compare(std::vector<SyncItem> &items, std::shared_ptr<Aws::S3::S3Client> client);
+
       /** \brief Returns the index of the given key in the operation keys.
        * \param[in] key Text string.
        *
@@ -142,10 +304,114 @@ namespace AWSUtils
        */
       void waitUntilFinished(std::shared_ptr<Aws::Transfer::TransferHandle> handle);
 
-      const Operation            m_operation; /** operation structure.                                 */
-      QMap<QString, QStringList> m_errors;    /** maps objects with its errors, empty if successful.   */
-      bool                       m_abort;     /** true if the task needs to abort or has been aborted. */
-      unsigned int               m_fileCount; /** transfer files count.                                */
+      /** \brief Returns true if the failed request must be retried according to the operation
+       * retry policy, in that case waits the backoff time before returning. Thread safe.
+       * \param[in] error Error of the failed request.
+       * \param[in] attempt Retry attempt number of the object, starting at 0.
+       *
+       */
+      bool retry(const Aws::Client::AWSError<Aws::S3::S3Errors> &error, const unsigned int attempt);
+
+      /** \brief Returns true if the failed request must be retried according to the operation
+       * retry policy, in that case returns the backoff time without waiting it. Thread safe.
+       * \param[in] error Error of the failed request.
+       * \param[in] attempt Retry attempt number of the object, starting at 0.
+       * \param[out] delay Milliseconds to wait before retrying.
+       *
+       */
+      bool scheduleRetry(const Aws::Client::AWSError<Aws::S3::S3Errors> &error, const unsigned int attempt, unsigned int &delay);
+
+      /** \brief Returns the local file of the given key in the given path, or an empty string if the
+       * key is not valid for a local file.
+       * \param[in] path Download path.
+       * \param[in] key Object key.
+       *
+       */
+      QString localFile(const QDir &path, const std::string &key) const;
+
+      /** \brief Creates in parallel the local files of the given objects that are in the local cache,
+       * requesting the current ETag of the objects that have a cached version. Marks the created files.
+       * Every object counts as a lookup of the cache.
+       * \param[in] files Absolute paths of the files, empty if the object must not be downloaded.
+       * \param[out] cached True for the files created from the cache.
+       * \param[in] client S3 client for the ETag requests.
+       *
+       */
+      void restoreCached(const std::vector<QString> &files, std::vector<char> &cached, std::shared_ptr<Aws::S3::S3Client> client);
+
+      /** \brief Creates in parallel the directories of the given files that doesn't exist.
+       * \param[in] files Absolute paths of the files.
+       *
+       */
+      void createDirectories(const std::vector<QString> &files);
+
+      /** \brief Uploads the given file to the given key, retrying if needed. Updates the completed
+       * objects or the errors. Multipart uploads that fail or are cancelled are aborted.
+       * \param[in] manager Transfer manager.
+       * \param[in] client S3 client to abort the failed multipart uploads.
+       * \param[in] file Absolute path of the file on disk.
+       * \param[in] key Destination key.
+       * \param[in] size Size of the file in bytes.
+       *
+       */
+      void uploadFile(std::shared_ptr<Aws::Transfer::TransferManager> manager, std::shared_ptr<Aws::S3::S3Client> client,
+                      const std::string &file, const Aws::String &key, const unsigned long long size);
+
+      /** \brief Moves the objects of the operation to their destination keys. Objects are copied
+       * in parallel inside the bucket and then the sources of the copies are deleted in batches.
+       * \param[in] client S3 client.
+       *
+       */
+      void moveObjects(std::shared_ptr<Aws::S3::S3Client> client);
+
+      /** \brief Copies the given object inside the bucket, in parts if it's bigger than the maximum
+       * size of a single copy, retrying if needed. The current size of the object is requested
+       * before copying. Returns false and the error if it fails.
+       * \param[in] client S3 client.
+       * \param[in] source Source key.
+       * \param[in] destination Destination key.
+       * \param[in] size Size of the object in the tree, counted in the progress of the operation.
+       * \param[out] error Error of the failed request.
+       *
+       */
+      bool copyObject(std::shared_ptr<Aws::S3::S3Client> client, const Aws::String &source, const Aws::String &destination,
+                      const unsigned long long size, Aws::Client::AWSError<Aws::S3::S3Errors> &error);
+
+      /** \brief Verifies the checksum of the data of a completed transfer with the ETags returned
+       * by the server. Returns false and adds an error if they don't match. Transfers that can't be
+       * verified are considered valid.
+       * \param[in] handle Completed transfer handle.
+       * \param[in] checksum Checksum of the transferred data.
+       * \param[in] key Object key or file name of the errors.
+       * \param[in] size Size of the object in bytes.
+       *
+       */
+      bool verifyChecksum(std::shared_ptr<Aws::Transfer::TransferHandle> handle, ChecksumUtils::StreamChecksum &checksum,
+                          const std::string &key, const unsigned long long size);
+
+      /** \brief Adds the given error to the errors list of the given object.
+       * \param[in] key Object key or file name.
+       * \param[in] error AWS S3 error.
+       *
+       */
+      void addError(const std::string &key, const Aws::Client::AWSError<Aws::S3::S3Errors> &error);
+
+      const Operation                                         m_operation;   /** operation structure.                                 */
+      QMap<QString, QStringList>                              m_errors;      /** maps objects with its errors, empty if successful.   */
+      TransferUtils::CancellationToken                        m_token;       /** cancels the operation and its requests.              */
+      unsigned int                                            m_fileCount;   /** transfer files count.                                */
+      unsigned int                                            m_retries;     /** number of retries done in the operation.             */
+      unsigned long long                                      m_retriesTime; /** milliseconds spent waiting between retries.          */
+      unsigned long long                                      m_skipped;     /** number of unchanged objects skipped.                 */
+      unsigned long long                                      m_cacheHits;   /** number of objects created from the local cache.      */
+      std::mt19937                                            m_generator;   /** random generator for the backoff jitter.             */
+      std::mutex                                              m_retryMutex;  /** protects the retry counters and the generator.       */
+      std::shared_ptr<Aws::Utils::Threading::Executor>        m_executor;    /** transfers executor.                                  */
+      std::vector<std::pair<std::string, unsigned long long>> m_completed;   /** successfully processed objects.                      */
+      std::vector<std::string>                                m_directories; /** keys of the directories of an upload.                */
+      ChecksumsMap                                            m_checksums;   /** checksums of the verified objects.                   */
+      TransferUtils::ProgressTracker                          m_tracker;     /** progress of the transfers.                           */
+      QTimer                                                  m_sampler;     /** progress sampling timer, runs in the owner thread.   */
   };
 };
 
@@ -0,0 +1,360 @@
+/*
+ File: CacheUtils.cpp
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Project
+#include <Utils/CacheUtils.h>
+#include <Utils/Utils.h>
+#include <Utils/ChecksumUtils.h>
+
+// C++
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// Qt
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStringList>
+#include <QTextStream>
+
+// name of the index file in the cache directory.
+const QString INDEX_FILE = "index";
+
+//-----------------------------------------------------------------------------
+CacheUtils::ContentCache::ContentCache(const QString &path)
+: m_path    (path)
+, m_limit   {0}
+, m_size    {0}
+, m_hits    {0}
+, m_lookups {0}
+, m_modified{false}
+{
+  QDir().mkpath(m_path);
+
+  load();
+}
+
+//-----------------------------------------------------------------------------
+void CacheUtils::ContentCache::setLimit(const unsigned long long bytes)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_limit = bytes;
+  evict();
+}
+
+//-----------------------------------------------------------------------------
+unsigned long long CacheUtils::ContentCache::limit() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_limit;
+}
+
+//-----------------------------------------------------------------------------
+unsigned long long CacheUtils::ContentCache::size() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_size;
+}
+
+//-----------------------------------------------------------------------------
+unsigned long long CacheUtils::ContentCache::hits() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_hits;
+}
+
+//-----------------------------------------------------------------------------
+unsigned long long CacheUtils::ContentCache::lookups() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_lookups;
+}
+
+//-----------------------------------------------------------------------------
+double CacheUtils::ContentCache::hitRate() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_lookups == 0 ? 0. : static_cast<double>(m_hits) / m_lookups;
+}
+
+//-----------------------------------------------------------------------------
+bool CacheUtils::ContentCache::contains(const std::string &key) const
+{
+  const auto name = keyName(key);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_limit != 0 && m_keys.contains(name);
+}
+
+//-----------------------------------------------------------------------------
+bool CacheUtils::ContentCache::materialize(const std::string &key, const QString &etag, const QString &file)
+{
+  const auto name = entryName(key, etag);
+  const auto path = entryPath(name);
+  bool verified = false;
+  uint32_t crc  = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_limit == 0) return false;
+
+    ++m_lookups;
+    m_modified = true;
+
+    auto it = m_index.find(name);
+    if(it == m_index.end()) return false;
+
+    // downloaded files can be hard links of the entries, a modified file invalidates its entry.
+    auto entry = it.value();
+    QFileInfo info(path);
+    if(!info.exists() || static_cast<unsigned long long>(info.size()) != entry->size || info.lastModified().toMSecsSinceEpoch() != entry->modified)
+    {
+      remove(entry);
+      return false;
+    }
+
+    m_entries.splice(m_entries.begin(), m_entries, entry);
+    verified = entry->verified;
+    crc      = entry->crc32c;
+  }
+
+  // the data of the entry is checked outside the lock, a corrupted entry is downloaded again.
+  uint32_t current = 0;
+  if(verified && (!ChecksumUtils::fileCRC32C(path, current) || current != crc))
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(name);
+    if(it != m_index.end()) remove(it.value());
+
+    return false;
+  }
+
+  // the entry could be evicted meanwhile, then the link fails and the object is downloaded.
+  if(QFile::exists(file) && !QFile::remove(file)) return false;
+  if(!linkOrCopy(path, file)) return false;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_hits;
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void CacheUtils::ContentCache::addMisses(const unsigned long long count)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if(m_limit == 0 || count == 0) return;
+
+  m_lookups += count;
+  m_modified = true;
+}
+
+//-----------------------------------------------------------------------------
+void CacheUtils::ContentCache::insert(const std::string &key, const QString &etag, const QString &file, const uint32_t *crc32c)
+{
+  QFileInfo source(file);
+  if(!source.exists() || etag.isEmpty()) return;
+
+  const unsigned long long size = source.size();
+  const auto name = entryName(key, etag);
+  const auto path = entryPath(name);
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_limit == 0 || size > m_limit || m_index.contains(name)) return;
+  }
+
+  // files not in the index are leftovers.
+  QFile::remove(path);
+  if(!linkOrCopy(file, path)) return;
+
+  const auto modified = QFileInfo(path).lastModified().toMSecsSinceEpoch();
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if(m_index.contains(name)) return;
+
+  add(Entry{name, keyName(key), size, modified, crc32c != nullptr, crc32c ? *crc32c : 0});
+  m_entries.splice(m_entries.begin(), m_entries, std::prev(m_entries.end()));
+  m_modified = true;
+
+  evict();
+}
+
+//-----------------------------------------------------------------------------
+void CacheUtils::ContentCache::clear()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    while(!m_entries.empty()) remove(m_entries.begin());
+
+    m_hits     = 0;
+    m_lookups  = 0;
+    m_modified = true;
+  }
+
+  save();
+}
+
+//-----------------------------------------------------------------------------
+void CacheUtils::ContentCache::save()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if(!m_modified) return;
+
+  QSaveFile file(entryPath(INDEX_FILE));
+  if(!file.open(QIODevice::WriteOnly|QIODevice::Text)) return;
+
+  QTextStream stream(&file);
+  stream << m_hits << " " << m_lookups << "\n";
+  for(auto &entry: m_entries)
+  {
+    stream << entry.name << " " << entry.key << " " << entry.size << " " << entry.modified;
+    if(entry.verified) stream << " " << entry.crc32c;
+    stream << "\n";
+  }
+  stream.flush();
+
+  if(file.commit()) m_modified = false;
+}
+
+//-----------------------------------------------------------------------------
+QString CacheUtils::ContentCache::entryName(const std::string &key, const QString &etag)
+{
+  auto data = QByteArray(key.c_str(), key.length());
+  data.append('\n');
+  data.append(etag.toUtf8());
+
+  return QString(QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex());
+}
+
+//-----------------------------------------------------------------------------
+QString CacheUtils::ContentCache::keyName(const std::string &key)
+{
+  return QString(QCryptographicHash::hash(QByteArray(key.c_str(), key.length()), QCryptographicHash::Sha1).toHex());
+}
+
+//-----------------------------------------------------------------------------
+QString CacheUtils::ContentCache::entryPath(const QString &name) const
+{
+  return m_path + "/" + name;
+}
+
+//-----------------------------------------------------------------------------
+void CacheUtils::ContentCache::load()
+{
+  QFile file(entryPath(INDEX_FILE));
+  if(file.open(QIODevice::ReadOnly|QIODevice::Text))
+  {
+    QTextStream stream(&file);
+    stream >> m_hits >> m_lookups;
+    stream.readLine();
+
+    // the CRC32C is optional, entries without it aren't verified.
+    while(!stream.atEnd())
+    {
+      const auto fields = stream.readLine().split(' ', QString::SkipEmptyParts);
+      if(fields.size() < 4) continue;
+
+      Entry entry{fields.at(0), fields.at(1), fields.at(2).toULongLong(), fields.at(3).toLongLong(), fields.size() > 4, 0};
+      if(entry.verified) entry.crc32c = fields.at(4).toUInt(&entry.verified);
+      if(m_index.contains(entry.name)) continue;
+
+      QFileInfo info(entryPath(entry.name));
+      if(!info.exists() || static_cast<unsigned long long>(info.size()) != entry.size) continue;
+
+      add(entry);
+    }
+  }
+
+  // files of interrupted insertions or of entries lost with the index.
+  const auto files = QDir(m_path).entryList(QDir::Files);
+  for(auto &name: files)
+  {
+    if(name != INDEX_FILE && !m_index.contains(name)) QFile::remove(entryPath(name));
+  }
+}
+
+//-----------------------------------------------------------------------------
+void CacheUtils::ContentCache::add(const Entry &entry)
+{
+  m_entries.push_back(entry);
+  m_index.insert(entry.name, std::prev(m_entries.end()));
+  m_keys[entry.key] += 1;
+  m_size += entry.size;
+}
+
+//-----------------------------------------------------------------------------
+void CacheUtils::ContentCache::remove(Entries::iterator it)
+{
+  QFile::remove(entryPath(it->name));
+
+  auto count = m_keys.find(it->key);
+  if(count != m_keys.end() && --count.value() == 0) m_keys.erase(count);
+
+  m_size -= it->size;
+  m_index.remove(it->name);
+  m_entries.erase(it);
+  m_modified = true;
+}
+
+//-----------------------------------------------------------------------------
+void CacheUtils::ContentCache::evict()
+{
+  while(m_size > m_limit && !m_entries.empty())
+  {
+    remove(std::prev(m_entries.end()));
+  }
+}
+
+//-----------------------------------------------------------------------------
+std::shared_ptr<CacheUtils::ContentCache> CacheUtils::contentCache()
+{
+  static auto cache = std::make_shared<ContentCache>(Utils::dataPath() + "/cache");
+
+  return cache;
+}
+
+//-----------------------------------------------------------------------------
+bool CacheUtils::linkOrCopy(const QString &source, const QString &destination)
+{
+#ifdef _WIN32
+  const auto sourceName      = QDir::toNativeSeparators(source);
+  const auto destinationName = QDir::toNativeSeparators(destination);
+  if(CreateHardLinkW(reinterpret_cast<LPCWSTR>(destinationName.utf16()), reinterpret_cast<LPCWSTR>(sourceName.utf16()), nullptr)) return true;
+#else
+  if(::link(QFile::encodeName(source).constData(), QFile::encodeName(destination).constData()) == 0) return true;
+#endif
+
+  // different volumes or a file system without hard links.
+  return QFile::copy(source, destination);
+}
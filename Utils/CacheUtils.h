@@ -0,0 +1,217 @@
+/*
+ File: CacheUtils.h
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CACHEUTILS_H_
+#define CACHEUTILS_H_
+
+// C++
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Qt
+#include <QHash>
+#include <QString>
+
+namespace CacheUtils
+{
+  /** \class ContentCache
+   * \brief On disk cache of the downloaded objects. Entries are identified by the key and the
+   * ETag of the object, so a modified object never matches an old entry. The least recently
+   * used entries are evicted when the cache exceeds its size limit. Thread safe.
+   *
+   */
+  class ContentCache
+  {
+    public:
+      /** \brief ContentCache class constructor.
+       * \param[in] path Directory of the cache files.
+       *
+       */
+      explicit ContentCache(const QString &path);
+
+      /** \brief ContentCache class destructor.
+       *
+       */
+      ~ContentCache()
+      {};
+
+      /** \brief Sets the size limit of the cache in bytes, 0 disables the cache. Evicts the entries
+       * over the new limit.
+       * \param[in] bytes Size limit in bytes.
+       *
+       */
+      void setLimit(const unsigned long long bytes);
+
+      /** \brief Returns the size limit of the cache in bytes.
+       *
+       */
+      unsigned long long limit() const;
+
+      /** \brief Returns the size of the cached objects in bytes.
+       *
+       */
+      unsigned long long size() const;
+
+      /** \brief Returns the number of lookups served from the cache.
+       *
+       */
+      unsigned long long hits() const;
+
+      /** \brief Returns the number of lookups.
+       *
+       */
+      unsigned long long lookups() const;
+
+      /** \brief Returns the ratio of lookups served from the cache, in [0,1].
+       *
+       */
+      double hitRate() const;
+
+      /** \brief Returns true if the cache has an entry of any version of the object with the given key.
+       * \param[in] key Object key.
+       *
+       */
+      bool contains(const std::string &key) const;
+
+      /** \brief Creates the given file from the cached object of the given key and ETag. Entries with
+       * a checksum are verified first, a corrupted entry is removed. Returns false if the object is
+       * not in the cache or the file can't be created.
+       * \param[in] key Object key.
+       * \param[in] etag Object ETag.
+       * \param[in] file Absolute path of the file to create.
+       *
+       */
+      bool materialize(const std::string &key, const QString &etag, const QString &file);
+
+      /** \brief Counts the given number of lookups of objects that aren't in the cache, the ones
+       * rejected before calling materialize. Ignored if the cache is disabled.
+       * \param[in] count Number of lookups.
+       *
+       */
+      void addMisses(const unsigned long long count);
+
+      /** \brief Adds the given downloaded file to the cache as the object with the given key and ETag.
+       * \param[in] key Object key.
+       * \param[in] etag Object ETag.
+       * \param[in] file Absolute path of the downloaded file.
+       * \param[in] crc32c CRC32C of the verified data or nullptr if the data hasn't been verified.
+       *
+       */
+      void insert(const std::string &key, const QString &etag, const QString &file, const uint32_t *crc32c = nullptr);
+
+      /** \brief Removes all the cached objects and resets the statistics.
+       *
+       */
+      void clear();
+
+      /** \brief Writes the index of the cache to disk if it has been modified.
+       *
+       */
+      void save();
+
+    private:
+      /** \struct Entry
+       * \brief Cached object.
+       *
+       */
+      struct Entry
+      {
+        QString            name;     /** file name of the entry.                 */
+        QString            key;      /** hash of the object key.                 */
+        unsigned long long size;     /** size of the object in bytes.            */
+        long long          modified; /** modification time of the file, in ms.   */
+        bool               verified; /** true if the CRC32C of the data is known. */
+        uint32_t           crc32c;   /** CRC32C of the data of a verified entry. */
+      };
+
+      using Entries = std::list<Entry>;
+
+      /** \brief Returns the file name of the entry of the given key and ETag.
+       * \param[in] key Object key.
+       * \param[in] etag Object ETag.
+       *
+       */
+      static QString entryName(const std::string &key, const QString &etag);
+
+      /** \brief Returns the hash of the given object key.
+       * \param[in] key Object key.
+       *
+       */
+      static QString keyName(const std::string &key);
+
+      /** \brief Adds the given entry to the index as the least recently used one. Must be called
+       * with the mutex locked.
+       * \param[in] entry Cache entry.
+       *
+       */
+      void add(const Entry &entry);
+
+      /** \brief Returns the absolute path of the given entry file name.
+       * \param[in] name Entry file name.
+       *
+       */
+      QString entryPath(const QString &name) const;
+
+      /** \brief Reads the index of the cache and removes the files that are not in it.
+       *
+       */
+      void load();
+
+      /** \brief Removes the given entry and its file. Must be called with the mutex locked.
+       * \param[in] it Entry iterator.
+       *
+       */
+      void remove(Entries::iterator it);
+
+      /** \brief Removes the least recently used entries until the cache fits in its limit. Must be
+       * called with the mutex locked.
+       *
+       */
+      void evict();
+
+      mutable std::mutex                m_mutex;    /** protects the entries and counters.     */
+      const QString                     m_path;     /** directory of the cache files.          */
+      unsigned long long                m_limit;    /** size limit in bytes, 0 if disabled.    */
+      unsigned long long                m_size;     /** size of the entries in bytes.          */
+      unsigned long long                m_hits;     /** lookups served from the cache.         */
+      unsigned long long                m_lookups;  /** number of lookups.                     */
+      bool                              m_modified; /** true if the index must be saved.       */
+      Entries                           m_entries;  /** entries, the most recently used first. */
+      QHash<QString, Entries::iterator> m_index;    /** entries by file name.                  */
+      QHash<QString, unsigned int>      m_keys;     /** number of entries by key hash.         */
+  };
+
+  /** \brief Returns the cache of the downloaded objects, in the application data path.
+   *
+   */
+  std::shared_ptr<ContentCache> contentCache();
+
+  /** \brief Creates the destination file as a hard link of the source file, or as a copy if the
+   * file system doesn't support it. Returns true on success.
+   * \param[in] source Absolute path of the existing file.
+   * \param[in] destination Absolute path of the file to create.
+   *
+   */
+  bool linkOrCopy(const QString &source, const QString &destination);
+};
+
+#endif // CACHEUTILS_H_
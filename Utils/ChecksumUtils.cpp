@@ -0,0 +1,456 @@
+/*
+ File: ChecksumUtils.cpp
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Project
+#include <Utils/ChecksumUtils.h>
+
+// C++
+#include <algorithm>
+#include <cstring>
+
+// Qt
+#include <QFile>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CRC32C_HARDWARE
+#include <nmmintrin.h>
+#endif
+
+// size of the read buffer of the checksum streams.
+const std::size_t READ_BUFFER_SIZE = 256*1024;
+
+// CRC32C (Castagnoli) reversed polynomial.
+const uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;
+
+/** \brief Slicing-by-8 tables of the software CRC32C.
+ *
+ */
+struct CRC32CTables
+{
+    uint32_t table[8][256];
+
+    CRC32CTables()
+    {
+      for(uint32_t i = 0; i < 256; ++i)
+      {
+        uint32_t crc = i;
+        for(int j = 0; j < 8; ++j) crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLYNOMIAL : crc >> 1;
+        table[0][i] = crc;
+      }
+
+      for(uint32_t i = 0; i < 256; ++i)
+      {
+        for(int j = 1; j < 8; ++j) table[j][i] = (table[j-1][i] >> 8) ^ table[0][table[j-1][i] & 0xFF];
+      }
+    }
+};
+
+//-----------------------------------------------------------------------------
+static uint32_t crc32cSoftware(uint32_t crc, const unsigned char *data, std::size_t length)
+{
+  static const CRC32CTables tables;
+  const auto &t = tables.table;
+
+  while(length >= 8)
+  {
+    uint32_t low, high;
+    std::memcpy(&low, data, 4);
+    std::memcpy(&high, data + 4, 4);
+    low ^= crc;
+
+    crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+          t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+
+    data += 8;
+    length -= 8;
+  }
+
+  while(length-- > 0) crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+
+  return crc;
+}
+
+#ifdef CRC32C_HARDWARE
+//-----------------------------------------------------------------------------
+__attribute__((target("sse4.2")))
+static uint32_t crc32cHardware(uint32_t crc, const unsigned char *data, std::size_t length)
+{
+  while(length > 0 && (reinterpret_cast<std::uintptr_t>(data) & 7) != 0)
+  {
+    crc = _mm_crc32_u8(crc, *data++);
+    --length;
+  }
+
+#if defined(__x86_64__)
+  uint64_t crc64 = crc;
+  while(length >= 8)
+  {
+    uint64_t value;
+    std::memcpy(&value, data, 8);
+    crc64 = _mm_crc32_u64(crc64, value);
+    data += 8;
+    length -= 8;
+  }
+  crc = static_cast<uint32_t>(crc64);
+#else
+  while(length >= 4)
+  {
+    uint32_t value;
+    std::memcpy(&value, data, 4);
+    crc = _mm_crc32_u32(crc, value);
+    data += 4;
+    length -= 4;
+  }
+#endif
+
+  while(length-- > 0) crc = _mm_crc32_u8(crc, *data++);
+
+  return crc;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+bool ChecksumUtils::hasHardwareCRC32C()
+{
+#ifdef CRC32C_HARDWARE
+  static const bool supported = __builtin_cpu_supports("sse4.2");
+  return supported;
+#else
+  return false;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+uint32_t ChecksumUtils::crc32c(uint32_t crc, const char *data, std::size_t length)
+{
+  auto bytes = reinterpret_cast<const unsigned char *>(data);
+
+#ifdef CRC32C_HARDWARE
+  if(hasHardwareCRC32C()) return ~crc32cHardware(~crc, bytes, length);
+#endif
+
+  return ~crc32cSoftware(~crc, bytes, length);
+}
+
+//-----------------------------------------------------------------------------
+bool ChecksumUtils::fileCRC32C(const QString &fileName, uint32_t &crc)
+{
+  QFile file(fileName);
+  if(!file.open(QIODevice::ReadOnly)) return false;
+
+  std::vector<char> buffer(READ_BUFFER_SIZE);
+  crc = 0;
+  qint64 read;
+  while((read = file.read(buffer.data(), buffer.size())) > 0)
+  {
+    crc = ChecksumUtils::crc32c(crc, buffer.data(), static_cast<std::size_t>(read));
+  }
+
+  return read == 0;
+}
+
+//-----------------------------------------------------------------------------
+ChecksumUtils::StreamChecksum::StreamChecksum(const unsigned long long partSize, const bool wholeDigest)
+: m_partSize   {std::max(1ULL, partSize)}
+, m_wholeDigest{wholeDigest}
+, m_part       {QCryptographicHash::Md5}
+, m_whole      {QCryptographicHash::Md5}
+, m_partRead   {0}
+, m_hashed     {0}
+, m_crc        {0}
+{
+}
+
+//-----------------------------------------------------------------------------
+void ChecksumUtils::StreamChecksum::add(const unsigned long long offset, const char *data, const std::size_t length)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  const auto end = offset + length;
+  if(end <= m_hashed || length == 0) return;
+
+  if(offset > m_hashed)
+  {
+    auto &block = m_pending[offset];
+    if(block.size() < length) block.assign(data, length);
+    return;
+  }
+
+  hash(data + (m_hashed - offset), end - m_hashed);
+
+  // blocks that were waiting for this one.
+  auto it = m_pending.begin();
+  while(it != m_pending.end() && (*it).first <= m_hashed)
+  {
+    const auto blockEnd = (*it).first + (*it).second.size();
+    if(blockEnd > m_hashed) hash((*it).second.data() + (m_hashed - (*it).first), blockEnd - m_hashed);
+
+    it = m_pending.erase(it);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void ChecksumUtils::StreamChecksum::reset()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_part.reset();
+  m_whole.reset();
+  m_partRead = 0;
+  m_hashed   = 0;
+  m_crc      = 0;
+  m_parts.clear();
+  m_wholeResult.clear();
+  m_pending.clear();
+}
+
+//-----------------------------------------------------------------------------
+unsigned long long ChecksumUtils::StreamChecksum::size() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_hashed;
+}
+
+//-----------------------------------------------------------------------------
+QString ChecksumUtils::StreamChecksum::etag()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  finishPart();
+
+  if(m_parts.size() <= 1) return QString(m_parts.front().toHex());
+
+  QCryptographicHash etagHash(QCryptographicHash::Md5);
+  std::for_each(m_parts.cbegin(), m_parts.cend(), [&etagHash](const QByteArray &part) { etagHash.addData(part); });
+
+  return QString("%1-%2").arg(QString(etagHash.result().toHex())).arg(m_parts.size());
+}
+
+//-----------------------------------------------------------------------------
+QString ChecksumUtils::StreamChecksum::md5()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  finishPart();
+
+  if(m_parts.size() <= 1) return QString(m_parts.front().toHex());
+  if(!m_wholeDigest) return QString();
+
+  if(m_wholeResult.isEmpty()) m_wholeResult = m_whole.result();
+
+  return QString(m_wholeResult.toHex());
+}
+
+//-----------------------------------------------------------------------------
+QString ChecksumUtils::StreamChecksum::partMD5(const unsigned int part)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  finishPart();
+
+  if(part >= m_parts.size()) return QString();
+
+  return QString(m_parts.at(part).toHex());
+}
+
+//-----------------------------------------------------------------------------
+unsigned int ChecksumUtils::StreamChecksum::partsCount()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  finishPart();
+
+  return m_parts.size();
+}
+
+//-----------------------------------------------------------------------------
+uint32_t ChecksumUtils::StreamChecksum::crc32c() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_crc;
+}
+
+//-----------------------------------------------------------------------------
+void ChecksumUtils::StreamChecksum::hash(const char *data, std::size_t length)
+{
+  m_crc = ChecksumUtils::crc32c(m_crc, data, length);
+  if(m_wholeDigest) m_whole.addData(data, length);
+  m_hashed += length;
+
+  while(length > 0)
+  {
+    const auto toHash = static_cast<std::size_t>(std::min<unsigned long long>(length, m_partSize - m_partRead));
+    m_part.addData(data, toHash);
+    m_partRead += toHash;
+    data += toHash;
+    length -= toHash;
+
+    if(m_partRead == m_partSize)
+    {
+      m_parts.push_back(m_part.result());
+      m_part.reset();
+      m_partRead = 0;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void ChecksumUtils::StreamChecksum::finishPart()
+{
+  // an empty file is a single empty part.
+  if(m_partRead > 0 || m_parts.empty())
+  {
+    m_parts.push_back(m_part.result());
+    m_part.reset();
+    m_partRead = 0;
+  }
+}
+
+//-----------------------------------------------------------------------------
+ChecksumUtils::ChecksumStreamBuf::ChecksumStreamBuf(const std::string &fileName, std::ios_base::openmode mode, std::shared_ptr<StreamChecksum> checksum)
+: m_checksum{checksum}
+, m_readPos {0}
+, m_writePos{0}
+{
+  m_file.open(fileName.c_str(), mode|std::ios_base::binary);
+
+  setg(nullptr, nullptr, nullptr);
+  setp(nullptr, nullptr);
+}
+
+//-----------------------------------------------------------------------------
+ChecksumUtils::ChecksumStreamBuf::int_type ChecksumUtils::ChecksumStreamBuf::underflow()
+{
+  if(gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+  // big reads don't use the buffer, most streams never need it.
+  if(!m_buffer.data()) m_buffer = TransferUtils::bufferPool()->acquire(READ_BUFFER_SIZE);
+
+  const auto read = m_file.sgetn(m_buffer.data(), m_buffer.size());
+  if(read <= 0) return traits_type::eof();
+
+  m_checksum->add(m_readPos, m_buffer.data(), read);
+  m_readPos += read;
+
+  setg(m_buffer.data(), m_buffer.data(), m_buffer.data() + read);
+
+  return traits_type::to_int_type(*gptr());
+}
+
+//-----------------------------------------------------------------------------
+std::streamsize ChecksumUtils::ChecksumStreamBuf::xsgetn(char *s, std::streamsize count)
+{
+  std::streamsize total = 0;
+
+  // data already in the buffer.
+  const auto available = std::min<std::streamsize>(egptr() - gptr(), count);
+  if(available > 0)
+  {
+    std::memcpy(s, gptr(), available);
+    gbump(static_cast<int>(available));
+    total += available;
+  }
+
+  // big reads go directly to the caller memory.
+  if(total < count)
+  {
+    const auto read = m_file.sgetn(s + total, count - total);
+    if(read > 0)
+    {
+      m_checksum->add(m_readPos, s + total, read);
+      m_readPos += read;
+      total += read;
+    }
+  }
+
+  return total;
+}
+
+//-----------------------------------------------------------------------------
+ChecksumUtils::ChecksumStreamBuf::int_type ChecksumUtils::ChecksumStreamBuf::overflow(int_type c)
+{
+  if(traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+
+  const char value = traits_type::to_char_type(c);
+  return xsputn(&value, 1) == 1 ? c : traits_type::eof();
+}
+
+//-----------------------------------------------------------------------------
+std::streamsize ChecksumUtils::ChecksumStreamBuf::xsputn(const char *s, std::streamsize count)
+{
+  const auto written = m_file.sputn(s, count);
+  if(written > 0)
+  {
+    m_checksum->add(m_writePos, s, written);
+    m_writePos += written;
+  }
+
+  return written;
+}
+
+//-----------------------------------------------------------------------------
+ChecksumUtils::ChecksumStreamBuf::pos_type ChecksumUtils::ChecksumStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+  // current read position is the end of the buffer minus the unread data.
+  if(dir == std::ios_base::cur)
+  {
+    const unsigned long long current = (which & std::ios_base::in) ? m_readPos - (egptr() - gptr()) : m_writePos;
+    return seekpos(pos_type(current + off), which);
+  }
+
+  const auto position = m_file.pubseekoff(off, dir, which);
+  if(position == pos_type(off_type(-1))) return position;
+
+  return seekpos(position, which);
+}
+
+//-----------------------------------------------------------------------------
+ChecksumUtils::ChecksumStreamBuf::pos_type ChecksumUtils::ChecksumStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+  const auto position = m_file.pubseekpos(pos, which);
+  if(position == pos_type(off_type(-1))) return position;
+
+  if(which & std::ios_base::in)
+  {
+    m_readPos = static_cast<unsigned long long>(position);
+    setg(m_buffer.data(), m_buffer.data(), m_buffer.data());
+  }
+
+  if(which & std::ios_base::out) m_writePos = static_cast<unsigned long long>(position);
+
+  return position;
+}
+
+//-----------------------------------------------------------------------------
+int ChecksumUtils::ChecksumStreamBuf::sync()
+{
+  return m_file.pubsync();
+}
+
+//-----------------------------------------------------------------------------
+ChecksumUtils::ChecksumStream::ChecksumStream(const std::string &fileName, std::ios_base::openmode mode, std::shared_ptr<StreamChecksum> checksum)
+: std::iostream(nullptr)
+, m_buffer(fileName, mode, checksum)
+{
+  rdbuf(&m_buffer);
+
+  if(!m_buffer.isOpen()) setstate(std::ios_base::failbit);
+}
@@ -0,0 +1,225 @@
+/*
+ File: ChecksumUtils.h
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHECKSUMUTILS_H_
+#define CHECKSUMUTILS_H_
+
+// Project
+#include <Utils/TransferUtils.h>
+
+// C++
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Qt
+#include <QCryptographicHash>
+#include <QByteArray>
+#include <QString>
+
+namespace ChecksumUtils
+{
+  /** \brief Updates the given CRC32C (Castagnoli) with the given data and returns it. Uses the
+   * SSE4.2 crc32 instruction when the processor supports it.
+   * \param[in] crc Previous CRC value, 0 for the first block.
+   * \param[in] data Data pointer.
+   * \param[in] length Data length in bytes.
+   *
+   */
+  uint32_t crc32c(uint32_t crc, const char *data, std::size_t length);
+
+  /** \brief Returns true if the CRC32C is computed using the processor instructions.
+   *
+   */
+  bool hasHardwareCRC32C();
+
+  /** \brief Computes the CRC32C of the contents of the given file. Returns false if it can't be read.
+   * \param[in] fileName Absolute path of the file.
+   * \param[out] crc CRC32C of the file.
+   *
+   */
+  bool fileCRC32C(const QString &fileName, uint32_t &crc);
+
+  /** \class StreamChecksum
+   * \brief Computes the MD5 of the parts, the MD5 of the whole data and the CRC32C of a file
+   * while it's being read or written. Blocks arriving out of order are kept until the previous
+   * data arrives, and blocks already hashed are ignored, so the streams can be seeked back for
+   * retries.
+   *
+   */
+  class StreamChecksum
+  {
+    public:
+      /** \brief StreamChecksum class constructor.
+       * \param[in] partSize Part size of the multipart ETag.
+       * \param[in] wholeDigest True to compute also the MD5 of the whole data.
+       *
+       */
+      explicit StreamChecksum(const unsigned long long partSize, const bool wholeDigest);
+
+      /** \brief Adds the given data block at the given offset.
+       * \param[in] offset Offset of the block in the file.
+       * \param[in] data Data pointer.
+       * \param[in] length Data length in bytes.
+       *
+       */
+      void add(const unsigned long long offset, const char *data, const std::size_t length);
+
+      /** \brief Discards the computed values.
+       *
+       */
+      void reset();
+
+      /** \brief Returns the number of contiguous bytes hashed from the start.
+       *
+       */
+      unsigned long long size() const;
+
+      /** \brief Returns the ETag of the data, multipart if there is more than one part. Must be
+       * called once all the data has been added.
+       *
+       */
+      QString etag();
+
+      /** \brief Returns the MD5 of the whole data. Must be called once all the data has been added.
+       *
+       */
+      QString md5();
+
+      /** \brief Returns the MD5 of the given part, 0 based. Must be called once all the data has been added.
+       * \param[in] part Part index.
+       *
+       */
+      QString partMD5(const unsigned int part);
+
+      /** \brief Returns the number of parts.
+       *
+       */
+      unsigned int partsCount();
+
+      /** \brief Returns the CRC32C of the data.
+       *
+       */
+      uint32_t crc32c() const;
+
+    private:
+      /** \brief Hashes the given contiguous block.
+       * \param[in] data Data pointer.
+       * \param[in] length Data length in bytes.
+       *
+       */
+      void hash(const char *data, std::size_t length);
+
+      /** \brief Finishes the digest of the current part.
+       *
+       */
+      void finishPart();
+
+      const unsigned long long                   m_partSize;    /** size of the parts.                           */
+      const bool                                 m_wholeDigest; /** true to compute the MD5 of the whole data.   */
+      mutable std::mutex                         m_mutex;       /** protects the state, writes can be concurrent. */
+      QCryptographicHash                         m_part;        /** MD5 of the current part.                     */
+      QCryptographicHash                         m_whole;       /** MD5 of the whole data.                       */
+      unsigned long long                         m_partRead;    /** bytes hashed of the current part.            */
+      unsigned long long                         m_hashed;      /** contiguous bytes hashed.                     */
+      uint32_t                                   m_crc;         /** CRC32C of the data.                          */
+      std::vector<QByteArray>                    m_parts;       /** MD5 of the finished parts.                   */
+      QByteArray                                 m_wholeResult; /** MD5 of the whole data when finished.         */
+      std::map<unsigned long long, std::string>  m_pending;     /** blocks waiting for the previous data.        */
+  };
+
+  /** \class ChecksumStreamBuf
+   * \brief File stream buffer that adds the data read or written to a StreamChecksum.
+   *
+   */
+  class ChecksumStreamBuf
+  : public std::streambuf
+  {
+    public:
+      /** \brief ChecksumStreamBuf class constructor.
+       * \param[in] fileName Name of the file.
+       * \param[in] mode Open mode.
+       * \param[in] checksum Checksum to update.
+       *
+       */
+      explicit ChecksumStreamBuf(const std::string &fileName, std::ios_base::openmode mode, std::shared_ptr<StreamChecksum> checksum);
+
+      /** \brief ChecksumStreamBuf class virtual destructor.
+       *
+       */
+      virtual ~ChecksumStreamBuf()
+      {};
+
+      /** \brief Returns true if the file is open.
+       *
+       */
+      bool isOpen() const
+      { return m_file.is_open(); }
+
+    protected:
+      virtual int_type underflow() override;
+      virtual std::streamsize xsgetn(char *s, std::streamsize count) override;
+      virtual int_type overflow(int_type c) override;
+      virtual std::streamsize xsputn(const char *s, std::streamsize count) override;
+      virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+      virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+      virtual int sync() override;
+
+    private:
+      std::filebuf                      m_file;     /** file buffer.                                */
+      std::shared_ptr<StreamChecksum>   m_checksum; /** checksum of the data.                       */
+      TransferUtils::BufferPool::Buffer m_buffer;   /** read buffer, taken from the pool if needed. */
+      unsigned long long                m_readPos;  /** file offset of the end of the buffer.       */
+      unsigned long long                m_writePos; /** file offset of the next write.              */
+  };
+
+  /** \class ChecksumStream
+   * \brief File stream that computes the checksums of the data read or written.
+   *
+   */
+  class ChecksumStream
+  : public std::iostream
+  {
+    public:
+      /** \brief ChecksumStream class constructor.
+       * \param[in] fileName Name of the file.
+       * \param[in] mode Open mode.
+       * \param[in] checksum Checksum to update.
+       *
+       */
+      explicit ChecksumStream(const std::string &fileName, std::ios_base::openmode mode, std::shared_ptr<StreamChecksum> checksum);
+
+      /** \brief ChecksumStream class virtual destructor.
+       *
+       */
+      virtual ~ChecksumStream()
+      {};
+
+    private:
+      ChecksumStreamBuf m_buffer; /** checksum stream buffer. */
+  };
+};
+
+#endif // CHECKSUMUTILS_H_
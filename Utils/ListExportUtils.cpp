@@ -21,57 +21,962 @@
 #include <Utils/ListExportUtils.h>
 
 // C++
-#include <fstream>
 #include <algorithm>
+#include <cstring>
+#include <unordered_map>
 
 // xlslib
 #include <common/xlconfig.h>
 #include <xlslib.h>
 
 // Qt
+#include <QDateTime>
 #include <QString>
+#include <QTemporaryFile>
 
 using namespace xlslib_core;
 
+// size of the buffers of the compressed data.
+const std::size_t DEFLATE_BUFFER = 256*1024;
+
+// sizes and offsets from this value need the zip64 extensions.
+const unsigned long long ZIP64_LIMIT = 0xFFFFFFFF;
+
+// maximum number of rows of a sheet, including the header.
+const unsigned long long SHEET_ROWS = 1048576;
+
+// number of rows written between progress updates.
+const unsigned long long PROGRESS_ROWS = 4096;
+
+// milliseconds between progress samples of the exports.
+const int SAMPLE_INTERVAL = 500;
+
+// maximum number of distinct names reused from the shared strings.
+const std::size_t SHARED_NAMES = 65536;
+
+// declaration of the XML parts of the XLSX files.
+const char XML_HEADER[] = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n";
+
+// namespaces of the XLSX parts.
+#define SPREADSHEET_NS           "http://schemas.openxmlformats.org/spreadsheetml/2006/main"
+#define RELATIONSHIPS_NS         "http://schemas.openxmlformats.org/officeDocument/2006/relationships"
+#define PACKAGE_RELATIONSHIPS_NS "http://schemas.openxmlformats.org/package/2006/relationships"
+
+//-----------------------------------------------------------------------------
+ListExportUtils::BufferedWriter::BufferedWriter(const QString &filename, const std::size_t capacity)
+: m_file   (filename)
+, m_device {&m_file}
+, m_buffer (capacity)
+, m_used   {0}
+, m_written{0}
+, m_failed {false}
+{
+  // the buffer makes the file buffering redundant.
+  m_file.open(QIODevice::WriteOnly|QIODevice::Truncate|QIODevice::Unbuffered);
+}
+
 //-----------------------------------------------------------------------------
-bool ListExportUtils::saveToCSV(const std::string& filename, const std::vector<std::pair<std::string, unsigned long long> >& contents)
+ListExportUtils::BufferedWriter::BufferedWriter(QIODevice *device, const std::size_t capacity)
+: m_device {device}
+, m_buffer (capacity)
+, m_used   {0}
+, m_written{0}
+, m_failed {false}
 {
-  std::ofstream file(filename, std::ios_base::out|std::ios_base::trunc);
+}
 
-  if(file.is_open())
+//-----------------------------------------------------------------------------
+ListExportUtils::BufferedWriter::~BufferedWriter()
+{
+  close();
+}
+
+//-----------------------------------------------------------------------------
+void ListExportUtils::BufferedWriter::write(const char *data, const std::size_t length)
+{
+  if(m_used + length > m_buffer.size())
   {
-    file << "Name, Size" << std::endl;
+    flush();
 
-    auto writeLine = [&file](const std::pair<std::string, unsigned long long> &p)
+    // data bigger than the buffer is written directly.
+    if(length > m_buffer.size())
     {
-      file << "\"" << p.first << "\", " << p.second << std::endl;
-    };
-    std::for_each(contents.cbegin(), contents.cend(), writeLine);
+      if(!m_device->isOpen() || m_device->write(data, length) != static_cast<qint64>(length)) m_failed = true;
+      m_written += length;
+      return;
+    }
+  }
+
+  std::memcpy(m_buffer.data() + m_used, data, length);
+  m_used += length;
+}
+
+//-----------------------------------------------------------------------------
+void ListExportUtils::BufferedWriter::writeNumber(unsigned long long value)
+{
+  char digits[20];
+  int i = sizeof(digits);
+  do
+  {
+    digits[--i] = '0' + (value % 10);
+    value /= 10;
+  }
+  while(value != 0);
+
+  write(digits + i, sizeof(digits) - i);
+}
+
+//-----------------------------------------------------------------------------
+bool ListExportUtils::BufferedWriter::close()
+{
+  if(m_device->isOpen())
+  {
+    flush();
+    if(m_device == &m_file) m_file.close();
+  }
+  else
+  {
+    m_failed = true;
+  }
 
-    file.close();
-    return true;
+  return !m_failed;
+}
+
+//-----------------------------------------------------------------------------
+void ListExportUtils::BufferedWriter::flush()
+{
+  if(m_used == 0) return;
+
+  if(!m_device->isOpen() || m_device->write(m_buffer.data(), m_used) != static_cast<qint64>(m_used)) m_failed = true;
+  m_written += m_used;
+  m_used = 0;
+}
+
+//-----------------------------------------------------------------------------
+ListExportUtils::DeflateWriter::DeflateWriter(BufferedWriter &output)
+: m_output{output}
+, m_stream{new z_stream()}
+, m_input (DEFLATE_BUFFER)
+, m_chunk (DEFLATE_BUFFER)
+, m_used  {0}
+, m_size  {0}
+, m_start {output.written()}
+, m_crc   {0}
+{
+  // raw deflate stream without zlib header, the fastest level keeps the export close to the disk speed.
+  if(deflateInit2(m_stream.get(), Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+  {
+    m_stream.reset();
+    m_output.fail();
+  }
+}
+
+//-----------------------------------------------------------------------------
+ListExportUtils::DeflateWriter::~DeflateWriter()
+{
+  if(m_stream) deflateEnd(m_stream.get());
+}
+
+//-----------------------------------------------------------------------------
+void ListExportUtils::DeflateWriter::write(const char *data, const std::size_t length)
+{
+  std::size_t written = 0;
+  while(written < length)
+  {
+    if(m_used == m_input.size()) compress(false);
+
+    const auto bytes = std::min(length - written, m_input.size() - m_used);
+    std::memcpy(m_input.data() + m_used, data + written, bytes);
+    m_used  += bytes;
+    written += bytes;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void ListExportUtils::DeflateWriter::writeNumber(unsigned long long value)
+{
+  char digits[20];
+  int i = sizeof(digits);
+  do
+  {
+    digits[--i] = '0' + (value % 10);
+    value /= 10;
   }
+  while(value != 0);
 
-  return false;
+  write(digits + i, sizeof(digits) - i);
 }
 
 //-----------------------------------------------------------------------------
-bool ListExportUtils::saveToXLS(const std::string& filename, const std::vector<std::pair<std::string, unsigned long long> >& contents)
+void ListExportUtils::DeflateWriter::writeXML(const std::string &text)
 {
-  workbook wb;
+  for(auto c: text)
+  {
+    switch(c)
+    {
+      case '&': write("&amp;", 5); break;
+      case '<': write("&lt;", 4);  break;
+      case '>': write("&gt;", 4);  break;
+      default:
+        // control characters are not valid XML, they are written with the Office escape.
+        if(static_cast<unsigned char>(c) < 0x20 && c != '\t' && c != '\n' && c != '\r')
+        {
+          const char *HEX = "0123456789ABCDEF";
+          const char escaped[] = { '_', 'x', '0', '0', HEX[(c >> 4) & 0xF], HEX[c & 0xF], '_' };
+          write(escaped, sizeof(escaped));
+        }
+        else
+        {
+          write(c);
+        }
+        break;
+    }
+  }
+}
 
-  auto excelSheet = wb.sheet("sheet 1");
+//-----------------------------------------------------------------------------
+void ListExportUtils::DeflateWriter::finish()
+{
+  compress(true);
+}
 
-  excelSheet->label(0, 0, "Name");
-  excelSheet->label(0, 1, "Size");
+//-----------------------------------------------------------------------------
+void ListExportUtils::DeflateWriter::compress(const bool end)
+{
+  m_crc   = crc32(m_crc, reinterpret_cast<const Bytef *>(m_input.data()), m_used);
+  m_size += m_used;
 
-  for (size_t c = 0; c < contents.size(); ++c)
+  if(!m_stream)
   {
-    excelSheet->label(static_cast<int>(c+1), 0, QString::fromLatin1(contents.at(c).first.c_str()).toStdWString());
-    excelSheet->label(static_cast<int>(c+1), 1, std::to_string(contents.at(c).second));
+    m_used = 0;
+    return;
   }
 
-  auto result = wb.Dump(filename);
+  m_stream->next_in  = reinterpret_cast<Bytef *>(m_input.data());
+  m_stream->avail_in = m_used;
+
+  int result;
+  do
+  {
+    m_stream->next_out  = reinterpret_cast<Bytef *>(m_chunk.data());
+    m_stream->avail_out = m_chunk.size();
+
+    result = deflate(m_stream.get(), end ? Z_FINISH : Z_NO_FLUSH);
+    m_output.write(m_chunk.data(), m_chunk.size() - m_stream->avail_out);
+  }
+  while(result == Z_OK && (m_stream->avail_in > 0 || m_stream->avail_out == 0 || end));
+
+  if(result == Z_STREAM_ERROR) m_output.fail();
+
+  m_used = 0;
+}
+
+//-----------------------------------------------------------------------------
+ListExportUtils::ZipWriter::ZipWriter(const QString &filename)
+: m_file{filename}
+{
+  const auto now = QDateTime::currentDateTime();
+  m_time = (now.time().hour() << 11) | (now.time().minute() << 5) | (now.time().second() / 2);
+  m_date = ((std::max(now.date().year(), 1980) - 1980) << 9) | (now.date().month() << 5) | now.date().day();
+}
+
+//-----------------------------------------------------------------------------
+ListExportUtils::DeflateWriter &ListExportUtils::ZipWriter::beginEntry(const std::string &name)
+{
+  if(m_current) endEntry();
+
+  // sizes and CRC are unknown yet, they follow the data in a descriptor.
+  m_entries.push_back(Entry{name, 0, 0, 0, m_file.written(), true});
+  writeLocalHeader(m_entries.back());
+
+  m_current.reset(new DeflateWriter(m_file));
+
+  return *m_current;
+}
+
+//-----------------------------------------------------------------------------
+void ListExportUtils::ZipWriter::endEntry()
+{
+  if(!m_current) return;
+
+  m_current->finish();
+
+  auto &entry = m_entries.back();
+  entry.crc        = m_current->crc();
+  entry.compressed = m_current->compressedSize();
+  entry.size       = m_current->size();
+
+  m_current.reset();
+
+  // the descriptor of an entry without zip64 local header can't hold bigger sizes.
+  if(entry.compressed >= ZIP64_LIMIT || entry.size >= ZIP64_LIMIT) m_file.fail();
+
+  writeValue(0x08074b50, 4);
+  writeValue(entry.crc, 4);
+  writeValue(entry.compressed, 4);
+  writeValue(entry.size, 4);
+}
+
+//-----------------------------------------------------------------------------
+void ListExportUtils::ZipWriter::addEntry(const std::string &name, QIODevice &data, const DeflateWriter &source)
+{
+  if(m_current) endEntry();
+
+  m_entries.push_back(Entry{name, source.crc(), source.compressedSize(), source.size(), m_file.written(), false});
+  writeLocalHeader(m_entries.back());
+
+  std::vector<char> buffer(DEFLATE_BUFFER);
+  unsigned long long copied = 0;
+  while(copied < source.compressedSize())
+  {
+    const auto bytes = data.read(buffer.data(), std::min<unsigned long long>(buffer.size(), source.compressedSize() - copied));
+    if(bytes <= 0)
+    {
+      m_file.fail();
+      break;
+    }
+
+    m_file.write(buffer.data(), bytes);
+    copied += bytes;
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool ListExportUtils::ZipWriter::close()
+{
+  if(m_current) endEntry();
+
+  const auto directoryOffset = m_file.written();
+  for(auto &entry: m_entries)
+  {
+    // fields that don't fit are moved to the zip64 extra field, in this order.
+    std::vector<unsigned long long> extra;
+    if(entry.size >= ZIP64_LIMIT)       extra.push_back(entry.size);
+    if(entry.compressed >= ZIP64_LIMIT) extra.push_back(entry.compressed);
+    if(entry.offset >= ZIP64_LIMIT)     extra.push_back(entry.offset);
+
+    writeValue(0x02014b50, 4);
+    writeValue(extra.empty() ? 20 : 45, 2);
+    writeValue(extra.empty() ? 20 : 45, 2);
+    writeValue(entry.descriptor ? 0x0808 : 0x0800, 2);
+    writeValue(8, 2);
+    writeValue(m_time, 2);
+    writeValue(m_date, 2);
+    writeValue(entry.crc, 4);
+    writeValue(std::min(entry.compressed, ZIP64_LIMIT), 4);
+    writeValue(std::min(entry.size, ZIP64_LIMIT), 4);
+    writeValue(entry.name.length(), 2);
+    writeValue(extra.empty() ? 0 : 4 + 8 * extra.size(), 2);
+    writeValue(0, 2);
+    writeValue(0, 2);
+    writeValue(0, 2);
+    writeValue(0, 4);
+    writeValue(std::min(entry.offset, ZIP64_LIMIT), 4);
+    m_file.write(entry.name);
+
+    if(!extra.empty())
+    {
+      writeValue(0x0001, 2);
+      writeValue(8 * extra.size(), 2);
+      std::for_each(extra.cbegin(), extra.cend(), [this](const unsigned long long v) { writeValue(v, 8); });
+    }
+  }
+  const auto directorySize = m_file.written() - directoryOffset;
+
+  if(m_entries.size() >= 0xFFFF || directoryOffset >= ZIP64_LIMIT || directorySize >= ZIP64_LIMIT)
+  {
+    const auto recordOffset = m_file.written();
+
+    writeValue(0x06064b50, 4);
+    writeValue(44, 8);
+    writeValue(45, 2);
+    writeValue(45, 2);
+    writeValue(0, 4);
+    writeValue(0, 4);
+    writeValue(m_entries.size(), 8);
+    writeValue(m_entries.size(), 8);
+    writeValue(directorySize, 8);
+    writeValue(directoryOffset, 8);
+
+    writeValue(0x07064b50, 4);
+    writeValue(0, 4);
+    writeValue(recordOffset, 8);
+    writeValue(1, 4);
+  }
+
+  writeValue(0x06054b50, 4);
+  writeValue(0, 2);
+  writeValue(0, 2);
+  writeValue(std::min<unsigned long long>(m_entries.size(), 0xFFFF), 2);
+  writeValue(std::min<unsigned long long>(m_entries.size(), 0xFFFF), 2);
+  writeValue(std::min(directorySize, ZIP64_LIMIT), 4);
+  writeValue(std::min(directoryOffset, ZIP64_LIMIT), 4);
+  writeValue(0, 2);
+
+  return m_file.close();
+}
+
+//-----------------------------------------------------------------------------
+void ListExportUtils::ZipWriter::writeValue(unsigned long long value, const unsigned int bytes)
+{
+  for(unsigned int i = 0; i < bytes; ++i)
+  {
+    m_file.write(static_cast<char>(value & 0xFF));
+    value >>= 8;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void ListExportUtils::ZipWriter::writeLocalHeader(const Entry &entry)
+{
+  const bool zip64 = entry.size >= ZIP64_LIMIT || entry.compressed >= ZIP64_LIMIT;
+
+  // bit 11 marks the name as UTF-8, bit 3 the data descriptor.
+  writeValue(0x04034b50, 4);
+  writeValue(zip64 ? 45 : 20, 2);
+  writeValue(entry.descriptor ? 0x0808 : 0x0800, 2);
+  writeValue(8, 2);
+  writeValue(m_time, 2);
+  writeValue(m_date, 2);
+  writeValue(entry.crc, 4);
+  writeValue(zip64 ? ZIP64_LIMIT : entry.compressed, 4);
+  writeValue(zip64 ? ZIP64_LIMIT : entry.size, 4);
+  writeValue(entry.name.length(), 2);
+  writeValue(zip64 ? 20 : 0, 2);
+  m_file.write(entry.name);
+
+  if(zip64)
+  {
+    writeValue(0x0001, 2);
+    writeValue(16, 2);
+    writeValue(entry.size, 8);
+    writeValue(entry.compressed, 8);
+  }
+}
+
+//-----------------------------------------------------------------------------
+std::shared_ptr<const ListExportUtils::Snapshot> ListExportUtils::createSnapshot(const Items &items, const bool fullPaths)
+{
+  auto snapshot = std::make_shared<Snapshot>();
+  snapshot->fullPaths = fullPaths;
+
+  std::vector<std::pair<const Item *, unsigned int>> pending;
+  for(auto item: items)
+  {
+    std::string path;
+    if(item->parent())
+    {
+      item->parent()->fullName(path);
+      if(!path.empty()) path += '/';
+    }
+    snapshot->paths.push_back(std::move(path));
+
+    pending.emplace_back(item, 0);
+    while(!pending.empty())
+    {
+      const auto current = pending.back();
+      pending.pop_back();
+
+      const auto item  = current.first;
+      const bool file  = item->type() == Type::File;
+      const auto depth = current.second;
+
+      snapshot->nodes.push_back(Snapshot::Node{file ? item->objectSize() : Snapshot::DIRECTORY, item->nameHandle(), depth});
+      if(file)
+      {
+        ++snapshot->files;
+      }
+      else
+      {
+        // reversed so the files are written in the order of the tree.
+        const auto &children = item->children();
+        for(auto it = children.crbegin(); it != children.crend(); ++it)
+        {
+          pending.emplace_back(*it, depth + 1);
+        }
+      }
+    }
+  }
+
+  return snapshot;
+}
+
+//-----------------------------------------------------------------------------
+template<class Function> static bool walkFiles(const ListExportUtils::Snapshot &snapshot, ListExportUtils::Progress &progress, Function function)
+{
+  // the path of the current file is built in place from the UTF-8 names of the pool, only the
+  // length of each directory level is kept.
+  const auto &pool = namePool();
+  std::string path;
+  std::vector<std::size_t> lengths(1, 0);
+  std::size_t selected = 0;
+  unsigned long long rows = 0;
+
+  for(auto &node: snapshot.nodes)
+  {
+    if(node.depth == 0 && snapshot.fullPaths)
+    {
+      path = snapshot.paths[selected++];
+      lengths[0] = path.length();
+    }
+
+    if(node.isFile())
+    {
+      path.resize(snapshot.fullPaths ? lengths[node.depth] : 0);
+      path.append(pool.data(node.name), pool.length(node.name));
+      function(path, node.size);
+
+      if(++rows == PROGRESS_ROWS)
+      {
+        progress.rows += rows;
+        rows = 0;
+
+        if(progress.token.isCancelled()) return false;
+      }
+    }
+    else if(snapshot.fullPaths)
+    {
+      path.resize(lengths[node.depth]);
+      if(node.name != NamePool::EMPTY)
+      {
+        path.append(pool.data(node.name), pool.length(node.name));
+        path += '/';
+      }
+
+      lengths.resize(node.depth + 2);
+      lengths[node.depth + 1] = path.length();
+    }
+  }
+  progress.rows += rows;
+
+  return !progress.token.isCancelled();
+}
+
+/** \class CSVTable
+ * \brief Writes the rows to a CSV file, the texts are quoted.
+ *
+ */
+class CSVTable
+: public ListExportUtils::TableWriter
+{
+  public:
+    /** \brief CSVTable class constructor.
+     * \param[in] filename Output file name.
+     * \param[in] columns Names of the columns.
+     *
+     */
+    explicit CSVTable(const QString &filename, const std::vector<std::string> &columns)
+    : m_file (filename)
+    , m_first{true}
+    {
+      for(auto &column: columns)
+      {
+        separate();
+        m_file.write(column);
+      }
+      endRow();
+    }
+
+    virtual bool isValid() const override
+    { return m_file.isValid(); }
+
+    virtual void text(const std::string &text) override
+    {
+      separate();
+
+      // quotes inside a quoted field are escaped doubling them.
+      m_file.write('"');
+      std::size_t begin = 0, end;
+      while((end = text.find('"', begin)) != std::string::npos)
+      {
+        m_file.write(text.data() + begin, end + 1 - begin);
+        m_file.write('"');
+        begin = end + 1;
+      }
+      m_file.write(text.data() + begin, text.length() - begin);
+      m_file.write('"');
+    }
+
+    virtual void number(const unsigned long long value) override
+    {
+      separate();
+      m_file.writeNumber(value);
+    }
+
+    virtual void endRow() override
+    {
+      m_file.write('\n');
+      m_first = true;
+    }
+
+    virtual bool close() override
+    { return m_file.close(); }
+
+  private:
+    /** \brief Writes the separator of the cells of a row.
+     *
+     */
+    void separate()
+    {
+      if(!m_first) m_file.write(", ", 2);
+      m_first = false;
+    }
+
+    ListExportUtils::BufferedWriter m_file;  /** output file.                         */
+    bool                            m_first; /** true before the first cell of a row. */
+};
+
+/** \class XLSXTable
+ * \brief Writes the rows to the sheets of a XLSX file. The texts are written to the shared strings
+ * part, compressed to a temporary file while the sheets are written.
+ *
+ */
+class XLSXTable
+: public ListExportUtils::TableWriter
+{
+  public:
+    /** \brief XLSXTable class constructor.
+     * \param[in] filename Output file name.
+     * \param[in] columns Names of the columns.
+     * \param[in] sheet Name of the sheets.
+     * \param[in] reuseText True to reuse the repeated texts.
+     *
+     */
+    explicit XLSXTable(const QString &filename, const std::vector<std::string> &columns, const std::string &sheet, const bool reuseText)
+    : m_zip    (filename)
+    , m_name   (sheet)
+    , m_reuse  {reuseText}
+    , m_count  {0}
+    , m_sheets {0}
+    , m_rows   {0}
+    , m_sheet  {nullptr}
+    , m_rowOpen{false}
+    {
+      if(!m_stringsFile.open()) return;
+
+      m_stringsOutput = std::unique_ptr<ListExportUtils::BufferedWriter>(new ListExportUtils::BufferedWriter(&m_stringsFile, DEFLATE_BUFFER));
+      m_strings = std::unique_ptr<ListExportUtils::DeflateWriter>(new ListExportUtils::DeflateWriter(*m_stringsOutput));
+      m_strings->write(XML_HEADER);
+      m_strings->write("<sst xmlns=\"" SPREADSHEET_NS "\">");
+
+      for(auto &column: columns) m_header.push_back(addString(column));
+    }
+
+    virtual bool isValid() const override
+    { return m_zip.isValid() && m_strings; }
+
+    virtual void text(const std::string &text) override
+    {
+      beginCell();
+      m_sheet->write("<c t=\"s\"><v>");
+      m_sheet->writeNumber(addString(text));
+      m_sheet->write("</v></c>");
+    }
+
+    virtual void number(const unsigned long long value) override
+    {
+      beginCell();
+      m_sheet->write("<c><v>");
+      m_sheet->writeNumber(value);
+      m_sheet->write("</v></c>");
+    }
+
+    virtual void endRow() override
+    {
+      beginCell();
+      m_sheet->write("</row>");
+      m_rowOpen = false;
+      ++m_rows;
+    }
+
+    virtual bool close() override;
+
+  private:
+    /** \brief Adds the given text to the shared strings and returns its index.
+     * \param[in] text UTF-8 text.
+     *
+     */
+    unsigned long long addString(const std::string &text);
+
+    /** \brief Opens the row of the next cell, in a new sheet if the current one is full.
+     *
+     */
+    void beginCell();
+
+    /** \brief Ends the current sheet and starts a new one with the header row.
+     *
+     */
+    void beginSheet();
+
+    ListExportUtils::ZipWriter                          m_zip;           /** output file.                                     */
+    QTemporaryFile                                      m_stringsFile;   /** compressed shared strings.                       */
+    std::unique_ptr<ListExportUtils::BufferedWriter>    m_stringsOutput; /** writer of the shared strings file.               */
+    std::unique_ptr<ListExportUtils::DeflateWriter>     m_strings;       /** compressor of the shared strings.                */
+    const std::string                                   m_name;          /** name of the sheets.                              */
+    const bool                                          m_reuse;         /** true to reuse the repeated texts.                */
+    std::unordered_map<std::string, unsigned long long> m_texts;         /** indexes of the reused texts.                     */
+    std::vector<unsigned long long>                     m_header;        /** indexes of the names of the columns.             */
+    unsigned long long                                  m_count;         /** number of shared strings.                        */
+    unsigned long long                                  m_sheets;        /** number of sheets.                                */
+    unsigned long long                                  m_rows;          /** rows of the current sheet, including the header. */
+    ListExportUtils::DeflateWriter                     *m_sheet;         /** writer of the current sheet.                     */
+    bool                                                m_rowOpen;       /** true if the current row has cells.               */
+};
+
+//-----------------------------------------------------------------------------
+unsigned long long XLSXTable::addString(const std::string &text)
+{
+  // only up to SHARED_NAMES distinct texts are reused.
+  if(m_reuse)
+  {
+    auto it = m_texts.find(text);
+    if(it != m_texts.end()) return (*it).second;
+    if(m_texts.size() < SHARED_NAMES) m_texts.emplace(text, m_count);
+  }
+
+  m_strings->write("<si><t");
+  if(!text.empty() && (text.front() == ' ' || text.back() == ' ')) m_strings->write(" xml:space=\"preserve\"");
+  m_strings->write('>');
+  m_strings->writeXML(text);
+  m_strings->write("</t></si>");
+
+  return m_count++;
+}
+
+//-----------------------------------------------------------------------------
+void XLSXTable::beginCell()
+{
+  if(m_rowOpen) return;
+
+  if(!m_sheet || m_rows == SHEET_ROWS) beginSheet();
+  m_sheet->write("<row>");
+  m_rowOpen = true;
+}
+
+//-----------------------------------------------------------------------------
+void XLSXTable::beginSheet()
+{
+  if(m_sheet) m_sheet->write("</sheetData></worksheet>");
+
+  m_sheet = &m_zip.beginEntry("xl/worksheets/sheet" + std::to_string(++m_sheets) + ".xml");
+  m_sheet->write(XML_HEADER);
+  m_sheet->write("<worksheet xmlns=\"" SPREADSHEET_NS "\"><cols><col min=\"1\" max=\"1\" width=\"100\" customWidth=\"1\"/>");
+  if(m_header.size() > 1)
+  {
+    m_sheet->write("<col min=\"2\" max=\"");
+    m_sheet->writeNumber(m_header.size());
+    m_sheet->write("\" width=\"18\" customWidth=\"1\"/>");
+  }
+  m_sheet->write("</cols><sheetData><row>");
+  for(auto index: m_header)
+  {
+    m_sheet->write("<c t=\"s\"><v>");
+    m_sheet->writeNumber(index);
+    m_sheet->write("</v></c>");
+  }
+  m_sheet->write("</row>");
+  m_rows = 1;
+}
+
+//-----------------------------------------------------------------------------
+bool XLSXTable::close()
+{
+  if(!isValid()) return false;
+
+  if(m_rowOpen) endRow();
+  if(!m_sheet) beginSheet();
+  m_sheet->write("</sheetData></worksheet>");
+  m_zip.endEntry();
+
+  m_strings->write("</sst>");
+  m_strings->finish();
+  if(!m_stringsOutput->close() || !m_stringsFile.seek(0)) return false;
+  m_zip.addEntry("xl/sharedStrings.xml", m_stringsFile, *m_strings);
+
+  auto &workbook = m_zip.beginEntry("xl/workbook.xml");
+  workbook.write(XML_HEADER);
+  workbook.write("<workbook xmlns=\"" SPREADSHEET_NS "\" xmlns:r=\"" RELATIONSHIPS_NS "\"><sheets>");
+  for(unsigned long long i = 1; i <= m_sheets; ++i)
+  {
+    workbook.write("<sheet name=\"");
+    workbook.writeXML(m_name);
+    if(m_sheets > 1)
+    {
+      workbook.write(' ');
+      workbook.writeNumber(i);
+    }
+    workbook.write("\" sheetId=\"");
+    workbook.writeNumber(i);
+    workbook.write("\" r:id=\"rId");
+    workbook.writeNumber(i);
+    workbook.write("\"/>");
+  }
+  workbook.write("</sheets></workbook>");
+
+  auto &workbookRelations = m_zip.beginEntry("xl/_rels/workbook.xml.rels");
+  workbookRelations.write(XML_HEADER);
+  workbookRelations.write("<Relationships xmlns=\"" PACKAGE_RELATIONSHIPS_NS "\">");
+  for(unsigned long long i = 1; i <= m_sheets; ++i)
+  {
+    workbookRelations.write("<Relationship Id=\"rId");
+    workbookRelations.writeNumber(i);
+    workbookRelations.write("\" Type=\"" RELATIONSHIPS_NS "/worksheet\" Target=\"worksheets/sheet");
+    workbookRelations.writeNumber(i);
+    workbookRelations.write(".xml\"/>");
+  }
+  workbookRelations.write("<Relationship Id=\"rId");
+  workbookRelations.writeNumber(m_sheets + 1);
+  workbookRelations.write("\" Type=\"" RELATIONSHIPS_NS "/sharedStrings\" Target=\"sharedStrings.xml\"/></Relationships>");
+
+  auto &relations = m_zip.beginEntry("_rels/.rels");
+  relations.write(XML_HEADER);
+  relations.write("<Relationships xmlns=\"" PACKAGE_RELATIONSHIPS_NS "\"><Relationship Id=\"rId1\" Type=\"" RELATIONSHIPS_NS
+                  "/officeDocument\" Target=\"xl/workbook.xml\"/></Relationships>");
+
+  auto &types = m_zip.beginEntry("[Content_Types].xml");
+  types.write(XML_HEADER);
+  types.write("<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+              "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+              "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+              "<Override PartName=\"/xl/workbook.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>"
+              "<Override PartName=\"/xl/sharedStrings.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sharedStrings+xml\"/>");
+  for(unsigned long long i = 1; i <= m_sheets; ++i)
+  {
+    types.write("<Override PartName=\"/xl/worksheets/sheet");
+    types.writeNumber(i);
+    types.write(".xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>");
+  }
+  types.write("</Types>");
+
+  return m_zip.close();
+}
+
+/** \class XLSTable
+ * \brief Writes the rows to a XLS file, the workbook is kept in memory until closed.
+ *
+ */
+class XLSTable
+: public ListExportUtils::TableWriter
+{
+  public:
+    /** \brief XLSTable class constructor.
+     * \param[in] filename Output file name.
+     * \param[in] columns Names of the columns.
+     * \param[in] sheet Name of the sheet.
+     *
+     */
+    explicit XLSTable(const QString &filename, const std::vector<std::string> &columns, const std::string &sheet)
+    : m_filename(filename)
+    , m_sheet   {m_workbook.sheet(sheet)}
+    , m_row     {0}
+    , m_column  {0}
+    {
+      for(auto &column: columns) text(column);
+      endRow();
+    }
+
+    virtual bool isValid() const override
+    { return m_sheet != nullptr; }
+
+    virtual void text(const std::string &text) override
+    { m_sheet->label(m_row, m_column++, QString::fromUtf8(text.c_str(), text.length()).toStdWString()); }
+
+    virtual void number(const unsigned long long value) override
+    { m_sheet->number(m_row, m_column++, static_cast<double>(value)); }
+
+    virtual void endRow() override
+    {
+      ++m_row;
+      m_column = 0;
+    }
+
+    virtual bool close() override
+    { return m_workbook.Dump(m_filename.toStdString()) == NO_ERRORS; }
+
+  private:
+    const QString m_filename; /** output file name.         */
+    workbook      m_workbook; /** workbook in memory.       */
+    worksheet    *m_sheet;    /** sheet of the workbook.    */
+    unsigned int  m_row;      /** index of the current row. */
+    unsigned int  m_column;   /** index of the next cell.   */
+};
+
+//-----------------------------------------------------------------------------
+std::unique_ptr<ListExportUtils::TableWriter> ListExportUtils::createTableWriter(const QString &filename, const Format format, const std::vector<std::string> &columns,
+                                                                                 const std::string &sheet, const bool reuseText)
+{
+  switch(format)
+  {
+    case Format::csv:
+      return std::unique_ptr<TableWriter>(new CSVTable(filename, columns));
+    case Format::xls:
+      return std::unique_ptr<TableWriter>(new XLSTable(filename, columns, sheet));
+    case Format::xlsx:
+    default:
+      break;
+  }
+
+  return std::unique_ptr<TableWriter>(new XLSXTable(filename, columns, sheet, reuseText));
+}
+
+//-----------------------------------------------------------------------------
+bool ListExportUtils::saveFileList(const QString &filename, const Format format, const Snapshot &snapshot, Progress &progress)
+{
+  // only names without path can repeat.
+  auto table = createTableWriter(filename, format, { "Name", "Size" }, "Objects", !snapshot.fullPaths);
+  if(!table->isValid()) return false;
+
+  auto writeRow = [&table](const std::string &name, const unsigned long long size)
+  {
+    table->text(name);
+    table->number(size);
+    table->endRow();
+  };
+  if(!walkFiles(snapshot, progress, writeRow)) return false;
+
+  return table->close();
+}
+
+//-----------------------------------------------------------------------------
+ListExportUtils::ExportThread::ExportThread(const QString &filename, Task task, const unsigned long long total, QObject *parent)
+: QThread   (parent)
+, m_filename(filename)
+, m_task    (task)
+, m_total   {total}
+, m_success {false}
+, m_rows    {0}
+{
+  m_sampler.setInterval(SAMPLE_INTERVAL);
+
+  connect(this, SIGNAL(started()), &m_sampler, SLOT(start()));
+  connect(this, SIGNAL(finished()), &m_sampler, SLOT(stop()));
+  connect(this, SIGNAL(finished()), this, SLOT(onSampleTimeout()));
+  connect(&m_sampler, SIGNAL(timeout()), this, SLOT(onSampleTimeout()));
+}
+
+//-----------------------------------------------------------------------------
+void ListExportUtils::ExportThread::run()
+{
+  m_success = m_task(m_progress);
+
+  if(!m_success) QFile::remove(m_filename);
+}
+
+//-----------------------------------------------------------------------------
+void ListExportUtils::ExportThread::abort()
+{
+  m_progress.token.cancel();
+}
+
+//-----------------------------------------------------------------------------
+void ListExportUtils::ExportThread::onSampleTimeout()
+{
+  const unsigned long long rows = m_progress.rows;
+  const auto elapsed = m_clock.isValid() ? m_clock.restart() : 0;
+  if(!m_clock.isValid()) m_clock.start();
+
+  const double rate = elapsed > 0 ? ((rows - m_rows) * 1000.) / elapsed : 0.;
+  m_rows = rows;
 
-  return (result == NO_ERRORS);
+  emit progress(rows, m_total, rate);
 }
@@ -20,27 +20,509 @@
 #ifndef LISTEXPORTUTILS_H_
 #define LISTEXPORTUTILS_H_
 
+// Project
+#include <Model/ItemsTree.h>
+#include <Utils/TransferUtils.h>
+
 // C++
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
+// Qt
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QThread>
+#include <QTimer>
+
+// zlib
+#include <zlib.h>
+
 namespace ListExportUtils
 {
-  /** \brief Saves the given contents to a CSV with the given filename. Returns true
-   * of success and false on failure.
+  /** \class BufferedWriter
+   * \brief Writes to a file through a big memory buffer, the file is only written when the
+   * buffer is full.
+   *
+   */
+  class BufferedWriter
+  {
+    public:
+      /** \brief BufferedWriter class constructor. Creates or truncates the given file.
+       * \param[in] filename Output file name.
+       * \param[in] capacity Size of the buffer in bytes.
+       *
+       */
+      explicit BufferedWriter(const QString &filename, const std::size_t capacity = 4*1024*1024);
+
+      /** \brief BufferedWriter class constructor. Writes to the given open device, that is not
+       * closed by the writer.
+       * \param[in] device Output device.
+       * \param[in] capacity Size of the buffer in bytes.
+       *
+       */
+      explicit BufferedWriter(QIODevice *device, const std::size_t capacity = 4*1024*1024);
+
+      /** \brief BufferedWriter class destructor. Writes the buffered data and closes the file.
+       *
+       */
+      ~BufferedWriter();
+
+      /** \brief Returns true if the file is open and all the data has been written.
+       *
+       */
+      bool isValid() const
+      { return m_device->isOpen() && !m_failed; }
+
+      /** \brief Writes the given data.
+       * \param[in] data Data pointer.
+       * \param[in] length Data length in bytes.
+       *
+       */
+      void write(const char *data, const std::size_t length);
+
+      /** \brief Writes the given text.
+       * \param[in] text Text string.
+       *
+       */
+      void write(const std::string &text)
+      { write(text.data(), text.length()); }
+
+      /** \brief Writes the given character.
+       * \param[in] c Character.
+       *
+       */
+      void write(const char c)
+      {
+        if(m_used == m_buffer.size()) flush();
+        m_buffer[m_used++] = c;
+      }
+
+      /** \brief Writes the decimal representation of the given number.
+       * \param[in] value Number.
+       *
+       */
+      void writeNumber(unsigned long long value);
+
+      /** \brief Returns the number of bytes written, including the buffered ones.
+       *
+       */
+      unsigned long long written() const
+      { return m_written + m_used; }
+
+      /** \brief Writes the buffered data and closes the file. Returns true if all the data
+       * has been written.
+       *
+       */
+      bool close();
+
+      /** \brief Marks the output as failed.
+       *
+       */
+      void fail()
+      { m_failed = true; }
+
+    private:
+      /** \brief Writes the buffered data to the file.
+       *
+       */
+      void flush();
+
+      QFile              m_file;    /** output file.                        */
+      QIODevice         *m_device;  /** output device.                      */
+      std::vector<char>  m_buffer;  /** data buffer.                        */
+      std::size_t        m_used;    /** bytes used in the buffer.           */
+      unsigned long long m_written; /** bytes written to the file.          */
+      bool               m_failed;  /** true if a write to the file failed. */
+  };
+
+  /** \class DeflateWriter
+   * \brief Compresses the written data with raw deflate to the given output and computes its CRC32.
+   *
+   */
+  class DeflateWriter
+  {
+    public:
+      /** \brief DeflateWriter class constructor.
+       * \param[in] output Output of the compressed data.
+       *
+       */
+      explicit DeflateWriter(BufferedWriter &output);
+
+      /** \brief DeflateWriter class destructor.
+       *
+       */
+      ~DeflateWriter();
+
+      /** \brief Writes the given data.
+       * \param[in] data Data pointer.
+       * \param[in] length Data length in bytes.
+       *
+       */
+      void write(const char *data, const std::size_t length);
+
+      /** \brief Writes the given text.
+       * \param[in] text Text string.
+       *
+       */
+      void write(const std::string &text)
+      { write(text.data(), text.length()); }
+
+      /** \brief Writes the given string literal.
+       * \param[in] text String literal.
+       *
+       */
+      template<std::size_t N> void write(const char (&text)[N])
+      { write(text, N - 1); }
+
+      /** \brief Writes the given character.
+       * \param[in] c Character.
+       *
+       */
+      void write(const char c)
+      {
+        if(m_used == m_input.size()) compress(false);
+        m_input[m_used++] = c;
+      }
+
+      /** \brief Writes the decimal representation of the given number.
+       * \param[in] value Number.
+       *
+       */
+      void writeNumber(unsigned long long value);
+
+      /** \brief Writes the given text escaped as XML character data.
+       * \param[in] text UTF-8 text.
+       *
+       */
+      void writeXML(const std::string &text);
+
+      /** \brief Compresses the remaining data and ends the deflate stream.
+       *
+       */
+      void finish();
+
+      /** \brief Returns the CRC32 of the written data.
+       *
+       */
+      uint32_t crc() const
+      { return m_crc; }
+
+      /** \brief Returns the size of the written data in bytes.
+       *
+       */
+      unsigned long long size() const
+      { return m_size + m_used; }
+
+      /** \brief Returns the size of the compressed data in bytes.
+       *
+       */
+      unsigned long long compressedSize() const
+      { return m_output.written() - m_start; }
+
+    private:
+      /** \brief Compresses the buffered data.
+       * \param[in] end True to end the deflate stream.
+       *
+       */
+      void compress(const bool end);
+
+      BufferedWriter            &m_output; /** output of the compressed data.          */
+      std::unique_ptr<z_stream>  m_stream; /** deflate stream.                         */
+      std::vector<char>          m_input;  /** uncompressed data buffer.               */
+      std::vector<char>          m_chunk;  /** compressed data buffer.                 */
+      std::size_t                m_used;   /** bytes used in the input buffer.         */
+      unsigned long long         m_size;   /** bytes compressed.                       */
+      unsigned long long         m_start;  /** output position of the compressed data. */
+      uint32_t                   m_crc;    /** CRC32 of the compressed data.           */
+  };
+
+  /** \class ZipWriter
+   * \brief Writes a zip file whose entries are compressed while they are written, so entries of
+   * any size only need the memory of the buffers. Uses the zip64 extensions when needed.
+   *
+   */
+  class ZipWriter
+  {
+    public:
+      /** \brief ZipWriter class constructor. Creates or truncates the given file.
+       * \param[in] filename Output file name.
+       *
+       */
+      explicit ZipWriter(const QString &filename);
+
+      /** \brief ZipWriter class destructor.
+       *
+       */
+      ~ZipWriter()
+      {};
+
+      /** \brief Returns true if the file is open and all the data has been written.
+       *
+       */
+      bool isValid() const
+      { return m_file.isValid(); }
+
+      /** \brief Starts a new entry and returns the writer of its data, valid until the entry ends.
+       * \param[in] name Entry name.
+       *
+       */
+      DeflateWriter &beginEntry(const std::string &name);
+
+      /** \brief Ends the current entry.
+       *
+       */
+      void endEntry();
+
+      /** \brief Adds an entry with the data already compressed in the given device.
+       * \param[in] name Entry name.
+       * \param[in] data Device with the compressed data at its beginning.
+       * \param[in] source Finished writer of the compressed data.
+       *
+       */
+      void addEntry(const std::string &name, QIODevice &data, const DeflateWriter &source);
+
+      /** \brief Writes the central directory and closes the file. Returns true on success.
+       *
+       */
+      bool close();
+
+    private:
+      /** \struct Entry
+       * \brief Zip entry information for the central directory.
+       *
+       */
+      struct Entry
+      {
+        std::string        name;       /** entry name.                       */
+        uint32_t           crc;        /** CRC32 of the data.                */
+        unsigned long long compressed; /** compressed size in bytes.         */
+        unsigned long long size;       /** uncompressed size in bytes.       */
+        unsigned long long offset;     /** offset of the local header.       */
+        bool               descriptor; /** true if followed by a descriptor. */
+      };
+
+      /** \brief Writes the given value in little endian.
+       * \param[in] value Value.
+       * \param[in] bytes Number of bytes to write.
+       *
+       */
+      void writeValue(unsigned long long value, const unsigned int bytes);
+
+      /** \brief Writes the local header of the given entry.
+       * \param[in] entry Zip entry.
+       *
+       */
+      void writeLocalHeader(const Entry &entry);
+
+      BufferedWriter                 m_file;    /** output file.                        */
+      std::vector<Entry>             m_entries; /** entries written.                    */
+      std::unique_ptr<DeflateWriter> m_current; /** writer of the current entry.        */
+      uint16_t                       m_time;    /** modification time in MS-DOS format. */
+      uint16_t                       m_date;    /** modification date in MS-DOS format. */
+  };
+
+  enum class Format: char { csv = 0, xls, xlsx };
+
+  /** \class TableWriter
+   * \brief Streams rows of cells to a CSV, XLS or XLSX file. The header row is written on creation
+   * and repeated in every sheet of the XLSX files.
+   *
+   */
+  class TableWriter
+  {
+    public:
+      /** \brief TableWriter class virtual destructor.
+       *
+       */
+      virtual ~TableWriter()
+      {};
+
+      /** \brief Returns true if the file has been opened.
+       *
+       */
+      virtual bool isValid() const = 0;
+
+      /** \brief Writes a text cell in the current row.
+       * \param[in] text UTF-8 text.
+       *
+       */
+      virtual void text(const std::string &text) = 0;
+
+      /** \brief Writes a number cell in the current row.
+       * \param[in] value Number.
+       *
+       */
+      virtual void number(const unsigned long long value) = 0;
+
+      /** \brief Ends the current row.
+       *
+       */
+      virtual void endRow() = 0;
+
+      /** \brief Completes and closes the file. Returns true on success.
+       *
+       */
+      virtual bool close() = 0;
+  };
+
+  /** \brief Returns a writer of a file with the given format.
    * \param[in] filename Output file name.
-   * \param[in] contents File names and sizes.
+   * \param[in] format Output file format.
+   * \param[in] columns Names of the columns, the first one is the widest.
+   * \param[in] sheet Name of the sheets of the XLS and XLSX files.
+   * \param[in] reuseText True to store the repeated texts of a XLSX file only once.
+   *
+   */
+  std::unique_ptr<TableWriter> createTableWriter(const QString &filename, const Format format, const std::vector<std::string> &columns,
+                                                 const std::string &sheet, const bool reuseText = false);
+
+  /** \struct Snapshot
+   * \brief Copy of the selected subtrees in depth-first order, so an export doesn't race with the
+   * modifications of the tree made while it runs. The nodes keep the handles of the names, that
+   * stay valid and can be read from the export thread.
    *
    */
-  bool saveToCSV(const std::string &filename, const std::vector<std::pair<std::string, unsigned long long>> &contents);
+  struct Snapshot
+  {
+    /** \brief Size of the nodes of the directories.
+     *
+     */
+    static const unsigned long long DIRECTORY = static_cast<unsigned long long>(-1);
+
+    /** \struct Node
+     * \brief Item of the subtrees. Kept to 16 bytes, as a snapshot has a node for each item.
+     *
+     */
+    struct Node
+    {
+      unsigned long long size;  /** size of the file, DIRECTORY for the directories. */
+      NamePool::Handle   name;  /** handle of the item name.                         */
+      unsigned int       depth; /** depth of the item, 0 for the selected items.     */
+
+      /** \brief Returns true if the node is a file.
+       *
+       */
+      bool isFile() const
+      { return size != DIRECTORY; }
+    };
+
+    std::vector<Node>        nodes;            /** items of the subtrees in depth-first order.                      */
+    std::vector<std::string> paths;            /** UTF-8 path of the parent of each selected item, with a delimiter. */
+    unsigned long long       files = 0;        /** number of files.                                                 */
+    bool                     fullPaths = true; /** true to export the full path of the files.                       */
+  };
 
-  /** \brief Saves the given contents to a XLS with the given filename. Returns true
-   * on success and false on failure.
+  /** \brief Returns the snapshot of the given items and their subitems. The files hidden by the
+   * filter keep their size.
+   * \param[in] items Selected items.
+   * \param[in] fullPaths True to export the files with their full path, false to export only the names.
+   *
+   */
+  std::shared_ptr<const Snapshot> createSnapshot(const Items &items, const bool fullPaths);
+
+  /** \struct Progress
+   * \brief Progress and cancellation of an export.
+   *
+   */
+  struct Progress
+  {
+    std::atomic<unsigned long long>  rows{0}; /** number of rows written.  */
+    TransferUtils::CancellationToken token;   /** cancels the export.      */
+  };
+
+  /** \brief Saves the files of the given snapshot to a file with the given filename and format.
+   * Returns true on success and false on failure or if cancelled.
    * \param[in] filename Output file name.
-   * \param[in] contents File names and sizes.
+   * \param[in] format Output file format.
+   * \param[in] snapshot Snapshot of the selected items.
+   * \param[inout] progress Export progress.
    *
    */
-  bool saveToXLS(const std::string &filename, const std::vector<std::pair<std::string, unsigned long long>> &contents);
+  bool saveFileList(const QString &filename, const Format format, const Snapshot &snapshot, Progress &progress);
+
+  /** \class ExportThread
+   * \brief Runs an export in the background. The export task works on a snapshot of the tree and
+   * reports the rows written in the progress.
+   *
+   */
+  class ExportThread
+  : public QThread
+  {
+      Q_OBJECT
+    public:
+      using Task = std::function<bool(Progress &)>;
+
+      /** \brief ExportThread class constructor.
+       * \param[in] filename Output file name.
+       * \param[in] task Export function, returns true on success.
+       * \param[in] total Number of rows to export.
+       * \param[in] parent Raw pointer of the QObject parent of this one.
+       *
+       */
+      explicit ExportThread(const QString &filename, Task task, const unsigned long long total, QObject *parent = nullptr);
+
+      /** \brief ExportThread class virtual destructor.
+       *
+       */
+      virtual ~ExportThread()
+      {};
+
+      virtual void run();
+
+      /** \brief Returns the output file name.
+       *
+       */
+      const QString &filename() const
+      { return m_filename; }
+
+      /** \brief Returns the number of rows to export.
+       *
+       */
+      unsigned long long total() const
+      { return m_total; }
+
+      /** \brief Returns true if the export has been aborted.
+       *
+       */
+      bool isAborted() const
+      { return m_progress.token.isCancelled(); }
+
+      /** \brief Returns true if the file has been written successfully.
+       *
+       */
+      bool succeeded() const
+      { return m_success; }
+
+    public slots:
+      /** \brief Aborts the export, the incomplete file is removed.
+       *
+       */
+      void abort();
+
+    signals:
+      void progress(unsigned long long rows, unsigned long long total, double rowsPerSecond);
+
+    private slots:
+      /** \brief Samples the number of rows written and emits the progress.
+       *
+       */
+      void onSampleTimeout();
+
+    private:
+      const QString            m_filename; /** output file name.                                  */
+      Task                     m_task;     /** export function.                                   */
+      const unsigned long long m_total;    /** number of rows to export.                          */
+      Progress                 m_progress; /** export progress.                                   */
+      bool                     m_success;  /** true if the file has been written successfully.    */
+      QTimer                   m_sampler;  /** progress sampling timer, runs in the owner thread. */
+      QElapsedTimer            m_clock;    /** time of the last sample.                           */
+      unsigned long long       m_rows;     /** rows written at the last sample.                   */
+  };
 };
 
 #endif // LISTEXPORTUTILS_H_
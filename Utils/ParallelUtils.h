@@ -0,0 +1,80 @@
+/*
+ File: ParallelUtils.h
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARALLELUTILS_H_
+#define PARALLELUTILS_H_
+
+// C++
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace ParallelUtils
+{
+  /** \brief Returns the number of threads used by the parallel algorithms.
+   *
+   */
+  std::size_t threadsCount();
+
+  /** \brief Calls the given function once for every index in [0, count) from up to threadsCount()
+   * threads, the indexes are taken in order from a shared counter to balance the work. Returns when
+   * all the calls have finished.
+   * \param[in] count Number of indexes.
+   * \param[in] function Function called with the index and the thread number, in [0, threadsCount()).
+   *
+   */
+  template<class Function> void runParallel(const std::size_t count, Function function)
+  {
+    std::atomic<std::size_t> next{0};
+
+    auto worker = [&](const std::size_t thread)
+    {
+      std::size_t i;
+      while((i = next++) < count) function(i, thread);
+    };
+
+    std::vector<std::thread> threads;
+    const auto threadsNum = std::min(threadsCount(), count);
+    for(std::size_t i = 1; i < threadsNum; ++i) threads.emplace_back(worker, i);
+    worker(0);
+    std::for_each(threads.begin(), threads.end(), [](std::thread &t) { t.join(); });
+  }
+
+  /** \brief Calls the given function for consecutive chunks of [0, count) in parallel.
+   * \param[in] count Number of indexes.
+   * \param[in] chunkSize Maximum number of indexes of a chunk.
+   * \param[in] function Function called with the first and past the last index of the chunk and
+   * the thread number.
+   *
+   */
+  template<class Function> void runChunked(const std::size_t count, const std::size_t chunkSize, Function function)
+  {
+    const auto chunks = (count + chunkSize - 1) / chunkSize;
+
+    auto runChunk = [&](const std::size_t i, const std::size_t thread)
+    {
+      const auto first = i * chunkSize;
+      function(first, std::min(first + chunkSize, count), thread);
+    };
+    runParallel(chunks, runChunk);
+  }
+};
+
+#endif // PARALLELUTILS_H_
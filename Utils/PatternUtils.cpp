@@ -0,0 +1,345 @@
+/*
+ File: PatternUtils.cpp
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Project
+#include <Utils/PatternUtils.h>
+
+// Qt
+#include <QStringList>
+
+using namespace PatternUtils;
+
+//-----------------------------------------------------------------------------
+static int classEnd(const QString &text, int i)
+{
+  // returns the position after the ']' that closes the class that starts at i, or -1 if it's unterminated.
+  ++i;
+  if(i < text.length() && (text.at(i) == '^' || text.at(i) == '!')) ++i;
+  if(i < text.length() && text.at(i) == ']') ++i;
+
+  while(i < text.length())
+  {
+    const auto c = text.at(i);
+    if(c == ']') return i + 1;
+    if(c == '\\') ++i;
+    if(c == '[' && i + 1 < text.length() && text.at(i + 1) == ':')
+    {
+      const auto end = text.indexOf(":]", i + 2);
+      if(end != -1) i = end + 1;
+    }
+    ++i;
+  }
+
+  return -1;
+}
+
+//-----------------------------------------------------------------------------
+static int groupEnd(const QString &text, int i)
+{
+  // returns the position after the ')' that closes the group that starts at i, or -1 if it's unterminated.
+  int depth = 0;
+  while(i < text.length())
+  {
+    const auto c = text.at(i);
+    if(c == '\\')
+    {
+      i += 2;
+      continue;
+    }
+
+    if(c == '[')
+    {
+      i = classEnd(text, i);
+      if(i == -1) return -1;
+      continue;
+    }
+
+    if(c == '(') ++depth;
+    if(c == ')' && --depth == 0) return i + 1;
+    ++i;
+  }
+
+  return -1;
+}
+
+//-----------------------------------------------------------------------------
+static int escapeEnd(const QString &text, int i)
+{
+  // returns the position after the escape sequence of a letter or digit that starts at i, or -1 if it's unterminated.
+  const auto letter = text.at(i + 1).toLatin1();
+  i += 2;
+
+  auto skipTo = [&text, &i](const QString &end)
+  {
+    i = text.indexOf(end, i);
+    return i == -1 ? -1 : i + end.length();
+  };
+
+  if(letter == 'Q') return skipTo("\\E");
+  if(i == text.length()) return i;
+
+  const auto next = text.at(i);
+  if(next == '{')  return skipTo("}");
+  if(next == '<')  return skipTo(">");
+  if(next == '\'') { ++i; return skipTo("'"); }
+
+  switch(letter)
+  {
+    case 'x':
+      for(int count = 0; count < 2 && i < text.length() && QString("0123456789abcdefABCDEF").contains(text.at(i)); ++count) ++i;
+      break;
+    case 'c':
+    case 'p':
+    case 'P':
+      ++i;
+      break;
+    default:
+      while(letter >= '0' && letter <= '9' && i < text.length() && text.at(i).isDigit()) ++i;
+      break;
+  }
+
+  return i;
+}
+
+//-----------------------------------------------------------------------------
+static QString longest(const QStringList &literals)
+{
+  QString result;
+  for(auto &literal: literals)
+  {
+    if(literal.length() > result.length()) result = literal;
+  }
+
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+static QStringList globLiterals(const QString &glob)
+{
+  QStringList literals{QString()};
+  int i = 0;
+  while(i < glob.length())
+  {
+    const auto c = glob.at(i);
+    if(c == '*' || c == '?')
+    {
+      const auto start = i;
+      while(i < glob.length() && (glob.at(i) == '*' || glob.at(i) == '?')) ++i;
+
+      // the delimiter after '**' is optional.
+      if(i < glob.length() && glob.at(i) == '/' && glob.mid(start, i - start).contains("**")) ++i;
+      literals << QString();
+      continue;
+    }
+
+    if(c == '[')
+    {
+      const auto end = classEnd(glob, i);
+      if(end != -1)
+      {
+        i = end;
+        literals << QString();
+        continue;
+      }
+    }
+
+    literals.last() += c;
+    ++i;
+  }
+
+  return literals;
+}
+
+//-----------------------------------------------------------------------------
+static QStringList expressionLiterals(const QString &expression)
+{
+  // free spacing mode makes the whitespace of the literals meaningless.
+  if(expression.contains(QRegularExpression("\\(\\?[a-zA-Z^-]*x"))) return QStringList();
+
+  QStringList literals{QString()};
+  auto flush = [&literals]() { if(!literals.last().isEmpty()) literals << QString(); };
+
+  int i = 0;
+  while(i < expression.length())
+  {
+    QChar atom;
+    const auto c = expression.at(i);
+    switch(c.toLatin1())
+    {
+      case '\\':
+        if(i + 1 == expression.length()) return QStringList();
+        // escaped letters and digits are classes, anchors, references, codes or quoting.
+        if(expression.at(i + 1).isLetterOrNumber())
+        {
+          flush();
+          i = escapeEnd(expression, i);
+          if(i == -1) return QStringList();
+          continue;
+        }
+        atom = expression.at(i + 1);
+        i += 2;
+        break;
+      case '(':
+        flush();
+        i = groupEnd(expression, i);
+        if(i == -1) return QStringList();
+        continue;
+      case '[':
+        flush();
+        i = classEnd(expression, i);
+        if(i == -1) return QStringList();
+        continue;
+      case '{':
+        flush();
+        i = expression.indexOf('}', i);
+        if(i == -1) return QStringList();
+        ++i;
+        continue;
+      case '|':
+        // any alternative can match, no literal is required.
+        return QStringList();
+      case '.':
+      case '^':
+      case '$':
+      case '*':
+      case '+':
+      case '?':
+        flush();
+        ++i;
+        continue;
+      default:
+        atom = c;
+        ++i;
+        break;
+    }
+
+    // optional atoms aren't part of the literal, repeated ones end it.
+    QString quantifiers;
+    while(i < expression.length() && QString("*+?{").contains(expression.at(i)))
+    {
+      const auto end = expression.at(i) == '{' ? expression.indexOf('}', i) : i;
+      if(end == -1) return QStringList();
+      quantifiers += expression.mid(i, end - i + 1);
+      i = end + 1;
+    }
+
+    if(quantifiers.isEmpty())
+    {
+      literals.last() += atom;
+    }
+    else
+    {
+      if(quantifiers == "+" || quantifiers == "++" || quantifiers == "+?") literals.last() += atom;
+      flush();
+    }
+  }
+
+  return literals;
+}
+
+//-----------------------------------------------------------------------------
+QString PatternUtils::globToExpression(const QString &glob)
+{
+  QString expression = "^";
+  QString literal;
+  auto flush = [&expression, &literal]() { expression += QRegularExpression::escape(literal); literal.clear(); };
+
+  int i = 0;
+  while(i < glob.length())
+  {
+    const auto c = glob.at(i);
+    if(c == '*')
+    {
+      flush();
+      if(glob.mid(i, 2) != "**")
+      {
+        expression += "[^/]*";
+        ++i;
+        continue;
+      }
+
+      const bool directories = glob.mid(i, 3) == "**/" && (i == 0 || glob.at(i - 1) == '/');
+      expression += directories ? "(?:.*/)?" : ".*";
+      i += directories ? 3 : 2;
+      continue;
+    }
+
+    if(c == '?')
+    {
+      flush();
+      expression += "[^/]";
+      ++i;
+      continue;
+    }
+
+    if(c == '[')
+    {
+      const auto end = classEnd(glob, i);
+      if(end != -1)
+      {
+        flush();
+        auto characters = glob.mid(i + 1, end - i - 2);
+        const bool negated = characters.startsWith('!') || characters.startsWith('^');
+        if(negated) characters.remove(0, 1);
+        characters.replace("[", "\\[");
+
+        // the slash goes last in a negated class, a leading ']' is a literal for both syntaxes.
+        if(negated && characters.endsWith('-') && !characters.endsWith("\\-")) characters.replace(characters.length() - 1, 1, "\\-");
+        expression += negated ? "[^" + characters + "/]" : "[" + characters + "]";
+        i = end;
+        continue;
+      }
+    }
+
+    literal += c;
+    ++i;
+  }
+  flush();
+
+  return expression + "$";
+}
+
+//-----------------------------------------------------------------------------
+QString PatternUtils::requiredLiteral(const QString &text, const Syntax syntax)
+{
+  switch(syntax)
+  {
+    case Syntax::Glob:
+      return longest(globLiterals(text));
+    case Syntax::RegularExpression:
+      return longest(expressionLiterals(text));
+    default:
+      break;
+  }
+
+  return text;
+}
+
+//-----------------------------------------------------------------------------
+Pattern::Pattern(const QString &text, const Syntax syntax)
+: m_syntax {syntax}
+, m_literal(requiredLiteral(text, syntax), Qt::CaseInsensitive)
+{
+  if(syntax != Syntax::Text)
+  {
+    m_expression.setPattern(syntax == Syntax::Glob ? globToExpression(text) : text);
+    m_expression.setPatternOptions(QRegularExpression::CaseInsensitiveOption|QRegularExpression::UseUnicodePropertiesOption);
+    m_expression.optimize();
+  }
+}
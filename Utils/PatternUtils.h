@@ -0,0 +1,103 @@
+/*
+ File: PatternUtils.h
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PATTERNUTILS_H_
+#define PATTERNUTILS_H_
+
+// Qt
+#include <QRegularExpression>
+#include <QString>
+#include <QStringMatcher>
+
+namespace PatternUtils
+{
+  /** \brief Syntax of the filter patterns.
+   *
+   */
+  enum class Syntax: char { Text = 0, Glob, RegularExpression };
+
+  /** \class Pattern
+   * \brief Case insensitive compiled pattern. The subjects are first scanned for the longest literal
+   * every match must contain and only the ones that contain it are matched by the expression.
+   * Matching is reentrant but not thread safe, each thread must use its own pattern.
+   *
+   */
+  class Pattern
+  {
+    public:
+      /** \brief Pattern class constructor.
+       * \param[in] text Pattern text.
+       * \param[in] syntax Pattern syntax.
+       *
+       */
+      Pattern(const QString &text, const Syntax syntax);
+
+      /** \brief Returns true if the pattern is valid.
+       *
+       */
+      bool isValid() const
+      { return m_syntax == Syntax::Text || m_expression.isValid(); }
+
+      /** \brief Returns the description of the error of an invalid pattern.
+       *
+       */
+      QString errorString() const
+      { return m_expression.errorString(); }
+
+      /** \brief Returns the literal every match contains, empty if none has been found.
+       *
+       */
+      QString literal() const
+      { return m_literal.pattern(); }
+
+      /** \brief Returns true if the given subject matches the pattern.
+       * \param[in] subject Subject string.
+       *
+       */
+      bool matches(const QString &subject) const
+      {
+        if(!m_literal.pattern().isEmpty() && m_literal.indexIn(subject) == -1) return false;
+
+        return m_syntax == Syntax::Text || m_expression.match(subject).hasMatch();
+      }
+
+    private:
+      Syntax             m_syntax;     /** pattern syntax.                                 */
+      QStringMatcher     m_literal;    /** matcher of the literal every match contains.    */
+      QRegularExpression m_expression; /** compiled expression, unused for text patterns. */
+  };
+
+  /** \brief Returns the regular expression equivalent to the given glob. '*' and '?' don't match
+   * the '/' delimiter, '**' matches any text and a leading or inner '**' followed by '/' matches any
+   * number of directories. Character classes are negated with '!'.
+   * \param[in] glob Glob pattern.
+   *
+   */
+  QString globToExpression(const QString &glob);
+
+  /** \brief Returns the longest literal every match of the given pattern must contain. The regular
+   * expressions are analyzed conservatively, an empty literal is returned if unsure.
+   * \param[in] text Pattern text.
+   * \param[in] syntax Pattern syntax.
+   *
+   */
+  QString requiredLiteral(const QString &text, const Syntax syntax);
+};
+
+#endif // PATTERNUTILS_H_
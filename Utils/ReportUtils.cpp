@@ -0,0 +1,539 @@
+/*
+ File: ReportUtils.cpp
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Project
+#include <Utils/ReportUtils.h>
+#include <Utils/ParallelUtils.h>
+
+// C++
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+// number of subtrees per thread needed to stop splitting the directories.
+const std::size_t SUBTREES_PER_THREAD = 16;
+
+// maximum depth of the directories split in subtrees.
+const unsigned int SPLIT_DEPTH = 8;
+
+// number of rows written between progress updates.
+const unsigned long long PROGRESS_ROWS = 1024;
+
+// index of the directories without a row.
+const std::size_t NO_ROW = std::numeric_limits<std::size_t>::max();
+
+// index of the node of a missing file.
+const std::size_t NO_NODE = std::numeric_limits<std::size_t>::max();
+
+using Snapshot = ListExportUtils::Snapshot;
+
+/** \struct Totals
+ * \brief Totals of a directory while it's reduced.
+ *
+ */
+struct Totals
+{
+  unsigned long long bytes       = 0;       /** size of the files.                        */
+  unsigned long long files       = 0;       /** number of files.                          */
+  unsigned long long directories = 0;       /** number of subdirectories.                 */
+  unsigned long long largestSize = 0;       /** size of the largest file.                 */
+  std::size_t        largest     = NO_NODE; /** snapshot node of the largest file.        */
+
+  /** \brief Adds the given file.
+   * \param[in] node Snapshot node of the file.
+   * \param[in] size File size.
+   *
+   */
+  void addFile(const std::size_t node, const unsigned long long size)
+  {
+    bytes += size;
+    ++files;
+    if(largest == NO_NODE || size > largestSize)
+    {
+      largest     = node;
+      largestSize = size;
+    }
+  }
+
+  /** \brief Adds the totals of the given subdirectory.
+   * \param[in] other Totals of a subdirectory.
+   *
+   */
+  void addDirectory(const Totals &other)
+  {
+    bytes       += other.bytes;
+    files       += other.files;
+    directories += other.directories + 1;
+    if(other.largest != NO_NODE && (largest == NO_NODE || other.largestSize > largestSize))
+    {
+      largest     = other.largest;
+      largestSize = other.largestSize;
+    }
+  }
+};
+
+/** \struct Row
+ * \brief Reported directory while the summary is computed.
+ *
+ */
+struct Row
+{
+  std::size_t node;   /** snapshot node of the directory.                */
+  Totals      totals; /** totals of the directory, filled in post-order. */
+};
+
+/** \struct Subtree
+ * \brief Subtree of the snapshot reduced by a thread.
+ *
+ */
+struct Subtree
+{
+  std::size_t      begin;  /** node of the subtree directory.         */
+  std::size_t      end;    /** node after the last one of the subtree. */
+  Totals           totals; /** totals of the subtree directory.        */
+  std::vector<Row> rows;   /** rows of the subtree, depth-first.       */
+};
+
+// size and item of a candidate of the largest items.
+using Candidate = std::pair<unsigned long long, const Item *>;
+
+//-----------------------------------------------------------------------------
+static bool reduce(const Snapshot &snapshot, const std::size_t begin, const std::size_t end, const unsigned int maxDepth,
+                   const std::vector<Subtree> &subtrees, std::vector<Row> &rows, Totals &result, ListExportUtils::Progress &progress)
+{
+  /** \struct Frame
+   * \brief Directory being reduced.
+   *
+   */
+  struct Frame
+  {
+    unsigned int depth;  /** depth of the directory.         */
+    std::size_t  row;    /** index of its row, or NO_ROW.    */
+    Totals       totals; /** totals of the reduced children. */
+  };
+
+  // the rows are reserved in pre-order and filled in post-order.
+  std::vector<Frame> stack;
+  auto leave = [&]()
+  {
+    result = stack.back().totals;
+    if(stack.back().row != NO_ROW) rows[stack.back().row].totals = result;
+    stack.pop_back();
+
+    if(!stack.empty()) stack.back().totals.addDirectory(result);
+  };
+
+  // the nodes that don't have a row are the progress of the reduction, the rows are the progress of the writing.
+  unsigned long long reduced = 0;
+  auto subtree = subtrees.cbegin();
+  for(auto i = begin; i < end; ++i)
+  {
+    const auto &node = snapshot.nodes[i];
+    while(!stack.empty() && stack.back().depth >= node.depth) leave();
+
+    if(subtree != subtrees.cend() && subtree->begin == i)
+    {
+      rows.insert(rows.end(), subtree->rows.cbegin(), subtree->rows.cend());
+      if(!stack.empty()) stack.back().totals.addDirectory(subtree->totals);
+      i = (subtree++)->end - 1;
+      continue;
+    }
+
+    if(node.isFile())
+    {
+      if(!stack.empty()) stack.back().totals.addFile(i, node.size);
+      ++reduced;
+    }
+    else
+    {
+      auto row = NO_ROW;
+      if(node.depth <= maxDepth)
+      {
+        row = rows.size();
+        rows.push_back(Row{i, Totals()});
+      }
+      else
+      {
+        ++reduced;
+      }
+      stack.push_back(Frame{node.depth, row, Totals()});
+    }
+
+    if(reduced >= PROGRESS_ROWS)
+    {
+      progress.rows += reduced;
+      reduced = 0;
+
+      if(progress.token.isCancelled()) return false;
+    }
+  }
+  progress.rows += reduced;
+
+  while(!stack.empty()) leave();
+
+  return !progress.token.isCancelled();
+}
+
+//-----------------------------------------------------------------------------
+static std::vector<Subtree> splitSubtrees(const Snapshot &snapshot)
+{
+  // the directories are split at the shallowest depth with enough subtrees to balance the threads.
+  std::vector<std::size_t> directories(SPLIT_DEPTH + 1, 0);
+  for(auto &node: snapshot.nodes)
+  {
+    if(!node.isFile() && node.depth <= SPLIT_DEPTH) ++directories[node.depth];
+  }
+
+  const auto wanted = ParallelUtils::threadsCount() * SUBTREES_PER_THREAD;
+  unsigned int depth = 0;
+  for(unsigned int i = 1; i <= SPLIT_DEPTH && directories[depth] < wanted; ++i)
+  {
+    if(directories[i] > directories[depth]) depth = i;
+  }
+
+  std::vector<Subtree> subtrees;
+  const auto &nodes = snapshot.nodes;
+  for(std::size_t i = 0; i < nodes.size();)
+  {
+    if(nodes[i].isFile() || nodes[i].depth != depth)
+    {
+      ++i;
+      continue;
+    }
+
+    auto end = i + 1;
+    while(end < nodes.size() && nodes[end].depth > depth) ++end;
+    subtrees.push_back(Subtree{i, end, Totals(), std::vector<Row>()});
+    i = end;
+  }
+
+  return subtrees;
+}
+
+//-----------------------------------------------------------------------------
+static std::unordered_map<std::size_t, std::string> fullNames(const Snapshot &snapshot, std::vector<std::size_t> &nodes, ListExportUtils::Progress &progress)
+{
+  std::sort(nodes.begin(), nodes.end());
+  nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+  // the path of the current directory is built in place, only the length of each level is kept.
+  const auto &pool = namePool();
+  std::unordered_map<std::size_t, std::string> result;
+  std::string path;
+  std::vector<std::size_t> lengths(1, 0);
+  std::size_t selected = 0;
+
+  auto wanted = nodes.cbegin();
+  for(std::size_t i = 0; wanted != nodes.cend(); ++i)
+  {
+    const auto &node = snapshot.nodes[i];
+    if(node.depth == 0)
+    {
+      path = snapshot.paths[selected++];
+      lengths[0] = path.length();
+    }
+
+    path.resize(lengths[node.depth]);
+    path.append(pool.data(node.name), pool.length(node.name));
+    if(i == *wanted)
+    {
+      result.emplace(i, path);
+      ++wanted;
+    }
+
+    if(!node.isFile())
+    {
+      if(node.name != NamePool::EMPTY) path += '/';
+
+      lengths.resize(node.depth + 2);
+      lengths[node.depth + 1] = path.length();
+    }
+
+    if(i % PROGRESS_ROWS == 0 && progress.token.isCancelled()) break;
+  }
+
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+static unsigned int splitSubtrees(const Item *directory, const bool visibleOnly, std::vector<const Item *> &upper, std::vector<const Item *> &subtrees)
+{
+  // the top directories are split until there are enough independent subtrees to balance the threads.
+  subtrees.assign(1, directory);
+  unsigned int depth = 0;
+  while(!subtrees.empty() && subtrees.size() < ParallelUtils::threadsCount() * SUBTREES_PER_THREAD && depth < SPLIT_DEPTH)
+  {
+    std::vector<const Item *> next;
+    for(auto item: subtrees)
+    {
+      upper.push_back(item);
+      for(auto child: item->children())
+      {
+        if(child->type() == Type::Directory && (!visibleOnly || child->isVisible())) next.push_back(child);
+      }
+    }
+
+    subtrees.swap(next);
+    ++depth;
+  }
+
+  return depth;
+}
+
+//-----------------------------------------------------------------------------
+std::shared_ptr<const ReportUtils::DirectorySummary> ReportUtils::summarize(const ListExportUtils::Snapshot &snapshot, const unsigned int maxDepth, ListExportUtils::Progress &progress)
+{
+  auto subtrees = splitSubtrees(snapshot);
+
+  std::atomic<bool> completed{true};
+  auto reduceSubtree = [&](const std::size_t i, const std::size_t)
+  {
+    auto &subtree = subtrees[i];
+    if(!reduce(snapshot, subtree.begin, subtree.end, maxDepth, std::vector<Subtree>(), subtree.rows, subtree.totals, progress)) completed = false;
+  };
+  ParallelUtils::runParallel(subtrees.size(), reduceSubtree);
+  if(!completed) return nullptr;
+
+  // the top directories are reduced with the subtrees as leaves, joining their rows in depth-first order.
+  std::vector<Row> rows;
+  Totals totals;
+  if(!reduce(snapshot, 0, snapshot.nodes.size(), maxDepth, subtrees, rows, totals, progress)) return nullptr;
+  subtrees.clear();
+
+  // only the summarized directories and the largest files are reported with their full names.
+  std::vector<std::size_t> named;
+  for(auto &row: rows)
+  {
+    if(snapshot.nodes[row.node].depth == 0) named.push_back(row.node);
+    if(row.totals.largest != NO_NODE) named.push_back(row.totals.largest);
+  }
+  auto names = fullNames(snapshot, named, progress);
+  if(progress.token.isCancelled()) return nullptr;
+
+  const auto &pool = namePool();
+  auto summary = std::make_shared<DirectorySummary>();
+  summary->rows.reserve(rows.size());
+  for(auto &row: rows)
+  {
+    const auto &node   = snapshot.nodes[row.node];
+    const auto &totals = row.totals;
+    summary->rows.push_back(DirectorySummary::Row{node.depth == 0 ? names[row.node] : std::string(pool.data(node.name), pool.length(node.name)), node.depth,
+                                                  totals.bytes, totals.files, totals.directories, totals.largestSize,
+                                                  totals.largest != NO_NODE ? names[totals.largest] : std::string()});
+  }
+
+  return summary;
+}
+
+//-----------------------------------------------------------------------------
+bool ReportUtils::saveSummary(const QString &filename, const ListExportUtils::Format format, const DirectorySummary &summary, ListExportUtils::Progress &progress)
+{
+  auto table = ListExportUtils::createTableWriter(filename, format, { "Directory", "Size", "Files", "Subdirectories", "Largest file", "Largest file size" }, "Directories");
+  if(!table->isValid()) return false;
+
+  // the path of the current directory is built in place, only the length of each level is kept.
+  std::string path;
+  std::vector<std::size_t> lengths(1, 0);
+  unsigned long long rows = 0;
+
+  for(auto &row: summary.rows)
+  {
+    path.resize(lengths[row.depth]);
+    if(!row.name.empty())
+    {
+      path += row.name;
+      path += '/';
+    }
+
+    lengths.resize(row.depth + 2);
+    lengths[row.depth + 1] = path.length();
+
+    table->text(path.empty() ? std::string("/") : path);
+    table->number(row.bytes);
+    table->number(row.files);
+    table->number(row.directories);
+    table->text(row.largest);
+    table->number(row.largestSize);
+    table->endRow();
+
+    if(++rows == PROGRESS_ROWS)
+    {
+      progress.rows += rows;
+      rows = 0;
+
+      if(progress.token.isCancelled()) return false;
+    }
+  }
+  progress.rows += rows;
+
+  if(progress.token.isCancelled()) return false;
+
+  return table->close();
+}
+
+//-----------------------------------------------------------------------------
+static void offer(std::vector<Candidate> &heap, const std::size_t count, const Candidate &candidate)
+{
+  // min-heap of the largest candidates, the smallest one is replaced.
+  auto greater = [](const Candidate &lhs, const Candidate &rhs) { return lhs.first > rhs.first; };
+
+  if(heap.size() < count)
+  {
+    heap.push_back(candidate);
+    std::push_heap(heap.begin(), heap.end(), greater);
+  }
+  else if(count > 0 && candidate.first > heap.front().first)
+  {
+    std::pop_heap(heap.begin(), heap.end(), greater);
+    heap.back() = candidate;
+    std::push_heap(heap.begin(), heap.end(), greater);
+  }
+}
+
+//-----------------------------------------------------------------------------
+static unsigned long long reduceLargest(const Item *directory, const bool visibleOnly, const std::size_t count, std::vector<Candidate> &heap)
+{
+  /** \struct Frame
+   * \brief Directory being reduced.
+   *
+   */
+  struct Frame
+  {
+    const Item        *item;  /** directory item.               */
+    std::size_t        next;  /** index of the next child.      */
+    unsigned long long bytes; /** size of the reduced children. */
+  };
+
+  unsigned long long result = 0;
+  std::vector<Frame> stack{Frame{directory, 0, 0}};
+  while(!stack.empty())
+  {
+    auto &frame = stack.back();
+    const auto &children = frame.item->children();
+    if(frame.next < children.size())
+    {
+      const auto child = children[frame.next++];
+      if(visibleOnly && !child->isVisible()) continue;
+
+      if(child->type() == Type::File)
+      {
+        const auto size = child->objectSize();
+        frame.bytes += size;
+        offer(heap, count, Candidate{size, child});
+      }
+      else
+      {
+        stack.push_back(Frame{child, 0, 0});
+      }
+      continue;
+    }
+
+    result = frame.bytes;
+    offer(heap, count, Candidate{result, frame.item});
+    stack.pop_back();
+
+    if(!stack.empty()) stack.back().bytes += result;
+  }
+
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<ReportUtils::LargestItem> ReportUtils::largestItems(const Items &items, const std::size_t count, const bool visibleOnly)
+{
+  // items inside other selected items are already reduced with them.
+  std::unordered_set<const Item *> selected(items.cbegin(), items.cend());
+  auto isNested = [&selected](const Item *item)
+  {
+    for(auto parent = item->parent(); parent; parent = parent->parent())
+    {
+      if(selected.count(parent) != 0) return true;
+    }
+    return false;
+  };
+
+  // each thread keeps its own bounded heap, they're merged at the end.
+  std::vector<std::vector<Candidate>> heaps(ParallelUtils::threadsCount() + 1);
+  auto &merged = heaps.back();
+
+  for(auto item: items)
+  {
+    if(isNested(item) || (visibleOnly && !item->isVisible())) continue;
+
+    if(item->type() == Type::File)
+    {
+      offer(merged, count, Candidate{item->objectSize(), item});
+      continue;
+    }
+
+    std::vector<const Item *> upper, subtrees;
+    splitSubtrees(item, visibleOnly, upper, subtrees);
+
+    std::vector<unsigned long long> subtreeSizes(subtrees.size());
+    auto reduceSubtree = [&](const std::size_t i, const std::size_t thread)
+    {
+      subtreeSizes[i] = reduceLargest(subtrees[i], visibleOnly, count, heaps[thread]);
+    };
+    ParallelUtils::runParallel(subtrees.size(), reduceSubtree);
+
+    // the sizes of the top directories are combined from the deepest ones, the selected directory is not a result.
+    std::unordered_map<const Item *, unsigned long long> sizes;
+    for(std::size_t i = 0; i < subtrees.size(); ++i) sizes.emplace(subtrees[i], subtreeSizes[i]);
+
+    for(auto it = upper.crbegin(); it != upper.crend(); ++it)
+    {
+      unsigned long long bytes = 0;
+      for(auto child: (*it)->children())
+      {
+        if(visibleOnly && !child->isVisible()) continue;
+
+        if(child->type() == Type::File)
+        {
+          bytes += child->objectSize();
+          offer(merged, count, Candidate{child->objectSize(), child});
+        }
+        else
+        {
+          bytes += sizes[child];
+        }
+      }
+
+      sizes[*it] = bytes;
+      if(*it != item) offer(merged, count, Candidate{bytes, *it});
+    }
+  }
+
+  for(std::size_t i = 0; i + 1 < heaps.size(); ++i)
+  {
+    for(auto &candidate: heaps[i]) offer(merged, count, candidate);
+  }
+
+  std::sort(merged.begin(), merged.end(), [](const Candidate &lhs, const Candidate &rhs) { return lhs.first > rhs.first; });
+
+  std::vector<LargestItem> result;
+  result.reserve(merged.size());
+  for(auto &candidate: merged)
+  {
+    result.push_back(LargestItem{candidate.second->fullName(), candidate.first, candidate.second->type()});
+  }
+
+  return result;
+}
@@ -0,0 +1,106 @@
+/*
+ File: ReportUtils.h
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPORTUTILS_H_
+#define REPORTUTILS_H_
+
+// Project
+#include <Model/ItemsTree.h>
+#include <Utils/ListExportUtils.h>
+
+// C++
+#include <memory>
+#include <string>
+#include <vector>
+
+// Qt
+#include <QString>
+
+namespace ReportUtils
+{
+  /** \struct DirectorySummary
+   * \brief Totals of the directories of the summarized subtrees, in depth-first order. Doesn't
+   * reference the items, so it can be written while the tree is modified.
+   *
+   */
+  struct DirectorySummary
+  {
+    /** \struct Row
+     * \brief Totals of a directory and its subdirectories.
+     *
+     */
+    struct Row
+    {
+      std::string        name;        /** UTF-8 directory name, full name for the summarized ones.   */
+      unsigned int       depth;       /** depth of the directory, 0 for the summarized directories. */
+      unsigned long long bytes;       /** size of the files.                                        */
+      unsigned long long files;       /** number of files.                                          */
+      unsigned long long directories; /** number of subdirectories.                                 */
+      unsigned long long largestSize; /** size of the largest file.                                 */
+      std::string        largest;     /** UTF-8 full name of the largest file, empty if none.       */
+    };
+
+    std::vector<Row> rows; /** directories up to the depth cutoff in depth-first order. */
+  };
+
+  /** \brief Returns the summary of the directories of the given snapshot and their subdirectories up
+   * to the given depth, the totals of the deeper directories are included in their ancestors. The
+   * subtrees are reduced in parallel in a single walk, so it can run in the export thread. Files
+   * are counted even if hidden by the filter. Advances the progress by the nodes without a row and
+   * returns null if cancelled.
+   * \param[in] snapshot Snapshot of the summarized directories, selected files are ignored.
+   * \param[in] maxDepth Depth of the deepest reported directories, 0 for the summarized ones.
+   * \param[inout] progress Export progress.
+   *
+   */
+  std::shared_ptr<const DirectorySummary> summarize(const ListExportUtils::Snapshot &snapshot, const unsigned int maxDepth, ListExportUtils::Progress &progress);
+
+  /** \brief Saves the given summary to a file with the given filename and format. Returns true on
+   * success and false on failure or if cancelled.
+   * \param[in] filename Output file name.
+   * \param[in] format Output file format.
+   * \param[in] summary Directory summary.
+   * \param[inout] progress Export progress.
+   *
+   */
+  bool saveSummary(const QString &filename, const ListExportUtils::Format format, const DirectorySummary &summary, ListExportUtils::Progress &progress);
+
+  /** \struct LargestItem
+   * \brief Result of the largest items query.
+   *
+   */
+  struct LargestItem
+  {
+    QString            name; /** full name of the item.                      */
+    unsigned long long size; /** size of the file or of the directory files. */
+    Type               type; /** item type.                                  */
+  };
+
+  /** \brief Returns the largest files and directories inside the given items, in descending order
+   * of size. The subtrees are reduced in parallel, each thread selecting its largest items. The
+   * given directories are not included in the results.
+   * \param[in] items Items to search.
+   * \param[in] count Maximum number of results.
+   * \param[in] visibleOnly True to ignore the items hidden by the filter.
+   *
+   */
+  std::vector<LargestItem> largestItems(const Items &items, const std::size_t count, const bool visibleOnly);
+};
+
+#endif // REPORTUTILS_H_
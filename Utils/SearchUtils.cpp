@@ -0,0 +1,273 @@
+/*
+ File: SearchUtils.cpp
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Project
+#include <Utils/SearchUtils.h>
+
+// C++
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SEARCH_VECTORIZED
+#include <immintrin.h>
+#endif
+
+using namespace SearchUtils;
+
+// maximum length of the words of a fuzzy query, the bit masks are 64 bits.
+const std::size_t MAX_WORD_LENGTH = 63;
+
+// minimum length of the words that can match with a typo.
+const std::size_t MIN_TYPO_LENGTH = 3;
+
+// scores of a word found as a substring, as a subsequence or with one typo.
+const int SUBSTRING_SCORE   = 100;
+const int SUBSEQUENCE_SCORE = 50;
+const int TYPO_SCORE        = 20;
+
+// bonuses of a substring at the start of the name or of a word of the name, or equal to the name.
+const int PREFIX_BONUS   = 30;
+const int BOUNDARY_BONUS = 20;
+const int EXACT_BONUS    = 50;
+
+using FindFunction = std::size_t (*)(const char *, const std::size_t, const char *, const std::size_t);
+
+//-----------------------------------------------------------------------------
+static std::size_t findScalar(const char *haystack, const std::size_t length, const char *needle, const std::size_t needleLength)
+{
+  if(needleLength > length) return NOT_FOUND;
+
+  const auto last = haystack + length - needleLength;
+  auto position = haystack;
+  while(position <= last)
+  {
+    position = static_cast<const char *>(std::memchr(position, needle[0], last - position + 1));
+    if(!position) break;
+
+    if(std::memcmp(position, needle, needleLength) == 0) return position - haystack;
+    ++position;
+  }
+
+  return NOT_FOUND;
+}
+
+#ifdef SEARCH_VECTORIZED
+
+// The blocks are compared with the first and the last bytes of the needle, only the positions
+// where both match are compared with the whole needle.
+
+//-----------------------------------------------------------------------------
+__attribute__((target("avx2")))
+static std::size_t findAVX2(const char *haystack, const std::size_t length, const char *needle, const std::size_t needleLength)
+{
+  if(needleLength > length) return NOT_FOUND;
+
+  const auto first = _mm256_set1_epi8(needle[0]);
+  const auto last  = _mm256_set1_epi8(needle[needleLength - 1]);
+
+  std::size_t i = 0;
+  for(; i + needleLength - 1 + 32 <= length; i += 32)
+  {
+    const auto firstBlock = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i));
+    const auto lastBlock  = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i + needleLength - 1));
+
+    auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, firstBlock), _mm256_cmpeq_epi8(last, lastBlock))));
+    while(mask != 0)
+    {
+      const auto bit = __builtin_ctz(mask);
+      if(std::memcmp(haystack + i + bit, needle, needleLength) == 0) return i + bit;
+      mask &= mask - 1;
+    }
+  }
+
+  const auto position = findScalar(haystack + i, length - i, needle, needleLength);
+  return position == NOT_FOUND ? NOT_FOUND : i + position;
+}
+
+//-----------------------------------------------------------------------------
+__attribute__((target("sse2")))
+static std::size_t findSSE2(const char *haystack, const std::size_t length, const char *needle, const std::size_t needleLength)
+{
+  if(needleLength > length) return NOT_FOUND;
+
+  const auto first = _mm_set1_epi8(needle[0]);
+  const auto last  = _mm_set1_epi8(needle[needleLength - 1]);
+
+  std::size_t i = 0;
+  for(; i + needleLength - 1 + 16 <= length; i += 16)
+  {
+    const auto firstBlock = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i));
+    const auto lastBlock  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i + needleLength - 1));
+
+    auto mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, firstBlock), _mm_cmpeq_epi8(last, lastBlock))));
+    while(mask != 0)
+    {
+      const auto bit = __builtin_ctz(mask);
+      if(std::memcmp(haystack + i + bit, needle, needleLength) == 0) return i + bit;
+      mask &= mask - 1;
+    }
+  }
+
+  const auto position = findScalar(haystack + i, length - i, needle, needleLength);
+  return position == NOT_FOUND ? NOT_FOUND : i + position;
+}
+
+#endif
+
+//-----------------------------------------------------------------------------
+static FindFunction findFunction()
+{
+#ifdef SEARCH_VECTORIZED
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx2")) return findAVX2;
+  if(__builtin_cpu_supports("sse2")) return findSSE2;
+#endif
+
+  return findScalar;
+}
+
+//-----------------------------------------------------------------------------
+std::size_t SearchUtils::find(const char *haystack, const std::size_t length, const char *needle, const std::size_t needleLength)
+{
+  // the processor is only queried once.
+  static const auto function = findFunction();
+
+  return function(haystack, length, needle, needleLength);
+}
+
+//-----------------------------------------------------------------------------
+static bool isBoundary(const char *name, const std::size_t position)
+{
+  return position == 0 || std::strchr(" _-./()[]", name[position - 1]) != nullptr;
+}
+
+//-----------------------------------------------------------------------------
+FuzzyPattern::FuzzyPattern(const std::string &query)
+{
+  std::size_t position = 0;
+  while(position < query.size())
+  {
+    const auto end = std::min(query.find(' ', position), query.size());
+    if(end > position)
+    {
+      Word word;
+      word.text = query.substr(position, std::min(end - position, MAX_WORD_LENGTH));
+      word.masks.fill(0);
+      for(std::size_t i = 0; i < word.text.size(); ++i)
+      {
+        word.masks[static_cast<unsigned char>(word.text[i])] |= std::uint64_t{1} << i;
+      }
+
+      m_words.push_back(std::move(word));
+    }
+
+    position = end + 1;
+  }
+}
+
+//-----------------------------------------------------------------------------
+int FuzzyPattern::score(const char *name, const std::size_t length) const
+{
+  // most names are rejected by the bytes they lack before scanning them for each word.
+  std::uint64_t present[4] = {0, 0, 0, 0};
+  for(std::size_t i = 0; i < length; ++i)
+  {
+    const auto byte = static_cast<unsigned char>(name[i]);
+    present[byte >> 6] |= std::uint64_t{1} << (byte & 63);
+  }
+
+  for(auto &word: m_words)
+  {
+    std::size_t missing = 0;
+    for(auto c: word.text)
+    {
+      const auto byte = static_cast<unsigned char>(c);
+      if(!(present[byte >> 6] & (std::uint64_t{1} << (byte & 63)))) ++missing;
+    }
+
+    // a typo can only replace or insert one byte.
+    if(missing > 1 || (missing == 1 && word.text.size() < MIN_TYPO_LENGTH)) return NO_MATCH;
+  }
+
+  int result = 0;
+  for(auto &word: m_words)
+  {
+    const auto wordResult = wordScore(word, name, length);
+    if(wordResult == NO_MATCH) return NO_MATCH;
+
+    result += wordResult;
+  }
+
+  // shorter names are slightly better.
+  return std::max(0, result - static_cast<int>(std::min<std::size_t>(length, 64) / 4));
+}
+
+//-----------------------------------------------------------------------------
+int FuzzyPattern::wordScore(const Word &word, const char *name, const std::size_t length) const
+{
+  const auto wordLength = word.text.size();
+
+  const auto position = find(name, length, word.text.data(), wordLength);
+  if(position != NOT_FOUND)
+  {
+    int bonus = position == 0 ? PREFIX_BONUS : (isBoundary(name, position) ? BOUNDARY_BONUS : 0);
+    if(wordLength == length) bonus += EXACT_BONUS;
+
+    return SUBSTRING_SCORE + bonus;
+  }
+
+  // the subsequence is matched greedily, consecutive bytes and word starts score higher.
+  std::size_t matched = 0, last = 0;
+  int consecutive = 0, boundaries = 0, gaps = 0;
+  for(std::size_t i = 0; i < length && matched < wordLength; ++i)
+  {
+    if(name[i] != word.text[matched]) continue;
+
+    if(matched > 0)
+    {
+      if(last + 1 == i) ++consecutive; else ++gaps;
+    }
+    if(isBoundary(name, i)) ++boundaries;
+    last = i;
+    ++matched;
+  }
+
+  if(matched == wordLength)
+  {
+    return std::max(TYPO_SCORE + 1, std::min(SUBSTRING_SCORE - 1, SUBSEQUENCE_SCORE + 2 * consecutive + 3 * boundaries - gaps));
+  }
+
+  if(wordLength < MIN_TYPO_LENGTH) return NO_MATCH;
+
+  // bit-parallel approximate search with one insertion, deletion or substitution.
+  const auto found = std::uint64_t{1} << (wordLength - 1);
+  std::uint64_t exact = 0, typo = 1;
+  for(std::size_t i = 0; i < length; ++i)
+  {
+    const auto mask = word.masks[static_cast<unsigned char>(name[i])];
+    const auto previous = exact;
+    exact = ((exact << 1) | 1) & mask;
+    typo  = (((typo << 1) | 1) & mask) | previous | (previous << 1) | (exact << 1) | 1;
+
+    if(typo & found) return TYPO_SCORE;
+  }
+
+  return NO_MATCH;
+}
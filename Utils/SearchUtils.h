@@ -0,0 +1,104 @@
+/*
+ File: SearchUtils.h
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEARCHUTILS_H_
+#define SEARCHUTILS_H_
+
+// C++
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SearchUtils
+{
+  /** \brief Position returned when the needle isn't found.
+   *
+   */
+  const std::size_t NOT_FOUND = static_cast<std::size_t>(-1);
+
+  /** \brief Returns the position of the first occurrence of the needle in the haystack or NOT_FOUND.
+   * The bytes are compared exactly, both must be case folded before. Compares 32 or 16 positions at
+   * once with AVX2 or SSE2 when the processor supports them.
+   * \param[in] haystack Text to search.
+   * \param[in] length Length of the haystack in bytes.
+   * \param[in] needle Text to find.
+   * \param[in] needleLength Length of the needle in bytes, greater than 0.
+   *
+   */
+  std::size_t find(const char *haystack, const std::size_t length, const char *needle, const std::size_t needleLength);
+
+  /** \class FuzzyPattern
+   * \brief Scores names against a query of space separated words in any order. Each word
+   * scores highest as a substring, then as a subsequence of the name and last with one
+   * typo. Names must contain all the words. Scoring is thread safe.
+   *
+   */
+  class FuzzyPattern
+  {
+    public:
+      /** \brief Score of the names that don't match.
+       *
+       */
+      static const int NO_MATCH = -1;
+
+      /** \brief FuzzyPattern class constructor.
+       * \param[in] query Case folded UTF-8 query.
+       *
+       */
+      explicit FuzzyPattern(const std::string &query);
+
+      /** \brief Returns true if the query doesn't have words.
+       *
+       */
+      bool isEmpty() const
+      { return m_words.empty(); }
+
+      /** \brief Returns the score of the given name, higher is better, or NO_MATCH.
+       * \param[in] name Case folded UTF-8 name.
+       * \param[in] length Length of the name in bytes.
+       *
+       */
+      int score(const char *name, const std::size_t length) const;
+
+    private:
+      /** \struct Word
+       * \brief Word of the query and its bit masks for the approximate search.
+       *
+       */
+      struct Word
+      {
+        std::string                    text;  /** word bytes, up to 63.                               */
+        std::array<std::uint64_t, 256> masks; /** bit i of a byte mask is set if the byte is text[i]. */
+      };
+
+      /** \brief Returns the score of the given word in the given name, or NO_MATCH.
+       * \param[in] word Query word.
+       * \param[in] name Case folded UTF-8 name.
+       * \param[in] length Length of the name in bytes.
+       *
+       */
+      int wordScore(const Word &word, const char *name, const std::size_t length) const;
+
+      std::vector<Word> m_words; /** words of the query. */
+  };
+};
+
+#endif // SEARCHUTILS_H_
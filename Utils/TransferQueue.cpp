@@ -0,0 +1,224 @@
+/*
+ File: TransferQueue.cpp
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Project
+#include <Utils/TransferQueue.h>
+
+// AWS
+#include <aws/core/utils/memory/AWSMemory.h>
+#include <aws/core/utils/threading/Executor.h>
+
+// C++
+#include <algorithm>
+#include <climits>
+
+static const char *ALLOCATION_TAG = "SuperDuckQueue";
+
+// threads of the executor shared by all the operations.
+const unsigned int EXECUTOR_THREADS = 16;
+
+//-----------------------------------------------------------------------------
+QString AWSUtils::priorityToText(const Priority priority)
+{
+  switch(priority)
+  {
+    case Priority::low:
+      return "Low";
+      break;
+    case Priority::high:
+      return "High";
+      break;
+    case Priority::normal:
+    default:
+      break;
+  }
+
+  return "Normal";
+}
+
+//-----------------------------------------------------------------------------
+AWSUtils::TransferQueue::TransferQueue(const unsigned int maxRunning, QObject* parent)
+: QObject     (parent)
+, m_maxRunning{std::max(1U, maxRunning)}
+, m_order     {0}
+, m_executor  {Aws::MakeShared<Aws::Utils::Threading::PooledThreadExecutor>(ALLOCATION_TAG, EXECUTOR_THREADS)}
+{
+}
+
+//-----------------------------------------------------------------------------
+AWSUtils::TransferQueue::~TransferQueue()
+{
+  stop(ULONG_MAX);
+}
+
+//-----------------------------------------------------------------------------
+AWSUtils::S3Thread* AWSUtils::TransferQueue::enqueue(const Operation& operation, const Priority priority)
+{
+  auto thread = new S3Thread(operation);
+  thread->setExecutor(m_executor);
+
+  connect(thread, SIGNAL(finished()), this, SLOT(onThreadFinished()));
+
+  m_pending << Job{thread, priority, m_order++};
+
+  emit jobAdded(thread);
+
+  schedule();
+
+  return thread;
+}
+
+//-----------------------------------------------------------------------------
+void AWSUtils::TransferQueue::setMaxRunning(const unsigned int value)
+{
+  m_maxRunning = std::max(1U, value);
+
+  schedule();
+}
+
+//-----------------------------------------------------------------------------
+void AWSUtils::TransferQueue::setPriority(S3Thread* job, const Priority priority)
+{
+  auto it = std::find_if(m_pending.begin(), m_pending.end(), [job](const Job &j) { return j.thread == job; });
+  if(it != m_pending.end() && (*it).priority != priority)
+  {
+    (*it).priority = priority;
+
+    emit jobPriorityChanged(job);
+  }
+}
+
+//-----------------------------------------------------------------------------
+AWSUtils::Priority AWSUtils::TransferQueue::priority(S3Thread* job) const
+{
+  auto findJob = [job](const Job &j) { return j.thread == job; };
+
+  auto it = std::find_if(m_pending.cbegin(), m_pending.cend(), findJob);
+  if(it != m_pending.cend()) return (*it).priority;
+
+  it = std::find_if(m_running.cbegin(), m_running.cend(), findJob);
+  if(it != m_running.cend()) return (*it).priority;
+
+  return Priority::normal;
+}
+
+//-----------------------------------------------------------------------------
+bool AWSUtils::TransferQueue::isRunning(S3Thread* job) const
+{
+  return std::any_of(m_running.cbegin(), m_running.cend(), [job](const Job &j) { return j.thread == job; });
+}
+
+//-----------------------------------------------------------------------------
+void AWSUtils::TransferQueue::cancel(S3Thread* job)
+{
+  auto it = std::find_if(m_pending.begin(), m_pending.end(), [job](const Job &j) { return j.thread == job; });
+  if(it != m_pending.end())
+  {
+    m_pending.erase(it);
+    job->abort();
+
+    finish(job);
+    return;
+  }
+
+  if(isRunning(job)) job->abort();
+}
+
+//-----------------------------------------------------------------------------
+void AWSUtils::TransferQueue::cancelAll()
+{
+  auto pending = m_pending;
+  m_pending.clear();
+
+  std::for_each(pending.cbegin(), pending.cend(), [this](const Job &j) { j.thread->abort(); finish(j.thread); });
+  std::for_each(m_running.cbegin(), m_running.cend(), [](const Job &j) { j.thread->abort(); });
+}
+
+//-----------------------------------------------------------------------------
+void AWSUtils::TransferQueue::stop(const unsigned long milliseconds)
+{
+  cancelAll();
+
+  // threads are not finished by the event loop anymore, disconnect and delete them here. The ones
+  // still running after the wait stay in the list, the destructor waits for them.
+  for(auto it = m_running.begin(); it != m_running.end();)
+  {
+    auto thread = (*it).thread;
+    thread->disconnect();
+    thread->wait(milliseconds);
+
+    if(thread->isFinished())
+    {
+      delete thread;
+      it = m_running.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void AWSUtils::TransferQueue::onThreadFinished()
+{
+  auto thread = qobject_cast<S3Thread *>(sender());
+  if(thread)
+  {
+    auto it = std::find_if(m_running.begin(), m_running.end(), [thread](const Job &j) { return j.thread == thread; });
+    if(it != m_running.end())
+    {
+      m_running.erase(it);
+
+      finish(thread);
+    }
+  }
+
+  schedule();
+}
+
+//-----------------------------------------------------------------------------
+void AWSUtils::TransferQueue::schedule()
+{
+  auto higherPriority = [](const Job &lhs, const Job &rhs)
+  {
+    if(lhs.priority != rhs.priority) return lhs.priority > rhs.priority;
+    return lhs.order < rhs.order;
+  };
+
+  while(!m_pending.isEmpty() && static_cast<unsigned int>(m_running.size()) < m_maxRunning)
+  {
+    auto it = std::min_element(m_pending.begin(), m_pending.end(), higherPriority);
+    auto job = *it;
+    m_pending.erase(it);
+
+    m_running << job;
+    job.thread->start();
+
+    emit jobStarted(job.thread);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void AWSUtils::TransferQueue::finish(S3Thread* thread)
+{
+  emit jobFinished(thread);
+
+  thread->deleteLater();
+}
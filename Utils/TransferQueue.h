@@ -0,0 +1,175 @@
+/*
+ File: TransferQueue.h
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRANSFERQUEUE_H_
+#define TRANSFERQUEUE_H_
+
+// Project
+#include <Utils/AWSUtils.h>
+
+// C++
+#include <memory>
+
+// AWS
+#include <aws/core/utils/threading/Executor.h>
+
+// Qt
+#include <QObject>
+#include <QList>
+
+namespace AWSUtils
+{
+  enum class Priority: char { low = 0, normal, high };
+
+  /** \brief Returns the text of the given priority.
+   * \param[in] priority Job priority.
+   *
+   */
+  QString priorityToText(const Priority priority);
+
+  /** \class TransferQueue
+   * \brief Queue of operations over the bucket. Runs the operations by priority and order of
+   * arrival, with a maximum number of operations running at the same time, all of them sharing
+   * the same executor.
+   *
+   */
+  class TransferQueue
+  : public QObject
+  {
+      Q_OBJECT
+    public:
+      /** \brief TransferQueue class constructor.
+       * \param[in] maxRunning Maximum number of operations running at the same time.
+       * \param[in] parent Raw pointer of the QObject parent of this one.
+       *
+       */
+      explicit TransferQueue(const unsigned int maxRunning, QObject *parent = nullptr);
+
+      /** \brief TransferQueue class virtual destructor. Aborts the running operations and waits for
+       * them without a limit, so none of them uses the SDK after it's shut down.
+       *
+       */
+      virtual ~TransferQueue();
+
+      /** \brief Adds an operation to the queue and returns the thread that will execute it.
+       * \param[in] operation Operation struct.
+       * \param[in] priority Operation priority.
+       *
+       */
+      S3Thread *enqueue(const Operation &operation, const Priority priority = Priority::normal);
+
+      /** \brief Sets the maximum number of operations running at the same time.
+       * \param[in] value Number of operations.
+       *
+       */
+      void setMaxRunning(const unsigned int value);
+
+      /** \brief Returns the maximum number of operations running at the same time.
+       *
+       */
+      unsigned int maxRunning() const
+      { return m_maxRunning; }
+
+      /** \brief Changes the priority of a pending operation.
+       * \param[in] job Operation thread.
+       * \param[in] priority New priority.
+       *
+       */
+      void setPriority(S3Thread *job, const Priority priority);
+
+      /** \brief Returns the priority of the given operation.
+       * \param[in] job Operation thread.
+       *
+       */
+      Priority priority(S3Thread *job) const;
+
+      /** \brief Returns true if the given operation is running and false if it's pending.
+       * \param[in] job Operation thread.
+       *
+       */
+      bool isRunning(S3Thread *job) const;
+
+      /** \brief Cancels the given operation, running or pending.
+       * \param[in] job Operation thread.
+       *
+       */
+      void cancel(S3Thread *job);
+
+      /** \brief Cancels all the operations.
+       *
+       */
+      void cancelAll();
+
+      /** \brief Returns true if there are no operations running or pending.
+       *
+       */
+      bool isEmpty() const
+      { return m_pending.isEmpty() && m_running.isEmpty(); }
+
+      /** \brief Cancels all the operations and waits for the running ones to finish. The operations
+       * that don't finish in time are kept and waited again by the next stop or the destructor.
+       * \param[in] milliseconds Maximum time to wait for each operation.
+       *
+       */
+      void stop(const unsigned long milliseconds);
+
+    signals:
+      void jobAdded(AWSUtils::S3Thread *);
+      void jobStarted(AWSUtils::S3Thread *);
+      void jobFinished(AWSUtils::S3Thread *);
+      void jobPriorityChanged(AWSUtils::S3Thread *);
+
+    private slots:
+      /** \brief Finishes the operation that emitted the signal and starts the pending ones.
+       *
+       */
+      void onThreadFinished();
+
+    private:
+      /** \struct Job
+       * \brief Queued operation.
+       *
+       */
+      struct Job
+      {
+        S3Thread          *thread;   /** operation thread.                      */
+        Priority           priority; /** operation priority.                    */
+        unsigned long long order;    /** arrival order for equal priority jobs. */
+      };
+
+      /** \brief Starts the pending operations while under the running operations limit.
+       *
+       */
+      void schedule();
+
+      /** \brief Notifies the end of the operation and schedules its deletion.
+       * \param[in] thread Operation thread.
+       *
+       */
+      void finish(S3Thread *thread);
+
+      unsigned int                                                 m_maxRunning; /** maximum number of running operations. */
+      unsigned long long                                           m_order;      /** arrival counter.                      */
+      QList<Job>                                                   m_pending;    /** pending operations.                   */
+      QList<Job>                                                   m_running;    /** running operations.                   */
+      std::shared_ptr<Aws::Utils::Threading::PooledThreadExecutor> m_executor;   /** executor shared by all operations.    */
+  };
+};
+
+#endif // TRANSFERQUEUE_H_
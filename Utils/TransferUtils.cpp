@@ -0,0 +1,659 @@
+/*
+ File: TransferUtils.cpp
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Project
+#include <Utils/TransferUtils.h>
+
+// C++
+#include <algorithm>
+#include <iterator>
+#include <thread>
+
+// Qt
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+
+// maximum burst allowed after an idle period, in seconds of rate.
+const double MAX_BURST = 0.25;
+
+// maximum number of files found and not consumed, the walk waits when reached.
+const std::size_t MAX_ENTRIES = 65536;
+
+// files found by a thread before handing them to the consumer.
+const std::size_t ENTRIES_BATCH = 256;
+
+// weight of the last sample in the smoothed rates.
+const double RATE_SMOOTHING = 0.3;
+
+// alignment of the pool buffers, a memory page.
+const std::size_t BUFFER_ALIGNMENT = 4096;
+
+// default memory budget of the buffer pool.
+const unsigned long long DEFAULT_POOL_BUDGET = 512ULL*1024*1024;
+
+// share of the pool budget that can be reserved, the rest is kept for the buffers so the
+// operations holding reservations can't starve them.
+const double RESERVABLE_SHARE = 0.75;
+
+//-----------------------------------------------------------------------------
+TransferUtils::BandwidthLimiter::BandwidthLimiter(const long long rate)
+: m_rate  {std::max(0LL, rate)}
+, m_tokens{0}
+, m_last  (Clock::now())
+{
+}
+
+//-----------------------------------------------------------------------------
+TransferUtils::BandwidthLimiter::DelayType TransferUtils::BandwidthLimiter::ApplyCost(int64_t cost)
+{
+  const double rate = m_rate;
+  if(rate <= 0 || cost <= 0) return DelayType(0);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  const auto now = Clock::now();
+  const std::chrono::duration<double> elapsed = now - m_last;
+  m_last = now;
+
+  m_tokens = std::min(m_tokens + elapsed.count() * rate, rate * MAX_BURST);
+  m_tokens -= cost;
+
+  if(m_tokens >= 0) return DelayType(0);
+
+  return std::chrono::duration_cast<DelayType>(std::chrono::duration<double>(-m_tokens / rate));
+}
+
+//-----------------------------------------------------------------------------
+void TransferUtils::BandwidthLimiter::ApplyAndPayForCost(int64_t cost)
+{
+  const auto delay = ApplyCost(cost);
+
+  if(delay.count() > 0) std::this_thread::sleep_for(delay);
+}
+
+//-----------------------------------------------------------------------------
+void TransferUtils::BandwidthLimiter::SetRate(int64_t rate, bool resetAccumulator)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  rate = std::max<int64_t>(0, rate);
+  if(rate != m_rate || resetAccumulator)
+  {
+    // debt accumulated with the old rate must not delay the transfers with the new one.
+    m_tokens = resetAccumulator ? 0 : std::max(0., m_tokens);
+    m_last   = Clock::now();
+    m_rate   = rate;
+  }
+}
+
+//-----------------------------------------------------------------------------
+std::shared_ptr<TransferUtils::BandwidthLimiter> TransferUtils::uploadLimiter()
+{
+  static auto limiter = std::make_shared<BandwidthLimiter>();
+
+  return limiter;
+}
+
+//-----------------------------------------------------------------------------
+std::shared_ptr<TransferUtils::BandwidthLimiter> TransferUtils::downloadLimiter()
+{
+  static auto limiter = std::make_shared<BandwidthLimiter>();
+
+  return limiter;
+}
+
+//-----------------------------------------------------------------------------
+std::shared_ptr<TransferUtils::BufferPool> TransferUtils::bufferPool()
+{
+  static auto pool = std::make_shared<BufferPool>(DEFAULT_POOL_BUDGET);
+
+  return pool;
+}
+
+//-----------------------------------------------------------------------------
+TransferUtils::BufferPool::Buffer::Buffer()
+: m_pool {nullptr}
+, m_block{nullptr, nullptr, 0}
+{
+}
+
+//-----------------------------------------------------------------------------
+TransferUtils::BufferPool::Buffer::Buffer(Buffer &&other)
+: m_pool {other.m_pool}
+, m_block(other.m_block)
+{
+  other.m_pool  = nullptr;
+  other.m_block = Block{nullptr, nullptr, 0};
+}
+
+//-----------------------------------------------------------------------------
+TransferUtils::BufferPool::Buffer &TransferUtils::BufferPool::Buffer::operator=(Buffer &&other)
+{
+  if(this != &other)
+  {
+    reset();
+
+    m_pool  = other.m_pool;
+    m_block = other.m_block;
+
+    other.m_pool  = nullptr;
+    other.m_block = Block{nullptr, nullptr, 0};
+  }
+
+  return *this;
+}
+
+//-----------------------------------------------------------------------------
+void TransferUtils::BufferPool::Buffer::reset()
+{
+  if(m_pool && m_block.raw) m_pool->giveBack(m_block);
+
+  m_pool  = nullptr;
+  m_block = Block{nullptr, nullptr, 0};
+}
+
+//-----------------------------------------------------------------------------
+TransferUtils::BufferPool::BufferPool(const unsigned long long budget)
+: m_budget  {budget}
+, m_used    {0}
+, m_reserved{0}
+, m_cached  {0}
+{
+}
+
+//-----------------------------------------------------------------------------
+TransferUtils::BufferPool::~BufferPool()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  for(auto &block: m_free) delete [] block.second.raw;
+  m_free.clear();
+}
+
+//-----------------------------------------------------------------------------
+void TransferUtils::BufferPool::setBudget(const unsigned long long budget)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_budget = budget;
+
+  evict(0);
+  m_available.notify_all();
+}
+
+//-----------------------------------------------------------------------------
+unsigned long long TransferUtils::BufferPool::budget() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_budget;
+}
+
+//-----------------------------------------------------------------------------
+TransferUtils::BufferPool::Buffer TransferUtils::BufferPool::acquire(const std::size_t size)
+{
+  Buffer buffer;
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  // a cached block of the same size doesn't change the memory in use.
+  auto it = m_free.find(size);
+  if(it == m_free.end() || !fits(size))
+  {
+    m_available.wait(lock, [this, size]() { return fits(size); });
+    it = m_free.find(size);
+  }
+
+  if(it != m_free.end())
+  {
+    buffer.m_block = (*it).second;
+    m_free.erase(it);
+    m_cached -= size;
+  }
+  else
+  {
+    evict(size);
+
+    auto raw = new char[size + BUFFER_ALIGNMENT];
+    const auto offset = BUFFER_ALIGNMENT - (reinterpret_cast<std::uintptr_t>(raw) % BUFFER_ALIGNMENT);
+    buffer.m_block = Block{raw, raw + offset, size};
+  }
+
+  m_used += size;
+  buffer.m_pool = this;
+
+  return buffer;
+}
+
+//-----------------------------------------------------------------------------
+std::unique_ptr<TransferUtils::BufferPool::Reservation> TransferUtils::BufferPool::reserve(const unsigned long long minimum, const unsigned long long maximum, CancellationToken &token)
+{
+  // wakes up the waiting thread if the caller is cancelled.
+  CancellationScope wakeUp(token, [this]()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_available.notify_all();
+  });
+
+  auto canReserve = [this](const unsigned long long bytes)
+  {
+    return m_reserved + bytes <= static_cast<unsigned long long>(m_budget * RESERVABLE_SHARE) && m_used + bytes <= m_budget;
+  };
+
+  // the first reservation is always served.
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_available.wait(lock, [&]() { return token.isCancelled() || m_reserved == 0 || canReserve(minimum); });
+
+  unsigned long long bytes = 0;
+  if(!token.isCancelled())
+  {
+    // as many multiples of the minimum as available, without waiting for more.
+    bytes = minimum;
+    while(minimum > 0 && bytes + minimum <= maximum && canReserve(bytes + minimum)) bytes += minimum;
+
+    evict(bytes);
+    m_used     += bytes;
+    m_reserved += bytes;
+  }
+
+  return std::unique_ptr<Reservation>(new Reservation(this, bytes));
+}
+
+//-----------------------------------------------------------------------------
+void TransferUtils::BufferPool::giveBack(const Block &block)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_used -= block.size;
+
+  // keep the block for reuse only if it fits in the budget.
+  if(m_used + m_cached + block.size <= m_budget)
+  {
+    m_free.emplace(block.size, block);
+    m_cached += block.size;
+  }
+  else
+  {
+    delete [] block.raw;
+  }
+
+  m_available.notify_all();
+}
+
+//-----------------------------------------------------------------------------
+void TransferUtils::BufferPool::release(const unsigned long long bytes)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_used     -= bytes;
+  m_reserved -= bytes;
+
+  m_available.notify_all();
+}
+
+//-----------------------------------------------------------------------------
+void TransferUtils::BufferPool::evict(const unsigned long long bytes)
+{
+  // bigger blocks first, they are the least reused.
+  while(!m_free.empty() && m_used + m_cached + bytes > m_budget)
+  {
+    auto it = std::prev(m_free.end());
+    m_cached -= (*it).second.size;
+    delete [] (*it).second.raw;
+    m_free.erase(it);
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool TransferUtils::BufferPool::fits(const unsigned long long bytes) const
+{
+  // a request bigger than the budget is served when nothing else is using memory.
+  return m_used + bytes <= m_budget || m_used == 0;
+}
+
+//-----------------------------------------------------------------------------
+TransferUtils::DirectoryScanner::DirectoryScanner(const QString& path, const unsigned int threads)
+: m_path      {QDir::cleanPath(path)}
+, m_threadsNum{std::max(1U, threads)}
+, m_busy      {0}
+, m_files     {0}
+, m_finished  {false}
+, m_abort     {false}
+{
+}
+
+//-----------------------------------------------------------------------------
+TransferUtils::DirectoryScanner::~DirectoryScanner()
+{
+  abort();
+
+  std::for_each(m_threads.begin(), m_threads.end(), [](std::thread &t) { if(t.joinable()) t.join(); });
+}
+
+//-----------------------------------------------------------------------------
+void TransferUtils::DirectoryScanner::start()
+{
+  if(!m_threads.empty()) return;
+
+  const auto name = QFileInfo(m_path).fileName();
+  const auto key  = name.toStdString();
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.emplace_back(m_path, key);
+    m_directories.push_back(key);
+  }
+
+  for(unsigned int i = 0; i < m_threadsNum; ++i)
+  {
+    m_threads.emplace_back(&DirectoryScanner::scan, this);
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool TransferUtils::DirectoryScanner::next(Entry& entry)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  m_entriesCV.wait(lock, [this]() { return m_abort || m_finished || !m_entries.empty(); });
+
+  if(m_abort || m_entries.empty()) return false;
+
+  entry = std::move(m_entries.front());
+  m_entries.pop_front();
+
+  if(m_entries.size() == MAX_ENTRIES - 1) m_walkCV.notify_all();
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void TransferUtils::DirectoryScanner::abort()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_abort = true;
+  }
+
+  m_walkCV.notify_all();
+  m_entriesCV.notify_all();
+}
+
+//-----------------------------------------------------------------------------
+std::vector<std::string> TransferUtils::DirectoryScanner::directories() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_directories;
+}
+
+//-----------------------------------------------------------------------------
+void TransferUtils::DirectoryScanner::scan()
+{
+  std::vector<Entry> found;
+  std::vector<Directory> subdirectories;
+
+  // hands the files found to the consumer, waiting if there are too many not consumed.
+  auto flush = [&found, this](std::unique_lock<std::mutex> &lock)
+  {
+    m_walkCV.wait(lock, [this]() { return m_abort || m_entries.size() < MAX_ENTRIES; });
+
+    std::move(found.begin(), found.end(), std::back_inserter(m_entries));
+    m_files += found.size();
+    found.clear();
+
+    m_entriesCV.notify_one();
+  };
+
+  while(true)
+  {
+    Directory directory;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_walkCV.wait(lock, [this]() { return m_abort || !m_pending.empty() || m_busy == 0; });
+
+      if(m_abort || m_pending.empty()) break;
+
+      directory = std::move(m_pending.front());
+      m_pending.pop_front();
+      ++m_busy;
+    }
+
+    QDirIterator it(directory.first, QDir::Files|QDir::Dirs|QDir::Hidden|QDir::NoDotAndDotDot);
+    while(it.hasNext() && !m_abort)
+    {
+      it.next();
+      const auto info = it.fileInfo();
+
+      // links to directories could create cycles.
+      if(info.isSymLink() && info.isDir()) continue;
+
+      const auto key = directory.second + "/" + info.fileName().toStdString();
+      if(info.isDir())
+      {
+        subdirectories.emplace_back(info.absoluteFilePath(), key);
+      }
+      else
+      {
+        if(info.isReadable()) found.push_back(Entry{info.absoluteFilePath().toStdString(), key, static_cast<unsigned long long>(info.size())});
+
+        if(found.size() == ENTRIES_BATCH)
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          flush(lock);
+        }
+      }
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if(!found.empty()) flush(lock);
+
+    for(auto &subdirectory: subdirectories)
+    {
+      m_directories.push_back(subdirectory.second);
+      m_pending.push_back(std::move(subdirectory));
+    }
+    subdirectories.clear();
+
+    --m_busy;
+
+    if(m_busy == 0 && m_pending.empty())
+    {
+      m_finished = true;
+      m_entriesCV.notify_all();
+    }
+
+    m_walkCV.notify_all();
+  }
+
+  m_walkCV.notify_all();
+}
+
+//-----------------------------------------------------------------------------
+TransferUtils::CancellationToken::CancellationToken()
+: m_cancelled{false}
+, m_nextId   {0}
+{
+}
+
+//-----------------------------------------------------------------------------
+void TransferUtils::CancellationToken::cancel()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if(m_cancelled) return;
+
+  m_cancelled = true;
+  m_condition.notify_all();
+
+  // callbacks run with the lock held so unsubscribe() waits for them.
+  for(auto &callback: m_callbacks) callback.second();
+}
+
+//-----------------------------------------------------------------------------
+bool TransferUtils::CancellationToken::waitFor(const std::chrono::milliseconds &time)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  return m_condition.wait_for(lock, time, [this]() { return m_cancelled.load(); });
+}
+
+//-----------------------------------------------------------------------------
+unsigned long long TransferUtils::CancellationToken::subscribe(Callback callback)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  const auto id = m_nextId++;
+
+  if(m_cancelled)
+  {
+    lock.unlock();
+    callback();
+  }
+  else
+  {
+    m_callbacks.emplace(id, callback);
+  }
+
+  return id;
+}
+
+//-----------------------------------------------------------------------------
+void TransferUtils::CancellationToken::unsubscribe(const unsigned long long id)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_callbacks.erase(id);
+}
+
+//-----------------------------------------------------------------------------
+TransferUtils::TransferProgress::TransferProgress(const QString &name, const unsigned long long size)
+: m_name       {name}
+, m_size       {size}
+, m_transferred{0}
+, m_total      {size}
+{
+}
+
+//-----------------------------------------------------------------------------
+TransferUtils::ProgressTracker::ProgressTracker()
+: m_bytes       {0}
+, m_objects     {0}
+, m_totalBytes  {0}
+, m_totalObjects{0}
+, m_lastTime    {Clock::now()}
+, m_lastBytes   {0}
+, m_lastObjects {0}
+, m_bytesRate   {0}
+, m_objectsRate {0}
+{
+}
+
+//-----------------------------------------------------------------------------
+void TransferUtils::ProgressTracker::addTotal(const unsigned long long objects, const unsigned long long bytes)
+{
+  m_totalObjects += objects;
+  m_totalBytes   += bytes;
+}
+
+//-----------------------------------------------------------------------------
+std::shared_ptr<TransferUtils::TransferProgress> TransferUtils::ProgressTracker::start(const QString &name, const unsigned long long size)
+{
+  auto transfer = std::make_shared<TransferProgress>(name, size);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_transfers.push_back(transfer);
+
+  return transfer;
+}
+
+//-----------------------------------------------------------------------------
+void TransferUtils::ProgressTracker::finish(std::shared_ptr<TransferProgress> transfer)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = std::find(m_transfers.begin(), m_transfers.end(), transfer);
+  if(it == m_transfers.end()) return;
+
+  // order is not important, avoid moving the rest.
+  std::swap(*it, m_transfers.back());
+  m_transfers.pop_back();
+
+  finish(transfer->size());
+}
+
+//-----------------------------------------------------------------------------
+void TransferUtils::ProgressTracker::finish(const unsigned long long size)
+{
+  m_bytes += size;
+  ++m_objects;
+}
+
+//-----------------------------------------------------------------------------
+TransferUtils::ProgressSample TransferUtils::ProgressTracker::sample()
+{
+  ProgressSample result;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // finished objects are read with the lock so a transfer is not counted twice.
+    result.bytes   = m_bytes;
+    result.objects = m_objects;
+
+    result.transfers.reserve(m_transfers.size());
+    for(auto &transfer: m_transfers)
+    {
+      const auto total       = transfer->total();
+      const auto transferred = std::min(transfer->transferred(), total);
+
+      result.bytes += transferred;
+      result.transfers.emplace_back(transfer->name(), total == 0 ? 0 : static_cast<int>((transferred * 100) / total));
+    }
+  }
+
+  result.totalBytes   = std::max<unsigned long long>(m_totalBytes, result.bytes);
+  result.totalObjects = std::max<unsigned long long>(m_totalObjects, result.objects);
+
+  const auto now     = Clock::now();
+  const auto elapsed = std::chrono::duration<double>(now - m_lastTime).count();
+  if(elapsed > 0)
+  {
+    // retries can move the transferred bytes backwards.
+    const auto bytes   = result.bytes > m_lastBytes ? result.bytes - m_lastBytes : 0;
+    const auto objects = result.objects - m_lastObjects;
+
+    m_bytesRate   = RATE_SMOOTHING * (bytes / elapsed) + (1 - RATE_SMOOTHING) * m_bytesRate;
+    m_objectsRate = RATE_SMOOTHING * (objects / elapsed) + (1 - RATE_SMOOTHING) * m_objectsRate;
+
+    m_lastTime    = now;
+    m_lastBytes   = result.bytes;
+    m_lastObjects = result.objects;
+  }
+
+  result.bytesPerSecond   = m_bytesRate;
+  result.objectsPerSecond = m_objectsRate;
+
+  if(result.totalBytes > 0 && m_bytesRate > 1)
+  {
+    result.eta = static_cast<long long>((result.totalBytes - result.bytes) / m_bytesRate);
+  }
+  else if(m_objectsRate > 0.01)
+  {
+    result.eta = static_cast<long long>((result.totalObjects - result.objects) / m_objectsRate);
+  }
+
+  return result;
+}
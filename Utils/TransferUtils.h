@@ -0,0 +1,621 @@
+/*
+ File: TransferUtils.h
+ Created on: 18/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRANSFERUTILS_H_
+#define TRANSFERUTILS_H_
+
+// C++
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <winsock2.h>
+
+// AWS
+#include <aws/core/client/AsyncCallerContext.h>
+#include <aws/core/utils/ratelimiter/RateLimiterInterface.h>
+
+// Qt
+#include <QString>
+
+namespace TransferUtils
+{
+  /** \class BandwidthLimiter
+   * \brief Token bucket rate limiter in bytes per second. The cost of every chunk of data sent or
+   * received is paid in arrival order, so concurrent transfers share the rate without starving the
+   * small ones. The rate can be modified while the transfers are running.
+   *
+   */
+  class BandwidthLimiter
+  : public Aws::Utils::RateLimits::RateLimiterInterface
+  {
+    public:
+      /** \brief BandwidthLimiter class constructor.
+       * \param[in] rate Rate in bytes per second, 0 for unlimited.
+       *
+       */
+      explicit BandwidthLimiter(const long long rate = 0);
+
+      /** \brief BandwidthLimiter class virtual destructor.
+       *
+       */
+      virtual ~BandwidthLimiter()
+      {};
+
+      /** \brief Pays the given cost in bytes and returns the time the caller must wait.
+       * \param[in] cost Number of bytes.
+       *
+       */
+      virtual DelayType ApplyCost(int64_t cost) override;
+
+      /** \brief Pays the given cost in bytes and waits until it's within the rate.
+       * \param[in] cost Number of bytes.
+       *
+       */
+      virtual void ApplyAndPayForCost(int64_t cost) override;
+
+      /** \brief Sets the rate of the limiter.
+       * \param[in] rate Rate in bytes per second, 0 for unlimited.
+       * \param[in] resetAccumulator True to discard the accumulated debt and tokens.
+       *
+       */
+      virtual void SetRate(int64_t rate, bool resetAccumulator = false) override;
+
+      /** \brief Returns the current rate in bytes per second, 0 if unlimited.
+       *
+       */
+      long long rate() const
+      { return m_rate; }
+
+    private:
+      using Clock = std::chrono::steady_clock;
+
+      std::mutex             m_mutex;  /** protects the bucket state.                                 */
+      std::atomic<long long> m_rate;   /** rate in bytes per second, 0 for unlimited.                 */
+      double                 m_tokens; /** available bytes in the bucket, negative if there is debt. */
+      Clock::time_point      m_last;   /** last time the bucket was refilled.                         */
+  };
+
+  /** \brief Returns the limiter shared by all the uploads.
+   *
+   */
+  std::shared_ptr<BandwidthLimiter> uploadLimiter();
+
+  /** \brief Returns the limiter shared by all the downloads.
+   *
+   */
+  std::shared_ptr<BandwidthLimiter> downloadLimiter();
+
+  /** \class DirectoryScanner
+   * \brief Walks a local directory tree using several threads. The files found are streamed to
+   * the consumer while the walk is still running, so the transfers can start immediately. Keys are
+   * relative to the parent of the scanned directory and use '/' as separator.
+   *
+   */
+  class DirectoryScanner
+  {
+    public:
+      /** \struct Entry
+       * \brief File found during the scan.
+       *
+       */
+      struct Entry
+      {
+        std::string        path; /** absolute path of the file on disk. */
+        std::string        key;  /** relative key of the file.          */
+        unsigned long long size; /** size of the file in bytes.         */
+      };
+
+      /** \brief DirectoryScanner class constructor.
+       * \param[in] path Absolute path of the directory to scan.
+       * \param[in] threads Number of threads walking the tree.
+       *
+       */
+      explicit DirectoryScanner(const QString &path, const unsigned int threads = 4);
+
+      /** \brief DirectoryScanner class destructor. Aborts the scan if still running.
+       *
+       */
+      ~DirectoryScanner();
+
+      /** \brief Starts the scan.
+       *
+       */
+      void start();
+
+      /** \brief Waits for the next file found and returns true, or returns false if the scan has
+       * finished or has been aborted and there are no more files.
+       * \param[out] entry File information.
+       *
+       */
+      bool next(Entry &entry);
+
+      /** \brief Stops the scan and wakes up the consumer.
+       *
+       */
+      void abort();
+
+      /** \brief Returns true if the walk has finished.
+       *
+       */
+      bool isFinished() const
+      { return m_finished; }
+
+      /** \brief Returns the number of files found so far.
+       *
+       */
+      unsigned long long filesCount() const
+      { return m_files; }
+
+      /** \brief Returns the keys of the directories found, including the scanned one. Complete
+       * only when the walk has finished.
+       *
+       */
+      std::vector<std::string> directories() const;
+
+    private:
+      /** \brief Walks directories until there are no more to walk.
+       *
+       */
+      void scan();
+
+      using Directory = std::pair<QString, std::string>;
+
+      const QString                      m_path;        /** scanned directory path.                         */
+      const unsigned int                 m_threadsNum;  /** number of walking threads.                      */
+      std::vector<std::thread>           m_threads;     /** walking threads.                                */
+      mutable std::mutex                 m_mutex;       /** protects the queues.                            */
+      std::condition_variable            m_walkCV;      /** signals directories to walk or free space.      */
+      std::condition_variable            m_entriesCV;   /** signals files found or end of the walk.         */
+      std::deque<Directory>              m_pending;     /** directories pending to walk, path and key.      */
+      std::deque<Entry>                  m_entries;     /** files found not yet consumed.                   */
+      std::vector<std::string>           m_directories; /** keys of the directories found.                  */
+      unsigned int                       m_busy;        /** threads walking a directory.                    */
+      std::atomic<unsigned long long>    m_files;       /** number of files found.                          */
+      std::atomic<bool>                  m_finished;    /** true when the walk has finished.                */
+      std::atomic<bool>                  m_abort;       /** true to stop the walk.                          */
+  };
+
+  /** \class CancellationToken
+   * \brief Cancellation flag shared by an operation and its requests. Cancelling it wakes up the
+   * waiting threads and runs the registered callbacks, so in-flight requests can be cancelled
+   * immediately instead of waiting for the next check.
+   *
+   */
+  class CancellationToken
+  {
+    public:
+      using Callback = std::function<void()>;
+
+      /** \brief CancellationToken class constructor.
+       *
+       */
+      CancellationToken();
+
+      /** \brief Cancels the token and runs the callbacks. Only the first call has effect.
+       *
+       */
+      void cancel();
+
+      /** \brief Returns true if the token has been cancelled.
+       *
+       */
+      bool isCancelled() const
+      { return m_cancelled; }
+
+      /** \brief Waits the given time or until the token is cancelled. Returns true if cancelled.
+       * \param[in] time Time to wait.
+       *
+       */
+      bool waitFor(const std::chrono::milliseconds &time);
+
+      /** \brief Registers a callback to run when the token is cancelled and returns its identifier.
+       * If the token is already cancelled the callback runs immediately.
+       * \param[in] callback Function to call, must not block.
+       *
+       */
+      unsigned long long subscribe(Callback callback);
+
+      /** \brief Removes the given callback. When it returns the callback is not running and will
+       * not be called.
+       * \param[in] id Callback identifier.
+       *
+       */
+      void unsubscribe(const unsigned long long id);
+
+    private:
+      std::atomic<bool>                      m_cancelled; /** true if cancelled.                           */
+      std::mutex                             m_mutex;     /** protects the callbacks.                      */
+      std::condition_variable                m_condition; /** wakes up the waiting threads when cancelled. */
+      std::map<unsigned long long, Callback> m_callbacks; /** registered callbacks.                        */
+      unsigned long long                     m_nextId;    /** identifier of the next callback.             */
+  };
+
+  /** \class CancellationScope
+   * \brief Keeps a callback registered in a cancellation token during its lifetime.
+   *
+   */
+  class CancellationScope
+  {
+    public:
+      /** \brief CancellationScope class constructor.
+       * \param[in] token Cancellation token.
+       * \param[in] callback Function to call when the token is cancelled.
+       *
+       */
+      explicit CancellationScope(CancellationToken &token, CancellationToken::Callback callback)
+      : m_token(token)
+      , m_id   {token.subscribe(callback)}
+      {}
+
+      /** \brief CancellationScope class destructor. Unregisters the callback.
+       *
+       */
+      ~CancellationScope()
+      { m_token.unsubscribe(m_id); }
+
+      CancellationScope(const CancellationScope &) = delete;
+      CancellationScope &operator=(const CancellationScope &) = delete;
+
+    private:
+      CancellationToken       &m_token; /** cancellation token.  */
+      const unsigned long long m_id;    /** callback identifier. */
+  };
+
+  /** \class BufferPool
+   * \brief Memory budget shared by all the operations. Hands out reusable aligned buffers and
+   * reserves memory for the part buffers of the transfer managers. Requests that don't fit in the
+   * budget wait until other transfers release their memory.
+   *
+   */
+  class BufferPool
+  {
+    private:
+      /** \struct Block
+       * \brief Aligned memory block.
+       *
+       */
+      struct Block
+      {
+        char        *raw;  /** allocated memory.        */
+        char        *data; /** aligned start of memory. */
+        std::size_t  size; /** usable size in bytes.    */
+      };
+
+    public:
+      /** \class Buffer
+       * \brief Buffer of the pool, returned to the pool when destroyed.
+       *
+       */
+      class Buffer
+      {
+        public:
+          /** \brief Buffer class constructor. Creates an empty buffer.
+           *
+           */
+          Buffer();
+
+          /** \brief Buffer move constructor.
+           * \param[in] other Buffer to move.
+           *
+           */
+          Buffer(Buffer &&other);
+
+          /** \brief Buffer move assignment.
+           * \param[in] other Buffer to move.
+           *
+           */
+          Buffer &operator=(Buffer &&other);
+
+          /** \brief Buffer class destructor. Returns the memory to the pool.
+           *
+           */
+          ~Buffer()
+          { reset(); }
+
+          Buffer(const Buffer &) = delete;
+          Buffer &operator=(const Buffer &) = delete;
+
+          /** \brief Returns the aligned data pointer, nullptr if empty.
+           *
+           */
+          char *data() const
+          { return m_block.data; }
+
+          /** \brief Returns the size of the buffer in bytes.
+           *
+           */
+          std::size_t size() const
+          { return m_block.size; }
+
+          /** \brief Returns the memory to the pool and empties the buffer.
+           *
+           */
+          void reset();
+
+        private:
+          friend class BufferPool;
+
+          BufferPool *m_pool;  /** owner pool.    */
+          Block       m_block; /** memory block.  */
+      };
+
+      /** \class Reservation
+       * \brief Memory reserved from the pool budget, released when destroyed.
+       *
+       */
+      class Reservation
+      {
+        public:
+          /** \brief Reservation class constructor.
+           * \param[in] pool Owner pool.
+           * \param[in] bytes Reserved bytes.
+           *
+           */
+          explicit Reservation(BufferPool *pool, const unsigned long long bytes)
+          : m_pool {pool}
+          , m_bytes{bytes}
+          {}
+
+          /** \brief Reservation class destructor. Releases the reserved memory.
+           *
+           */
+          ~Reservation()
+          { if(m_bytes > 0) m_pool->release(m_bytes); }
+
+          Reservation(const Reservation &) = delete;
+          Reservation &operator=(const Reservation &) = delete;
+
+          /** \brief Returns the reserved bytes, 0 if the reservation was cancelled.
+           *
+           */
+          unsigned long long bytes() const
+          { return m_bytes; }
+
+        private:
+          BufferPool              *m_pool;  /** owner pool.      */
+          const unsigned long long m_bytes; /** reserved bytes.  */
+      };
+
+      /** \brief BufferPool class constructor.
+       * \param[in] budget Memory budget in bytes.
+       *
+       */
+      explicit BufferPool(const unsigned long long budget);
+
+      /** \brief BufferPool class destructor.
+       *
+       */
+      ~BufferPool();
+
+      /** \brief Sets the memory budget. Lowering it doesn't free the memory in use, new requests
+       * wait until it's released.
+       * \param[in] budget Memory budget in bytes.
+       *
+       */
+      void setBudget(const unsigned long long budget);
+
+      /** \brief Returns the memory budget in bytes.
+       *
+       */
+      unsigned long long budget() const;
+
+      /** \brief Returns a buffer of the given size, waiting until it fits in the budget.
+       * \param[in] size Size in bytes.
+       *
+       */
+      Buffer acquire(const std::size_t size);
+
+      /** \brief Reserves between the given minimum and maximum bytes of the budget, waiting until
+       * the minimum is available or the token is cancelled.
+       * \param[in] minimum Minimum bytes to reserve.
+       * \param[in] maximum Maximum bytes to reserve.
+       * \param[in] token Cancellation token of the caller.
+       *
+       */
+      std::unique_ptr<Reservation> reserve(const unsigned long long minimum, const unsigned long long maximum, CancellationToken &token);
+
+    private:
+      /** \brief Returns the given block to the free blocks.
+       * \param[in] block Memory block.
+       *
+       */
+      void giveBack(const Block &block);
+
+      /** \brief Releases the given reserved bytes.
+       * \param[in] bytes Number of bytes.
+       *
+       */
+      void release(const unsigned long long bytes);
+
+      /** \brief Frees cached blocks until the given bytes fit in the budget. Must be called with the lock held.
+       * \param[in] bytes Number of bytes.
+       *
+       */
+      void evict(const unsigned long long bytes);
+
+      /** \brief Returns true if the given bytes fit in the budget now. Must be called with the lock held.
+       * \param[in] bytes Number of bytes.
+       *
+       */
+      bool fits(const unsigned long long bytes) const;
+
+      mutable std::mutex                m_mutex;     /** protects the pool.                         */
+      std::condition_variable           m_available; /** signals memory released or budget changed. */
+      unsigned long long                m_budget;    /** memory budget in bytes.                    */
+      unsigned long long                m_used;      /** bytes in use by buffers and reservations.  */
+      unsigned long long                m_reserved;  /** bytes in use by reservations.              */
+      unsigned long long                m_cached;    /** bytes of the free blocks kept for reuse.   */
+      std::multimap<std::size_t, Block> m_free;      /** free blocks by size.                       */
+  };
+
+  /** \brief Returns the buffer pool shared by all the operations.
+   *
+   */
+  std::shared_ptr<BufferPool> bufferPool();
+
+  /** \class TransferProgress
+   * \brief Progress counters of a single transfer. Passed as the context of the transfer so the
+   * transfer manager callbacks can update it without locks or lookups.
+   *
+   */
+  class TransferProgress
+  : public Aws::Client::AsyncCallerContext
+  {
+    public:
+      /** \brief TransferProgress class constructor.
+       * \param[in] name Name of the transferred object.
+       * \param[in] size Size of the object in bytes.
+       *
+       */
+      explicit TransferProgress(const QString &name, const unsigned long long size);
+
+      /** \brief TransferProgress class virtual destructor.
+       *
+       */
+      virtual ~TransferProgress()
+      {};
+
+      /** \brief Updates the counters. Can be called from any thread.
+       * \param[in] transferred Bytes transferred.
+       * \param[in] total Total bytes of the transfer.
+       *
+       */
+      void update(const unsigned long long transferred, const unsigned long long total) const
+      {
+        m_transferred.store(transferred, std::memory_order_relaxed);
+        m_total.store(total, std::memory_order_relaxed);
+      }
+
+      /** \brief Returns the name of the transferred object.
+       *
+       */
+      const QString &name() const
+      { return m_name; }
+
+      /** \brief Returns the size of the object in bytes.
+       *
+       */
+      unsigned long long size() const
+      { return m_size; }
+
+      /** \brief Returns the bytes transferred.
+       *
+       */
+      unsigned long long transferred() const
+      { return m_transferred.load(std::memory_order_relaxed); }
+
+      /** \brief Returns the total bytes of the transfer, 0 if still unknown.
+       *
+       */
+      unsigned long long total() const
+      { return m_total.load(std::memory_order_relaxed); }
+
+    private:
+      const QString                           m_name;        /** name of the object.   */
+      const unsigned long long                m_size;        /** size of the object.   */
+      mutable std::atomic<unsigned long long> m_transferred; /** bytes transferred.    */
+      mutable std::atomic<unsigned long long> m_total;       /** total bytes.          */
+  };
+
+  /** \struct ProgressSample
+   * \brief Aggregated progress of an operation at a given moment.
+   *
+   */
+  struct ProgressSample
+  {
+    unsigned long long                   bytes            = 0;  /** bytes transferred.                                  */
+    unsigned long long                   totalBytes       = 0;  /** bytes of the operation, can grow while scanning.    */
+    unsigned long long                   objects          = 0;  /** objects finished.                                   */
+    unsigned long long                   totalObjects     = 0;  /** objects of the operation, can grow while scanning.  */
+    double                               bytesPerSecond   = 0;  /** transfer rate in bytes per second.                  */
+    double                               objectsPerSecond = 0;  /** objects finished per second.                        */
+    long long                            eta              = -1; /** estimated seconds to finish, -1 if unknown.         */
+    std::vector<std::pair<QString, int>> transfers;             /** name and progress in [0,100] of the transfers.      */
+  };
+
+  /** \class ProgressTracker
+   * \brief Aggregates the progress of the transfers of an operation. Transfers update their own
+   * counters and a low frequency sampler computes the totals, rates and estimated time.
+   *
+   */
+  class ProgressTracker
+  {
+    public:
+      /** \brief ProgressTracker class constructor.
+       *
+       */
+      ProgressTracker();
+
+      /** \brief Adds the given objects and bytes to the totals of the operation.
+       * \param[in] objects Number of objects.
+       * \param[in] bytes Number of bytes.
+       *
+       */
+      void addTotal(const unsigned long long objects, const unsigned long long bytes);
+
+      /** \brief Registers a transfer and returns its progress counters.
+       * \param[in] name Name of the transferred object.
+       * \param[in] size Size of the object in bytes.
+       *
+       */
+      std::shared_ptr<TransferProgress> start(const QString &name, const unsigned long long size);
+
+      /** \brief Finishes the given transfer, successful or not.
+       * \param[in] transfer Transfer progress counters.
+       *
+       */
+      void finish(std::shared_ptr<TransferProgress> transfer);
+
+      /** \brief Finishes an object processed without a transfer (skipped, failed or deleted).
+       * \param[in] size Size of the object in bytes.
+       *
+       */
+      void finish(const unsigned long long size);
+
+      /** \brief Computes the progress since the last sample. Must be called always from the same thread.
+       *
+       */
+      ProgressSample sample();
+
+    private:
+      using Clock = std::chrono::steady_clock;
+
+      std::mutex                                     m_mutex;        /** protects the transfers list.               */
+      std::vector<std::shared_ptr<TransferProgress>> m_transfers;    /** transfers in progress.                     */
+      std::atomic<unsigned long long>                m_bytes;        /** bytes of the finished objects.             */
+      std::atomic<unsigned long long>                m_objects;      /** finished objects.                          */
+      std::atomic<unsigned long long>                m_totalBytes;   /** bytes of the operation.                    */
+      std::atomic<unsigned long long>                m_totalObjects; /** objects of the operation.                  */
+      Clock::time_point                              m_lastTime;     /** time of the last sample.                   */
+      unsigned long long                             m_lastBytes;    /** bytes transferred in the last sample.      */
+      unsigned long long                             m_lastObjects;  /** objects finished in the last sample.       */
+      double                                         m_bytesRate;    /** smoothed bytes per second.                 */
+      double                                         m_objectsRate;  /** smoothed objects per second.               */
+  };
+};
+
+#endif // TRANSFERUTILS_H_
@@ -40,6 +40,19 @@ const QString DOWNLOAD_PATHS = "Download with full paths";
 const QString DATABASE_FILE  = "Database file";
 const QString DISABLE_DELETE = "Disable delete actions";
 const QString DOWNLOAD_PATH  = "Download path";
+const QString UPLOAD_LIMIT   = "Upload limit";
+const QString DOWNLOAD_LIMIT = "Download limit";
+const QString SCHEDULE       = "Scheduled limits";
+const QString SCHEDULE_START = "Scheduled limits start";
+const QString SCHEDULE_END   = "Scheduled limits end";
+const QString SCHEDULE_UP    = "Scheduled upload limit";
+const QString SCHEDULE_DOWN  = "Scheduled download limit";
+const QString MAX_OPERATIONS = "Concurrent operations";
+const QString MEMORY         = "Transfer memory";
+const QString SYNC_TRANSFERS = "Sync transfers";
+const QString SYNC_VERIFY    = "Sync verify ETag";
+const QString CHECKSUMS      = "Verify integrity";
+const QString CACHE_SIZE     = "Download cache";
 
 //-----------------------------------------------------------------------------
 QString Utils::dataPath()
@@ -110,15 +123,28 @@ void Utils::Configuration::load()
 {
   QSettings settings(Utils::dataPath() + SEPARATOR + "SuperDuck.ini", QSettings::IniFormat);
 
-  AWS_Access_key_id     = settings.value(AWS_KEY_ID,     QString()).toString();
-  AWS_Secret_access_key = settings.value(AWS_SECRET_KEY, QString()).toString();
-  AWS_Bucket            = settings.value(AWS_BUCKET,     QString()).toString();
-  AWS_Region            = settings.value(AWS_REGION,     QString()).toString();
-  Database_file         = settings.value(DATABASE_FILE,  Utils::databaseFile()).toString();
-  Download_Full_Paths   = settings.value(DOWNLOAD_PATHS, false).toBool();
-  Export_Full_Paths     = settings.value(EXPORT_PATHS,   true).toBool();
-  DisableDelete         = settings.value(DISABLE_DELETE, true).toBool();
-  DownloadPath          = settings.value(DOWNLOAD_PATH,  QStandardPaths::writableLocation(QStandardPaths::DownloadLocation)).toString();
+  AWS_Access_key_id       = settings.value(AWS_KEY_ID,     QString()).toString();
+  AWS_Secret_access_key   = settings.value(AWS_SECRET_KEY, QString()).toString();
+  AWS_Bucket              = settings.value(AWS_BUCKET,     QString()).toString();
+  AWS_Region              = settings.value(AWS_REGION,     QString()).toString();
+  Database_file           = settings.value(DATABASE_FILE,  Utils::databaseFile()).toString();
+  Download_Full_Paths     = settings.value(DOWNLOAD_PATHS, false).toBool();
+  Export_Full_Paths       = settings.value(EXPORT_PATHS,   true).toBool();
+  DisableDelete           = settings.value(DISABLE_DELETE, true).toBool();
+  DownloadPath            = settings.value(DOWNLOAD_PATH,  QStandardPaths::writableLocation(QStandardPaths::DownloadLocation)).toString();
+  Upload_Limit            = settings.value(UPLOAD_LIMIT,   0).toUInt();
+  Download_Limit          = settings.value(DOWNLOAD_LIMIT, 0).toUInt();
+  Schedule_Limits         = settings.value(SCHEDULE,       false).toBool();
+  Schedule_Start          = settings.value(SCHEDULE_START, QTime(22,0)).toTime();
+  Schedule_End            = settings.value(SCHEDULE_END,   QTime(7,0)).toTime();
+  Schedule_Upload_Limit   = settings.value(SCHEDULE_UP,    0).toUInt();
+  Schedule_Download_Limit = settings.value(SCHEDULE_DOWN,  0).toUInt();
+  Max_Operations          = settings.value(MAX_OPERATIONS, 2).toUInt();
+  Transfer_Memory         = settings.value(MEMORY,         512).toUInt();
+  Sync_Transfers          = settings.value(SYNC_TRANSFERS, false).toBool();
+  Sync_Verify             = settings.value(SYNC_VERIFY,    false).toBool();
+  Verify_Checksums        = settings.value(CHECKSUMS,      true).toBool();
+  Cache_Size              = settings.value(CACHE_SIZE,     2048).toUInt();
 }
 
 //-----------------------------------------------------------------------------
@@ -135,6 +161,42 @@ void Utils::Configuration::save()
   settings.setValue(EXPORT_PATHS,   Export_Full_Paths);
   settings.setValue(DISABLE_DELETE, DisableDelete);
   settings.setValue(DOWNLOAD_PATH,  DownloadPath);
+  settings.setValue(UPLOAD_LIMIT,   Upload_Limit);
+  settings.setValue(DOWNLOAD_LIMIT, Download_Limit);
+  settings.setValue(SCHEDULE,       Schedule_Limits);
+  settings.setValue(SCHEDULE_START, Schedule_Start);
+  settings.setValue(SCHEDULE_END,   Schedule_End);
+  settings.setValue(SCHEDULE_UP,    Schedule_Upload_Limit);
+  settings.setValue(SCHEDULE_DOWN,  Schedule_Download_Limit);
+  settings.setValue(MAX_OPERATIONS, Max_Operations);
+  settings.setValue(MEMORY,         Transfer_Memory);
+  settings.setValue(SYNC_TRANSFERS, Sync_Transfers);
+  settings.setValue(SYNC_VERIFY,    Sync_Verify);
+  settings.setValue(CHECKSUMS,      Verify_Checksums);
+  settings.setValue(CACHE_SIZE,     Cache_Size);
+}
+
+//-----------------------------------------------------------------------------
+bool Utils::Configuration::isScheduled(const QTime& time) const
+{
+  if(!Schedule_Limits || Schedule_Start == Schedule_End) return false;
+
+  // the interval can wrap around midnight.
+  if(Schedule_Start < Schedule_End) return (Schedule_Start <= time) && (time < Schedule_End);
+
+  return (Schedule_Start <= time) || (time < Schedule_End);
+}
+
+//-----------------------------------------------------------------------------
+unsigned int Utils::Configuration::uploadLimit(const QTime& time) const
+{
+  return isScheduled(time) ? Schedule_Upload_Limit : Upload_Limit;
+}
+
+//-----------------------------------------------------------------------------
+unsigned int Utils::Configuration::downloadLimit(const QTime& time) const
+{
+  return isScheduled(time) ? Schedule_Download_Limit : Download_Limit;
 }
 
 //-----------------------------------------------------------------------------
@@ -142,11 +204,13 @@ std::map<std::string, unsigned long long> Utils::processItems(const Items items)
 {
   std::map<std::string, unsigned long long> result;
 
-  auto processSelection = [&result](const Item *i)
+  std::string fullName;
+  auto processSelection = [&result, &fullName](const Item *i)
   {
-    QString fullName = i->fullName() + (isDirectory(i) ? AWSUtils::DELIMITER:"");
+    i->fullName(fullName);
+    if(isDirectory(i)) fullName += AWSUtils::DELIMITER.toStdString();
 
-    result.emplace(fullName.toStdString(), i->size());
+    result.emplace(fullName, i->size());
   };
   std::for_each(items.cbegin(), items.cend(), processSelection);
 
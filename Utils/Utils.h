@@ -25,6 +25,7 @@
 
 // Qt
 #include <QString>
+#include <QTime>
 
 // C++
 #include <map>
@@ -67,21 +68,52 @@ namespace Utils
    */
   struct Configuration
   {
-    QString AWS_Access_key_id;     /** AWS key id.                                                   */
-    QString AWS_Secret_access_key; /** AWS secret key.                                               */
-    QString AWS_Bucket;            /** AWS bucket.                                                   */
-    QString AWS_Region;            /** AWS region of the bucket.                                     */
-    QString Database_file;         /** database file location on disk.                               */
-    bool    Export_Full_Paths;     /** true to export files with full path, false otherwise.         */
-    bool    Download_Full_Paths;   /** true to create paths when downloading files, false otherwise. */
-    bool    DisableDelete;         /** true to disable delete objects actions, false otherwise.      */
-    QString DownloadPath;          /** Path in which to save the files and folders.                  */
+    QString      AWS_Access_key_id;       /** AWS key id.                                                   */
+    QString      AWS_Secret_access_key;   /** AWS secret key.                                               */
+    QString      AWS_Bucket;              /** AWS bucket.                                                   */
+    QString      AWS_Region;              /** AWS region of the bucket.                                     */
+    QString      Database_file;           /** database file location on disk.                               */
+    bool         Export_Full_Paths;       /** true to export files with full path, false otherwise.         */
+    bool         Download_Full_Paths;     /** true to create paths when downloading files, false otherwise. */
+    bool         DisableDelete;           /** true to disable delete objects actions, false otherwise.      */
+    QString      DownloadPath;            /** Path in which to save the files and folders.                  */
+    unsigned int Upload_Limit;            /** upload bandwidth limit in KB/s, 0 for unlimited.              */
+    unsigned int Download_Limit;          /** download bandwidth limit in KB/s, 0 for unlimited.            */
+    bool         Schedule_Limits;         /** true to use the scheduled limits in the schedule interval.    */
+    QTime        Schedule_Start;          /** start time of the scheduled limits interval.                  */
+    QTime        Schedule_End;            /** end time of the scheduled limits interval.                    */
+    unsigned int Schedule_Upload_Limit;   /** scheduled upload limit in KB/s, 0 for unlimited.              */
+    unsigned int Schedule_Download_Limit; /** scheduled download limit in KB/s, 0 for unlimited.            */
+    unsigned int Max_Operations;          /** maximum number of operations running at the same time.        */
+    unsigned int Transfer_Memory;         /** memory in MB for the transfer buffers of all the operations.  */
+    bool         Sync_Transfers;          /** true to transfer only the objects that differ.                */
+    bool         Sync_Verify;             /** true to confirm unchanged objects with the ETag.              */
+    bool         Verify_Checksums;        /** true to verify the checksums of the transferred data.         */
+    unsigned int Cache_Size;              /** size in MB of the downloaded objects cache, 0 to disable it.  */
 
     /** \brief Returns true if its a valid configuration.
      *
      */
     bool isValid() const;
 
+    /** \brief Returns the upload limit in KB/s at the given time, 0 for unlimited.
+     * \param[in] time Time of the day.
+     *
+     */
+    unsigned int uploadLimit(const QTime &time) const;
+
+    /** \brief Returns the download limit in KB/s at the given time, 0 for unlimited.
+     * \param[in] time Time of the day.
+     *
+     */
+    unsigned int downloadLimit(const QTime &time) const;
+
+    /** \brief Returns true if the given time is inside the scheduled limits interval.
+     * \param[in] time Time of the day.
+     *
+     */
+    bool isScheduled(const QTime &time) const;
+
     /** \brief Loads the configuration from the ini settings file.
      *
      */
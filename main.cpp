@@ -35,6 +35,9 @@
 #include <QFile>
 #include <QDir>
 
+// AWS
+#include <aws/core/Aws.h>
+
 // C++
 #include <iostream>
 #include <unistd.h>
@@ -300,13 +303,24 @@ int main(int argc, char **argv)
     return 0;
   }
 
-  MainWindow application(configuration, &factory);
+  // the SDK is initialized once for all the operations, that can run concurrently.
+  Aws::SDKOptions options;
+  Aws::InitAPI(options);
+
+  int result = 0;
+  {
+    MainWindow application(configuration, &factory);
 
-  splash.hide();
+    splash.hide();
 
-  application.show();
+    application.show();
+
+    result = app.exec();
+
+    // the window destroys the operations queue, that waits for all the operations to finish.
+  }
 
-  auto result = app.exec();
+  Aws::ShutdownAPI(options);
 
   configuration.save();
 